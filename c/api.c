@@ -298,13 +298,18 @@ void removeEdge(Graph *G, u32 x, u32 y) {
   }
   G->_edges = temp;
 
+  bool wasMaximal;
   if (isDirected) {
+    wasMaximal = (G->_outdegrees)[x] == G->Δ;
     (G->_outdegrees)[x]--;
     (G->_indegrees)[y]--;
   } else {
+    wasMaximal = (G->_degrees)[x] == G->Δ || (G->_degrees)[y] == G->Δ;
     (G->_degrees)[x]--;
     (G->_degrees)[y]--;
   }
+  if (wasMaximal)
+    recomputeΔ(G);
 
   if ((G->_edges) == NULL) {
     printf("Error: Realloc failed\n");
@@ -313,6 +318,162 @@ void removeEdge(Graph *G, u32 x, u32 y) {
   formatEdges(G);
 }
 
+/**
+ * @brief Recompute Δ(G) from the degree arrays.
+ *
+ * Needed whenever edges are removed, since the degree of the vertex
+ * attaining Δ may have decreased.
+ */
+void recomputeΔ(Graph *G) {
+  u32 *degrees = (G->_g_flag & D_FLAG) ? G->_outdegrees : G->_degrees;
+  G->Δ = 0;
+  for (u32 i = 0; i < G->n; i++) {
+    G->Δ = max(G->Δ, degrees[i]);
+  }
+}
+
+/**
+ * @brief Helper function. Copies the pointed-to value into freshly
+ * allocated memory, so that the graph owns it.
+ */
+static u32 *ownedCopy(u32 *value) {
+  if (value == NULL)
+    return NULL;
+  u32 *copy = (u32 *)malloc(sizeof(u32));
+  if (copy == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  *copy = *value;
+  return copy;
+}
+
+/**
+ * @brief Insert and delete many edges at once.
+ *
+ * Unlike repeated calls to `addEdge` and `removeEdge`, each of which re-sorts
+ * the whole edge array, this function sorts only the batch and then merges it
+ * into the (already sorted) edge array in a single pass. The cost is
+ * O(m + b log b) for a batch of b edges.
+ *
+ * For undirected graphs an edge {x, y} may be given in either orientation,
+ * and both of its Edge structs are inserted or deleted. The `w` and `c`
+ * fields of inserted edges are copied, so the caller keeps ownership of
+ * the pointed-to values; the weight and capacity of deleted edges are freed.
+ * Deletions are applied before insertions, and every deleted edge must exist
+ * in the graph.
+ *
+ * Degrees, `_firstneighbour` and Δ(G) are updated accordingly.
+ *
+ * @param G A formatted graph.
+ * @param inserts Edges to insert (may be NULL if `ninserts` is 0).
+ * @param ninserts Number of edges to insert.
+ * @param deletes Edges to delete; only their `x`, `y` fields are read.
+ * @param ndeletes Number of edges to delete.
+ */
+void applyEdgeBatch(Graph *G, Edge *inserts, u32 ninserts, Edge *deletes,
+                    u32 ndeletes) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  assert(ndeletes <= G->m);
+
+  bool isDirected = (G->_g_flag & D_FLAG);
+  u32 copies = isDirected ? 1 : 2;
+
+  // Expand the batch into Edge structs, one per stored orientation.
+  u32 nIns = copies * ninserts;
+  u32 nDel = copies * ndeletes;
+  Edge *ins = (Edge *)calloc(nIns, sizeof(Edge));
+  Edge *del = (Edge *)calloc(nDel, sizeof(Edge));
+  if ((nIns > 0 && ins == NULL) || (nDel > 0 && del == NULL)) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  for (u32 i = 0; i < ninserts; i++) {
+    Edge e = inserts[i];
+    assert(e.x != e.y && e.x < G->n && e.y < G->n);
+    if (e.w != NULL)
+      assert(G->_g_flag & W_FLAG);
+    if (e.c != NULL)
+      assert(G->_g_flag & CAP_FLAG);
+    ins[copies * i] = (Edge){e.x, e.y, ownedCopy(e.w), ownedCopy(e.c)};
+    if (!isDirected)
+      ins[2 * i + 1] = (Edge){e.y, e.x, ownedCopy(e.w), ownedCopy(e.c)};
+  }
+  for (u32 i = 0; i < ndeletes; i++) {
+    Edge e = deletes[i];
+    del[copies * i] = (Edge){e.x, e.y, NULL, NULL};
+    if (!isDirected)
+      del[2 * i + 1] = (Edge){e.y, e.x, NULL, NULL};
+  }
+  qsort(ins, nIns, sizeof(Edge), compareEdges);
+  qsort(del, nDel, sizeof(Edge), compareEdges);
+
+  u32 oldSize = G->_edgeArraySize;
+  u32 newSize = oldSize - nDel + nIns;
+  Edge *merged = (Edge *)malloc(newSize * sizeof(Edge));
+  if (newSize > 0 && merged == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+
+  // Single merge pass over the old edges, the sorted deletions and the
+  // sorted insertions. Since everything is ordered by (x, y), the pass
+  // could equally be split into independent vertex ranges.
+  u32 i = 0, j = 0, k = 0, out = 0;
+  while (i < oldSize) {
+    Edge e = (G->_edges)[i];
+    // A deletion smaller than the current edge was never matched.
+    assert(k == nDel || compareEdges(&del[k], &e) >= 0);
+    if (k < nDel && compareEdges(&del[k], &e) == 0) {
+      free(e.w);
+      free(e.c);
+      if (isDirected) {
+        (G->_outdegrees)[e.x]--;
+        (G->_indegrees)[e.y]--;
+      } else {
+        (G->_degrees)[e.x]--;
+      }
+      k++;
+      i++;
+      continue;
+    }
+    while (j < nIns && compareEdges(&ins[j], &e) < 0) {
+      merged[out++] = ins[j++];
+    }
+    merged[out++] = e;
+    i++;
+  }
+  assert(k == nDel);
+  while (j < nIns) {
+    merged[out++] = ins[j++];
+  }
+  assert(out == newSize);
+
+  for (u32 l = 0; l < nIns; l++) {
+    if (isDirected) {
+      (G->_outdegrees)[ins[l].x]++;
+      (G->_indegrees)[ins[l].y]++;
+    } else {
+      (G->_degrees)[ins[l].x]++;
+    }
+  }
+
+  free(G->_edges);
+  free(ins);
+  free(del);
+  G->_edges = merged;
+  G->_edgeArraySize = newSize;
+  G->m = G->m - ndeletes + ninserts;
+
+  recomputeΔ(G);
+  u32 *degrees = isDirected ? G->_outdegrees : G->_degrees;
+  for (u32 v = 1; v < G->n; v++) {
+    (G->_firstneighbour)[v] = (G->_firstneighbour)[v - 1] + degrees[v - 1];
+  }
+  G->_formatted = true;
+}
+
 /**
  * @brief Helper function. Reads a file until a new line character is found.
  *
@@ -663,6 +824,20 @@ void writeGraph(Graph *G, char *fname) {
 
 // ~~~~~~~~~~~~~~~~~~~ Network flow API ~~~~~~~~~~~~~~~~~~~~~
 
+/**
+ * @brief Return the largest edge weight of a weighted graph, or 0 if it has
+ * no edges.
+ */
+u32 maxEdgeWeight(Graph *G) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  u32 maxWeight = 0;
+  for (u32 i = 0; i < G->_edgeArraySize; i++) {
+    maxWeight = max(maxWeight, *(G->_edges)[i].w);
+  }
+  return maxWeight;
+}
+
 u32 getEdgeWeight(u32 x, u32 y, Graph *G) {
   assert(G != NULL);
   assert(G->_g_flag & W_FLAG);
@@ -40,6 +40,9 @@ u32 max(u32 x, u32 y);
 u32 min(u32 x, u32 y);
 void removeEdge(Graph *G, u32 x, u32 y);
 void addEdge(Graph *G, u32 x, u32 y, u32 *w, u32 *c);
+void applyEdgeBatch(Graph *G, Edge *inserts, u32 ninserts, Edge *deletes,
+                    u32 ndeletes);
+void recomputeΔ(Graph *G);
 bool isNeighbour(u32 x, u32 y, Graph *G);
 Graph *readGraph(char *filename);
 Graph *initGraph(u32 n, u32 m, g_flag flags);
@@ -77,6 +80,16 @@ u32 firstNeighbourIndex(Graph *G, u32 x);
  */
 u32 getEdgeWeight(u32 x, u32 y, Graph *G);
 
+/**
+ * @brief Retrieves the largest edge weight of a graph.
+ *
+ * @param G Pointer to the Graph structure.
+ * @return The maximum weight over all edges, or 0 if there are no edges.
+ *
+ * @pre Graph must have the W_FLAG enabled for weighted edges.
+ */
+u32 maxEdgeWeight(Graph *G);
+
 /**
  * @brief Retrieves the capacity of an edge between two nodes in a graph.
  *
@@ -0,0 +1,254 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file apsp.c
+ * @brief Batched single-source shortest paths and all-pairs shortest paths.
+ *
+ * Distance matrices are row-major u32 arrays, with INT_MAX for unreachable
+ * pairs. Since every weight is non-negative, Johnson's reweighting is not
+ * needed and the sparse all-pairs mode is plain Dijkstra from each vertex.
+ */
+
+#include "apsp.h"
+#include "api.h"
+#include "dijkstra.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Batched Dijkstra ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef struct {
+  Graph *G;
+  u32 *sources;
+  u32 k;
+  u32 *out;
+  u32 cursor; // next source to claim
+  SearchWorkspace **workspaces;
+} BatchContext;
+
+/**
+ * @brief Task. Claims sources one at a time and writes their distance rows.
+ */
+static void batchTask(u32 thread, u32 nThreads, void *ctx) {
+  (void)nThreads;
+  BatchContext *C = (BatchContext *)ctx;
+  SearchWorkspace *W = C->workspaces[thread];
+  u32 n = numberOfVertices(C->G);
+  while (true) {
+    u32 i = __atomic_fetch_add(&C->cursor, 1, __ATOMIC_RELAXED);
+    if (i >= C->k)
+      break;
+    workspaceDijkstra(C->sources[i], C->G, W);
+    u32 *row = C->out + (u64)i * n;
+    for (u32 v = 0; v < n; v++)
+      row[v] = W->stamp[v] == W->epoch ? W->distances[v] : INT_MAX;
+  }
+}
+
+/**
+ * @brief Computes the distances from each of the k `sources` to every
+ * vertex, running one Dijkstra per source. Sources are shared among the
+ * threads of `pool` (NULL runs on the calling thread), each with its own
+ * SearchWorkspace.
+ *
+ * @param[out] out A k x n row-major matrix: out[i * n + v] is the distance
+ * from sources[i] to v, or INT_MAX.
+ */
+void multiSourceDijkstra(Graph *G, u32 *sources, u32 k, u32 *out,
+                         ThreadPool *pool) {
+  assert(G != NULL && out != NULL);
+  assert(k == 0 || sources != NULL);
+  u32 n = numberOfVertices(G);
+  u32 nThreads = poolSize(pool);
+  BatchContext C = {G, sources, k, out, 0, NULL};
+  C.workspaces = (SearchWorkspace **)malloc(nThreads * sizeof(void *));
+  if (C.workspaces == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  for (u32 t = 0; t < nThreads; t++)
+    C.workspaces[t] = createSearchWorkspace(n);
+
+  if (pool == NULL)
+    batchTask(0, 1, &C);
+  else
+    poolRun(pool, batchTask, &C);
+
+  for (u32 t = 0; t < nThreads; t++)
+    dumpSearchWorkspace(C.workspaces[t]);
+  free(C.workspaces);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Floyd-Warshall ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. Relaxes the tile of rows [i0, i1) and columns
+ * [j0, j1) through the intermediate vertices [k0, k1).
+ *
+ * The inner loop is a branch-free min over contiguous rows, which the
+ * compiler vectorizes. No overflow occurs: entries are at most INT_MAX, so
+ * any sum of two fits in a u32.
+ */
+static void relaxTile(u32 *D, u32 n, u32 i0, u32 i1, u32 j0, u32 j1, u32 k0,
+                      u32 k1) {
+  for (u32 k = k0; k < k1; k++) {
+    const u32 *Dk = D + (u64)k * n;
+    for (u32 i = i0; i < i1; i++) {
+      u32 *Di = D + (u64)i * n;
+      u32 dik = Di[k];
+      if (dik == INT_MAX)
+        continue;
+      for (u32 j = j0; j < j1; j++) {
+        u32 candidate = dik + Dk[j];
+        Di[j] = candidate < Di[j] ? candidate : Di[j];
+      }
+    }
+  }
+}
+
+typedef struct {
+  u32 *D;
+  u32 n;
+  u32 nBlocks;
+  ThreadPool *pool;
+} FloydContext;
+
+/**
+ * @brief Task. Runs the blocked Floyd-Warshall algorithm. For each block
+ * column kb, the diagonal tile is relaxed first, then the tiles of row and
+ * column kb, which only depend on it, and finally all other tiles, which
+ * depend on those; the tiles of each phase are shared among threads.
+ */
+static void floydTask(u32 thread, u32 nThreads, void *ctx) {
+  FloydContext *C = (FloydContext *)ctx;
+  u32 n = C->n, B = C->nBlocks;
+  for (u32 kb = 0; kb < B; kb++) {
+    u32 k0 = kb * FW_BLOCK, k1 = min(k0 + FW_BLOCK, n);
+    if (thread == 0)
+      relaxTile(C->D, n, k0, k1, k0, k1, k0, k1);
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+
+    // Row kb and column kb, tile b of each.
+    for (u32 b = thread; b < B; b += nThreads) {
+      if (b == kb)
+        continue;
+      u32 b0 = b * FW_BLOCK, b1 = min(b0 + FW_BLOCK, n);
+      relaxTile(C->D, n, k0, k1, b0, b1, k0, k1);
+      relaxTile(C->D, n, b0, b1, k0, k1, k0, k1);
+    }
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+
+    for (u32 tile = thread; tile < B * B; tile += nThreads) {
+      u32 ib = tile / B, jb = tile % B;
+      if (ib == kb || jb == kb)
+        continue;
+      u32 i0 = ib * FW_BLOCK, j0 = jb * FW_BLOCK;
+      relaxTile(C->D, n, i0, min(i0 + FW_BLOCK, n), j0, min(j0 + FW_BLOCK, n),
+                k0, k1);
+    }
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+  }
+}
+
+/**
+ * @brief Computes the distance between every pair of vertices with a
+ * cache-blocked Floyd-Warshall algorithm, in O(n^3) time. Tiles of
+ * FW_BLOCK x FW_BLOCK entries stay in cache while they are relaxed.
+ *
+ * @param[out] out An n x n row-major matrix: out[u * n + v] is the distance
+ * from u to v, or INT_MAX.
+ */
+void floydWarshall(Graph *G, u32 *out, ThreadPool *pool) {
+  assert(G != NULL && out != NULL);
+  assert(G->_g_flag & W_FLAG);
+  u32 n = numberOfVertices(G);
+  for (u64 i = 0; i < (u64)n * n; i++)
+    out[i] = INT_MAX;
+  for (u32 v = 0; v < n; v++)
+    out[(u64)v * n + v] = 0;
+  u32 entries = G->_g_flag & D_FLAG ? G->m : 2 * G->m;
+  for (u32 i = 0; i < entries; i++) {
+    Edge e = (G->_edges)[i];
+    u32 *entry = &out[(u64)e.x * n + e.y];
+    if (*e.w < *entry)
+      *entry = *e.w;
+  }
+
+  FloydContext C = {out, n, (n + FW_BLOCK - 1) / FW_BLOCK, pool};
+  if (pool == NULL)
+    floydTask(0, 1, &C);
+  else
+    poolRun(pool, floydTask, &C);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ All pairs ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Whether allPairsShortestPaths runs Floyd-Warshall on `G`, i.e.
+ * whether at least APSP_DENSE_PERCENT percent of the possible arcs exist.
+ */
+bool isDenseForAPSP(Graph *G) {
+  u64 n = numberOfVertices(G);
+  u64 arcs = G->_g_flag & D_FLAG ? G->m : 2 * (u64)G->m;
+  return 100 * arcs >= APSP_DENSE_PERCENT * n * (n - 1);
+}
+
+/**
+ * @brief Computes the distance between every pair of vertices. Dense
+ * graphs (see isDenseForAPSP) go to floydWarshall, whose O(n^3)
+ * vectorized inner loop wins there, and sparse ones to
+ * multiSourceDijkstra from every vertex, in O(n (n + m) log n).
+ *
+ * @return An n x n row-major matrix, to be freed by the caller: entry
+ * u * n + v is the distance from u to v, or INT_MAX.
+ */
+u32 *allPairsShortestPaths(Graph *G, ThreadPool *pool) {
+  assert(G != NULL);
+  u32 n = numberOfVertices(G);
+  u32 *out = (u32 *)malloc(((u64)n * n + 1) * sizeof(u32));
+  if (out == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  if (isDenseForAPSP(G)) {
+    floydWarshall(G, out, pool);
+  } else {
+    u32 *sources = genArray(n);
+    for (u32 v = 0; v < n; v++)
+      sources[v] = v;
+    multiSourceDijkstra(G, sources, n, out, pool);
+    free(sources);
+  }
+  return out;
+}
@@ -0,0 +1,52 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file apsp.h
+ * @brief Distances from many sources at once: batched Dijkstra and
+ * all-pairs shortest paths.
+ */
+
+#ifndef APSP_H
+#define APSP_H
+
+#include "graphStruct.h"
+#include "threadpool.h"
+
+// allPairsShortestPaths runs Floyd-Warshall when at least this percentage
+// of the n(n - 1) possible arcs is present, and Dijkstra from every vertex
+// otherwise.
+#define APSP_DENSE_PERCENT 10
+
+// Side of the square tiles of the blocked Floyd-Warshall.
+#define FW_BLOCK 64
+
+void multiSourceDijkstra(Graph *G, u32 *sources, u32 k, u32 *out,
+                         ThreadPool *pool);
+void floydWarshall(Graph *G, u32 *out, ThreadPool *pool);
+bool isDenseForAPSP(Graph *G);
+u32 *allPairsShortestPaths(Graph *G, ThreadPool *pool);
+
+#endif
@@ -0,0 +1,372 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file astar.c
+ * @brief A* search and the ALT landmark heuristic.
+ *
+ * A* settles vertices in order of g(v) + h(v), where g is the distance from
+ * the source and h a lower bound on the distance to the target, so the
+ * search is pulled towards the target. ALT derives h from precomputed
+ * distances to a few landmarks: by the triangle inequality,
+ * d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L).
+ */
+
+#include "astar.h"
+#include "api.h"
+#include "heap.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Identifies landmark files, followed by the format version.
+#define LANDMARK_MAGIC 0x4D4C4743 // "CGLM"
+#define LANDMARK_VERSION 1
+
+/**
+ * @brief Computes a shortest path from `s` to `t` with A*. The search runs
+ * in the workspace W, so its cost depends on the vertices reached rather
+ * than on n.
+ *
+ * `h(v, t, ctx)` must never overestimate the distance from `v` to `t`.
+ * It need not be consistent: a vertex reached again by a shorter path is
+ * put back in the queue. With a consistent heuristic (such as ALT's) every
+ * vertex is settled at most once, and with h = 0 this is Dijkstra's
+ * algorithm stopped at `t`. The estimate of each reached vertex is kept in
+ * W->frontier, so h is called once per vertex.
+ *
+ * @return The path, to be freed with dumpPath.
+ */
+Path *workspaceAStar(Graph *G, u32 s, u32 t, Heuristic h, void *ctx,
+                     SearchWorkspace *W) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  assert(h != NULL);
+  u32 n = numberOfVertices(G);
+  assert(s < n && t < n);
+  assert(W != NULL && W->n >= n);
+
+  u32 settled = 0;
+  resetWorkspace(W);
+  u32 epoch = W->epoch;
+  u32 *estimates = W->frontier;
+  u32 estimate = h(s, t, ctx);
+  if (estimate != INT_MAX) {
+    W->stamp[s] = epoch;
+    W->distances[s] = 0;
+    W->parents[s] = s;
+    W->parentEdges[s] = NO_PARENT;
+    estimates[s] = estimate;
+    indexedInsert(W->heap, s, estimate);
+  }
+
+  while (W->heap->size > 0) {
+    u32 v = indexedExtractMin(W->heap).label;
+    settled++;
+    if (v == t)
+      break;
+
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 i = first; i < last; i++) {
+      Edge e = (G->_edges)[i];
+      u32 candidate = W->distances[v] + *(e.w);
+      bool reached = W->stamp[e.y] == epoch;
+      if (reached && candidate >= W->distances[e.y])
+        continue;
+      if (!reached) {
+        // Vertices that cannot reach t are never stamped, so their
+        // estimate is asked again when another edge leads to them.
+        estimate = h(e.y, t, ctx);
+        if (estimate == INT_MAX)
+          continue;
+        estimates[e.y] = estimate;
+      }
+      W->distances[e.y] = candidate;
+      W->parents[e.y] = v;
+      W->parentEdges[e.y] = i;
+      u32 key = candidate + estimates[e.y];
+      if (reached && heapContains(W->heap, e.y)) {
+        decreaseKey(W->heap, e.y, key);
+      } else {
+        W->stamp[e.y] = epoch;
+        indexedInsert(W->heap, e.y, key);
+      }
+    }
+  }
+
+  Path *P = W->stamp[t] == epoch ? extractPath(W->parents, W->distances, s, t)
+                                  : emptyPath();
+  P->settled = settled;
+  return P;
+}
+
+/**
+ * @brief Computes a shortest path from `s` to `t` with A*, in a temporary
+ * workspace. See workspaceAStar.
+ *
+ * @return The path, to be freed with dumpPath.
+ */
+Path *aStar(Graph *G, u32 s, u32 t, Heuristic h, void *ctx) {
+  assert(G != NULL);
+  SearchWorkspace *W = createSearchWorkspace(numberOfVertices(G));
+  Path *P = workspaceAStar(G, s, t, h, ctx, W);
+  dumpSearchWorkspace(W);
+  return P;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ ALT ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. Allocates an empty table for k landmarks.
+ */
+static Landmarks *createLandmarks(u32 n, u32 k, bool directed) {
+  Landmarks *L = (Landmarks *)malloc(sizeof(Landmarks));
+  if (L == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  L->n = n;
+  L->k = k;
+  L->directed = directed;
+  // k and n may come from a landmark file, so their product is checked.
+  u64 size = (u64)k * n;
+  if (size > UINT32_MAX) {
+    printf("Error: %u landmarks on %u vertices do not fit in memory\n", k, n);
+    exit(1);
+  }
+  L->vertices = genArray(k);
+  L->from = genArray((u32)size);
+  L->to = directed ? genArray((u32)size) : NULL;
+  return L;
+}
+
+void dumpLandmarks(Landmarks *L) {
+  if (L == NULL)
+    return;
+  free(L->vertices);
+  free(L->from);
+  free(L->to);
+  free(L);
+}
+
+/**
+ * @brief Chooses k landmarks by farthest-point selection and computes the
+ * distances between them and every vertex.
+ *
+ * The first landmark is the vertex farthest from vertex 0, and each next one
+ * is the vertex farthest from all landmarks chosen so far. Vertices
+ * unreachable from every landmark count as farthest, so every component
+ * gets a landmark when k allows it. Landmarks lie on the border of the
+ * graph, behind most targets, which makes their bounds tight.
+ *
+ * Costs k runs of Dijkstra's algorithm, 2k for digraphs, whose distances
+ * to the landmarks follow the in-edges in `R`. If `R` is NULL it is built
+ * when needed.
+ *
+ * @return The landmark table, to be freed with dumpLandmarks. It holds
+ * min(k, n) landmarks.
+ */
+Landmarks *selectLandmarks(Graph *G, u32 k, ReverseIndex *R) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(n > 0);
+  if (k > n)
+    k = n;
+
+  bool directed = G->_g_flag & D_FLAG;
+  ReverseIndex *ownIndex = NULL;
+  if (directed && R == NULL)
+    R = ownIndex = buildReverseIndex(G);
+
+  Landmarks *L = createLandmarks(n, k, directed);
+  // nearest[v] is the distance from the closest landmark so far to v.
+  u32 *nearest = dijkstra(0, G);
+  for (u32 i = 0; i < k; i++) {
+    u32 farthest = 0;
+    for (u32 v = 1; v < n; v++) {
+      if (nearest[v] > nearest[farthest])
+        farthest = v;
+    }
+    L->vertices[i] = farthest;
+
+    u32 *from = dijkstra(farthest, G);
+    memcpy(L->from + (u64)i * n, from, n * sizeof(u32));
+    for (u32 v = 0; v < n; v++) {
+      // Landmarks themselves get 0, even in the first round.
+      if (from[v] < nearest[v] || i == 0)
+        nearest[v] = from[v];
+    }
+    free(from);
+    if (directed) {
+      u32 *to = reverseDijkstra(farthest, G, R);
+      memcpy(L->to + (u64)i * n, to, n * sizeof(u32));
+      free(to);
+    }
+  }
+  free(nearest);
+  dumpReverseIndex(ownIndex);
+  return L;
+}
+
+/**
+ * @brief Helper function. The lower bound a - b on a distance, given the
+ * landmark distances a and b; INT_MAX if it shows the distance is infinite.
+ */
+static u32 differenceBound(u32 a, u32 b) {
+  if (a == INT_MAX)
+    return b == INT_MAX ? 0 : INT_MAX;
+  if (b == INT_MAX || a <= b)
+    return 0;
+  return a - b;
+}
+
+/**
+ * @brief The ALT heuristic, for use as `aStar(G, s, t, altLowerBound, L)`.
+ * Takes the best triangle-inequality bound over all landmarks.
+ */
+u32 altLowerBound(u32 v, u32 t, void *landmarks) {
+  Landmarks *L = (Landmarks *)landmarks;
+  u32 n = L->n;
+  u32 best = 0;
+  for (u32 i = 0; i < L->k; i++) {
+    u32 *from = L->from + (u64)i * n;
+    // d(v, t) >= d(L, t) - d(L, v)
+    u32 bound = differenceBound(from[t], from[v]);
+    if (L->directed) {
+      // d(v, t) >= d(v, L) - d(t, L)
+      u32 *to = L->to + (u64)i * n;
+      u32 other = differenceBound(to[v], to[t]);
+      if (other > bound)
+        bound = other;
+    } else {
+      // Distances are symmetric, so d(v, t) >= d(L, v) - d(L, t) as well.
+      u32 other = differenceBound(from[v], from[t]);
+      if (other > bound)
+        bound = other;
+    }
+    if (bound > best)
+      best = bound;
+  }
+  return best;
+}
+
+/**
+ * @brief Computes a shortest path from `s` to `t` with A* and the landmark
+ * bounds of `L`, which must have been computed for `G`.
+ */
+Path *altQuery(Graph *G, Landmarks *L, u32 s, u32 t) {
+  assert(L != NULL && L->n == numberOfVertices(G));
+  return aStar(G, s, t, altLowerBound, L);
+}
+
+/**
+ * @brief Like altQuery, but runs in the workspace W. See workspaceAStar.
+ */
+Path *workspaceAltQuery(Graph *G, Landmarks *L, u32 s, u32 t,
+                        SearchWorkspace *W) {
+  assert(L != NULL && L->n == numberOfVertices(G));
+  return workspaceAStar(G, s, t, altLowerBound, L, W);
+}
+
+/**
+ * @brief Helper function. Writes `count` integers to `f`, exiting on error.
+ */
+static void writeWords(FILE *f, u32 *words, u64 count) {
+  if (fwrite(words, sizeof(u32), count, f) != count) {
+    printf("Error writing file!\n");
+    exit(1);
+  }
+}
+
+/**
+ * @brief Helper function. Reads `count` integers from `f`, exiting on error.
+ */
+static void readWords(FILE *f, u32 *words, u64 count) {
+  if (fread(words, sizeof(u32), count, f) != count) {
+    printf("Error: truncated landmark file\n");
+    exit(1);
+  }
+}
+
+/**
+ * @brief Writes the landmark table to a binary file, so that it can be
+ * stored next to the graph and the preprocessing paid once. The file holds
+ * a header (magic, version, n, k, directed), the landmarks and the
+ * distance arrays, in native byte order.
+ */
+void writeLandmarks(Landmarks *L, char *fname) {
+  assert(L != NULL);
+  FILE *f = fopen(fname, "wb");
+  if (f == NULL) {
+    printf("Error opening file!\n");
+    exit(1);
+  }
+  u32 header[5] = {LANDMARK_MAGIC, LANDMARK_VERSION, L->n, L->k, L->directed};
+  writeWords(f, header, 5);
+  writeWords(f, L->vertices, L->k);
+  writeWords(f, L->from, (u64)L->k * L->n);
+  if (L->directed)
+    writeWords(f, L->to, (u64)L->k * L->n);
+  fclose(f);
+}
+
+/**
+ * @brief Reads a landmark table written by writeLandmarks. The table must
+ * have been computed for `G`: its number of vertices and directedness are
+ * checked against it.
+ */
+Landmarks *readLandmarks(Graph *G, char *fname) {
+  assert(G != NULL);
+  FILE *f = fopen(fname, "rb");
+  if (f == NULL) {
+    printf("Error opening file!\n");
+    exit(1);
+  }
+  u32 header[5];
+  readWords(f, header, 5);
+  if (header[0] != LANDMARK_MAGIC || header[1] != LANDMARK_VERSION) {
+    printf("Error: %s is not a landmark file\n", fname);
+    exit(1);
+  }
+  bool directed = G->_g_flag & D_FLAG;
+  if (header[2] != numberOfVertices(G) || header[4] != directed) {
+    printf("Error: %s does not match the graph\n", fname);
+    exit(1);
+  }
+  Landmarks *L = createLandmarks(header[2], header[3], directed);
+  readWords(f, L->vertices, L->k);
+  readWords(f, L->from, (u64)L->k * L->n);
+  if (directed)
+    readWords(f, L->to, (u64)L->k * L->n);
+  fclose(f);
+  return L;
+}
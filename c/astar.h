@@ -0,0 +1,64 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file astar.h
+ * @brief Goal-directed point-to-point shortest paths: A* with a user
+ * heuristic, and ALT (A*, landmarks, triangle inequality).
+ */
+
+#ifndef ASTAR_H
+#define ASTAR_H
+
+#include "dijkstra.h"
+
+// A lower bound on the distance from `v` to `t`. Returning INT_MAX states
+// that `t` is unreachable from `v`, and `v` is then never expanded.
+typedef u32 (*Heuristic)(u32 v, u32 t, void *ctx);
+
+// Distances between the vertices of a graph and k landmarks.
+typedef struct {
+  u32 n;         // number of vertices of the graph
+  u32 k;         // number of landmarks
+  bool directed; // whether `to` is stored
+  u32 *vertices; // the landmarks
+  u32 *from;     // from[i * n + v] is the distance from vertices[i] to v
+  u32 *to;       // to[i * n + v] is the distance from v to vertices[i]; NULL
+                 // for undirected graphs, where it equals `from`
+} Landmarks;
+
+Path *aStar(Graph *G, u32 s, u32 t, Heuristic h, void *ctx);
+Path *workspaceAStar(Graph *G, u32 s, u32 t, Heuristic h, void *ctx,
+                     SearchWorkspace *W);
+Landmarks *selectLandmarks(Graph *G, u32 k, ReverseIndex *R);
+u32 altLowerBound(u32 v, u32 t, void *landmarks);
+Path *altQuery(Graph *G, Landmarks *L, u32 s, u32 t);
+Path *workspaceAltQuery(Graph *G, Landmarks *L, u32 s, u32 t,
+                        SearchWorkspace *W);
+void writeLandmarks(Landmarks *L, char *fname);
+Landmarks *readLandmarks(Graph *G, char *fname);
+void dumpLandmarks(Landmarks *L);
+
+#endif
@@ -0,0 +1,209 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bench_bfs.c
+ * @brief Throughput of BFSLevels, directionOptimizingBFS and parallelBFS in
+ * traversed edges per second (TEPS) on a Graph500-style Kronecker graph and
+ * on a grid, and of msBFS against one BFSLevels per source. Also compares
+ * the cost of materialising a GraphVersion with that of a BFS on it.
+ *
+ * As in Graph500, the edges traversed by a search are the edges of the
+ * component of its source, whichever of them the search actually examines.
+ *
+ * Usage: bench_bfs [scale] [gridSide] [maxThreads]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "api.h"
+#include "bfs.h"
+#include "generator.h"
+#include "msbfs.h"
+#include "threadpool.h"
+#include "utils.h"
+#include "versioned.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Number of sources each search is timed from.
+#define BENCH_SOURCES 8
+
+// Number of sources of the many-source comparison.
+#define BENCH_MANY_SOURCES 512
+
+static double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, double elapsed, u64 edges) {
+  printf("  %-22s %8.4f s   %8.2f MTEPS\n", name, elapsed / BENCH_SOURCES,
+         edges / elapsed * 1e-6);
+}
+
+static void addLevel(u32 v, u32 level, u64 reached, u32 first, void *ctx) {
+  (void)v;
+  (void)first;
+  *(u64 *)ctx += level * (u64)__builtin_popcountll(reached);
+}
+
+/**
+ * @brief Times the sum of all distances from BENCH_MANY_SOURCES sources, the
+ * core of closeness centrality, with one BFS per source and with msBFS.
+ */
+static void benchManySources(Graph *G) {
+  u32 n = numberOfVertices(G);
+  u32 *sources = genArray(BENCH_MANY_SOURCES);
+  for (u32 k = 0; k < BENCH_MANY_SOURCES; k++)
+    sources[k] = rand() % n;
+  u32 *levels = genArray(n);
+
+  u64 expected = 0;
+  double start = now();
+  for (u32 k = 0; k < BENCH_MANY_SOURCES; k++) {
+    BFSLevels(G, sources[k], levels, NULL);
+    for (u32 v = 0; v < n; v++)
+      expected += levels[v] == INT_MAX ? 0 : levels[v];
+  }
+  double looped = now() - start;
+
+  u64 total = 0;
+  start = now();
+  msBFS(G, sources, BENCH_MANY_SOURCES, addLevel, &total);
+  double elapsed = now() - start;
+  assert(total == expected);
+  printf("  %u sources: BFS loop %8.3f s   msBFS %8.3f s   speedup %5.2fx\n",
+         BENCH_MANY_SOURCES, looped, elapsed, looped / elapsed);
+  free(levels);
+  free(sources);
+}
+
+/**
+ * @brief Times a BFS on a pinned version of G when each query copies the
+ * version with versionToGraph and when all queries share versionGraph.
+ */
+static void benchVersioned(Graph *G, u32 *sources) {
+  u32 *levels = genArray(numberOfVertices(G));
+  VersionedGraph *V = createVersionedGraph(G, 1);
+  GraphVersion *S = pinVersion(V, 0);
+
+  double copied = 0;
+  for (u32 k = 0; k < BENCH_SOURCES; k++) {
+    double start = now();
+    Graph *C = versionToGraph(S);
+    copied += now() - start;
+    dumpGraph(C);
+  }
+
+  double start = now();
+  Graph *shared = versionGraph(S);
+  double built = now() - start;
+  start = now();
+  for (u32 k = 0; k < BENCH_SOURCES; k++)
+    BFSLevels(versionGraph(S), sources[k], levels, NULL);
+  double searched = now() - start;
+  assert(versionGraph(S) == shared);
+
+  printf("  versioned: copy %8.4f s   BFS %8.4f s   per query; the shared "
+         "graph is built once in %.4f s\n",
+         copied / BENCH_SOURCES, searched / BENCH_SOURCES, built);
+  unpinVersion(V, 0);
+  dumpVersionedGraph(V);
+  free(levels);
+}
+
+static void benchGraph(const char *name, Graph *G, u32 maxThreads) {
+  u32 n = numberOfVertices(G);
+  u32 sources[BENCH_SOURCES];
+  for (u32 k = 0; k < BENCH_SOURCES; k++) {
+    do
+      sources[k] = rand() % n;
+    while (degree(sources[k], G) == 0);
+  }
+
+  u32 *expected = genArray(n);
+  u32 *levels = genArray(n);
+  u64 edges = 0;
+  for (u32 k = 0; k < BENCH_SOURCES; k++) {
+    BFSLevels(G, sources[k], levels, NULL);
+    for (u32 v = 0; v < n; v++) {
+      if (levels[v] != INT_MAX)
+        edges += degree(v, G);
+    }
+  }
+  edges /= 2;
+  printf("\n%s: n = %u, m = %u\n", name, n, numberOfEdges(G));
+
+  double start = now();
+  for (u32 k = 0; k < BENCH_SOURCES; k++)
+    BFSLevels(G, sources[k], levels, NULL);
+  report("top-down", now() - start, edges);
+
+  start = now();
+  for (u32 k = 0; k < BENCH_SOURCES; k++)
+    directionOptimizingBFS(G, sources[k], NULL, levels, NULL, NULL);
+  report("direction-optimizing", now() - start, edges);
+
+  for (u32 t = 1; t <= maxThreads; t *= 2) {
+    ThreadPool *pool = createThreadPool(t);
+    start = now();
+    for (u32 k = 0; k < BENCH_SOURCES; k++)
+      parallelBFS(G, sources[k], levels, NULL, pool);
+    double elapsed = now() - start;
+    BFSLevels(G, sources[BENCH_SOURCES - 1], expected, NULL);
+    assert(memcmp(levels, expected, n * sizeof(u32)) == 0);
+    char label[32];
+    snprintf(label, sizeof(label), "parallel, %u threads", t);
+    report(label, elapsed, edges);
+    dumpThreadPool(pool);
+  }
+  free(expected);
+  free(levels);
+  benchVersioned(G, sources);
+  benchManySources(G);
+}
+
+int main(int argc, char *argv[]) {
+  u32 scale = argc > 1 ? atoi(argv[1]) : 18;
+  u32 side = argc > 2 ? atoi(argv[2]) : 1000;
+  u32 maxThreads = argc > 3 ? (u32)atoi(argv[3]) : numberOfCores();
+  srand(12345);
+
+  printf("Cores available: %u\n", numberOfCores());
+  Graph *K = genKronecker(scale, 16, 1);
+  benchGraph("Kronecker", K, maxThreads);
+  dumpGraph(K);
+
+  Graph *R = genGrid(side, side, 1);
+  benchGraph("Grid", R, maxThreads);
+  dumpGraph(R);
+  return 0;
+}
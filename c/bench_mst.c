@@ -0,0 +1,105 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bench_mst.c
+ * @brief Benchmark of the minimum spanning forest algorithms (prim, kruskal,
+ * filterKruskal and boruvka) on random graphs of increasing density.
+ *
+ * Usage: bench_mst [logVertices] [threads]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "api.h"
+#include "boruvka.h"
+#include "kruskal.h"
+#include "prim.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+typedef u32 (*ForestAlgorithm)(Graph *, u32 *, u64 *, ThreadPool *);
+
+static void benchAlgorithm(const char *name, ForestAlgorithm algorithm,
+                           Graph *G, u64 expected, u32 threads) {
+  u32 *chosen = genArray(numberOfVertices(G));
+  u64 total;
+  double start = now();
+  algorithm(G, chosen, &total, NULL);
+  double oneThread = now() - start;
+  assert(total == expected);
+
+  ThreadPool *pool = createThreadPool(threads);
+  start = now();
+  algorithm(G, chosen, &total, pool);
+  double elapsed = now() - start;
+  assert(total == expected);
+  dumpThreadPool(pool);
+
+  printf("    %-15s %8.3f s   %2u threads %8.3f s   speedup %5.2fx\n", name,
+         oneThread, threads, elapsed, oneThread / elapsed);
+  free(chosen);
+}
+
+static void benchGraph(Graph *G, u32 threads) {
+  u32 n = numberOfVertices(G);
+  u32 *parents = genArray(n);
+  double start = now();
+  u64 expected = primWithParents(G, 0, parents, NULL);
+  double primTime = now() - start;
+  free(parents);
+
+  printf("  m/n = %u\n    %-15s %8.3f s\n", numberOfEdges(G) / n, "prim",
+         primTime);
+  benchAlgorithm("kruskal", kruskalEdges, G, expected, threads);
+  benchAlgorithm("filter-kruskal", filterKruskalEdges, G, expected, threads);
+  benchAlgorithm("boruvka", boruvkaEdges, G, expected, threads);
+}
+
+int main(int argc, char *argv[]) {
+  u32 logN = argc > 1 ? atoi(argv[1]) : 16;
+  u32 threads = argc > 2 ? (u32)atoi(argv[2]) : numberOfCores();
+  u32 n = 1u << logN;
+  srand(12345);
+
+  printf("Cores available: %u\nRandom graphs, n = %u\n", numberOfCores(), n);
+  for (u32 density = 1; density <= 64; density *= 4) {
+    Graph *G = randomMultigraph(n, density * n, 1000000, W_FLAG, false);
+    benchGraph(G, threads);
+    dumpGraph(G);
+  }
+  return 0;
+}
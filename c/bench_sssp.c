@@ -0,0 +1,158 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bench_sssp.c
+ * @brief Scaling benchmark of deltaStepping against dijkstra on a
+ * Graph500-style Kronecker graph and on a road-like grid, and of the
+ * preprocessing and queries of contraction hierarchies on a smaller grid.
+ *
+ * Usage: bench_sssp [scale] [gridSide] [maxThreads] [chSide]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "api.h"
+#include "ch.h"
+#include "deltastepping.h"
+#include "dijkstra.h"
+#include "generator.h"
+#include "threadpool.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void benchGraph(const char *name, Graph *G, u32 maxThreads) {
+  u32 n = numberOfVertices(G);
+  u32 s = 0;
+  while (s < n && degree(s, G) == 0)
+    s++;
+
+  double start = now();
+  u32 *expected = dijkstra(s, G);
+  double dijkstraTime = now() - start;
+
+  printf("\n%s: n = %u, m = %u, delta = %u\n", name, n, numberOfEdges(G),
+         deltaSteppingWidth(G));
+  printf("  dijkstra            %8.3f s\n", dijkstraTime);
+
+  double oneThread = 0;
+  for (u32 t = 1; t <= maxThreads; t *= 2) {
+    ThreadPool *pool = createThreadPool(t);
+    start = now();
+    u32 *distances = deltaStepping(s, G, 0, pool);
+    double elapsed = now() - start;
+    assert(memcmp(distances, expected, n * sizeof(u32)) == 0);
+    if (t == 1)
+      oneThread = elapsed;
+    printf("  delta, %2u threads   %8.3f s   speedup %5.2fx   vs dijkstra "
+           "%5.2fx\n",
+           t, elapsed, oneThread / elapsed, dijkstraTime / elapsed);
+    free(distances);
+    dumpThreadPool(pool);
+  }
+  free(expected);
+}
+
+static void benchContraction(u32 side, u32 maxThreads) {
+  Graph *G = genGrid(side, side, 1000);
+  u32 n = numberOfVertices(G);
+  printf("\nContraction hierarchy, grid: n = %u, m = %u\n", n,
+         numberOfEdges(G));
+
+  ContractionHierarchy *H = NULL;
+  double oneThread = 0;
+  for (u32 t = 1; t <= maxThreads; t *= 2) {
+    ThreadPool *pool = createThreadPool(t);
+    double start = now();
+    ContractionHierarchy *K = buildContractionHierarchy(G, pool);
+    double elapsed = now() - start;
+    if (t == 1) {
+      oneThread = elapsed;
+      H = K;
+    } else {
+      // The hierarchy does not depend on the number of threads.
+      assert(memcmp(K->rank, H->rank, n * sizeof(u32)) == 0);
+      dumpContractionHierarchy(K);
+    }
+    printf("  preprocessing, %2u threads   %8.3f s   speedup %5.2fx\n", t,
+           elapsed, oneThread / elapsed);
+    dumpThreadPool(pool);
+  }
+
+  u32 queries = 10000;
+  u32 *ends = genArray(2 * queries);
+  for (u32 i = 0; i < 2 * queries; i++)
+    ends[i] = rand() % n;
+  CHQuery *Q = createCHQuery(H);
+  u64 settled = 0;
+  double start = now();
+  for (u32 i = 0; i < queries; i++) {
+    chDistance(Q, ends[2 * i], ends[2 * i + 1]);
+    settled += Q->settled;
+  }
+  double distanceTime = now() - start;
+  start = now();
+  for (u32 i = 0; i < queries; i++)
+    dumpPath(chShortestPath(Q, ends[2 * i], ends[2 * i + 1]));
+  double pathTime = now() - start;
+  printf("  chDistance       %8.2f us/query, %llu settled on average\n",
+         1e6 * distanceTime / queries, (unsigned long long)settled / queries);
+  printf("  chShortestPath   %8.2f us/query\n", 1e6 * pathTime / queries);
+
+  dumpCHQuery(Q);
+  free(ends);
+  dumpContractionHierarchy(H);
+  dumpGraph(G);
+}
+
+int main(int argc, char *argv[]) {
+  u32 scale = argc > 1 ? atoi(argv[1]) : 18;
+  u32 side = argc > 2 ? atoi(argv[2]) : 1000;
+  u32 maxThreads = argc > 3 ? atoi(argv[3]) : 64;
+  u32 chSide = argc > 4 ? atoi(argv[4]) : 200;
+  srand(12345);
+
+  printf("Cores available: %u\n", numberOfCores());
+  Graph *K = genKronecker(scale, 16, 255);
+  benchGraph("Kronecker", K, maxThreads);
+  dumpGraph(K);
+
+  Graph *R = genGrid(side, side, 1000);
+  benchGraph("Grid", R, maxThreads);
+  dumpGraph(R);
+
+  benchContraction(chSide, maxThreads);
+  return 0;
+}
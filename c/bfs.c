@@ -0,0 +1,492 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bfs.c
+ * @brief Breadth-first search over frontier arrays.
+ *
+ * The search expands the current frontier into the next one, level by
+ * level. Visited vertices are marked in a bitmap of n bits, which stays in
+ * cache far longer than an n-word array, and nothing is allocated per
+ * vertex. Trees can be built afterwards from the parents with
+ * treeFromParents.
+ *
+ * The direction-optimizing search (Beamer, Asanović and Patterson) also has
+ * a bottom-up step, in which every unvisited vertex looks for a parent in a
+ * bitmap of the frontier and stops at the first one found. On graphs of low
+ * diameter, where a few middle levels hold most vertices, this skips most
+ * of the edges a top-down step would examine.
+ *
+ * The parallel search is level-synchronous. Threads claim chunks of the
+ * frontier from a shared cursor, claim each vertex they reach with a
+ * compare-and-swap on its parent, and collect it in a buffer of their own.
+ * The buffers are then copied side by side into the next frontier at
+ * offsets given by a prefix sum of their sizes.
+ */
+
+#include "bfs.h"
+#include "api.h"
+#include "diapi.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Helper function. Allocates a cleared bitmap of n bits.
+ */
+static u64 *createBitmap(u32 n) {
+  u64 *bitmap = (u64 *)calloc(n / 64 + 1, sizeof(u64));
+  if (bitmap == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  return bitmap;
+}
+
+static bool testBit(const u64 *bitmap, u32 v) {
+  return (bitmap[v >> 6] >> (v & 63)) & 1;
+}
+
+static void setBit(u64 *bitmap, u32 v) { bitmap[v >> 6] |= 1ULL << (v & 63); }
+
+/**
+ * @brief Runs a BFS from `s`, following out-edges in digraphs.
+ *
+ * @param[out] levels If not NULL, receives the number of edges on a
+ * shortest path from `s` to each vertex, or INT_MAX for unreached ones.
+ * @param[out] parents If not NULL, receives the parent of each vertex in
+ * the BFS tree; `s` is its own parent and unreached vertices get NO_PARENT.
+ * @return The number of vertices reached, `s` included.
+ */
+u32 BFSLevels(Graph *G, u32 s, u32 *levels, u32 *parents) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n);
+  if (levels != NULL) {
+    for (u32 v = 0; v < n; v++)
+      levels[v] = INT_MAX;
+    levels[s] = 0;
+  }
+  if (parents != NULL) {
+    for (u32 v = 0; v < n; v++)
+      parents[v] = NO_PARENT;
+    parents[s] = s;
+  }
+
+  u64 *visited = createBitmap(n);
+  u32 *current = genArray(n);
+  u32 *next = genArray(n);
+  u32 currentSize = 0, reached = 1;
+  setBit(visited, s);
+  current[currentSize++] = s;
+
+  for (u32 level = 1; currentSize > 0; level++) {
+    u32 nextSize = 0;
+    for (u32 k = 0; k < currentSize; k++) {
+      u32 v = current[k];
+      u32 first = firstNeighbourIndex(G, v);
+      u32 last = first + degree(v, G);
+      for (u32 i = first; i < last; i++) {
+        u32 w = (G->_edges)[i].y;
+        if (testBit(visited, w))
+          continue;
+        setBit(visited, w);
+        next[nextSize++] = w;
+        if (levels != NULL)
+          levels[w] = level;
+        if (parents != NULL)
+          parents[w] = v;
+      }
+    }
+    reached += nextSize;
+    u32 *t = current;
+    current = next;
+    next = t;
+    currentSize = nextSize;
+  }
+
+  free(visited);
+  free(current);
+  free(next);
+  return reached;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~ Direction-optimizing ~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef struct {
+  Graph *G;
+  ReverseIndex *R; // in-edges, for digraphs only
+  u32 n;
+  u32 *levels;
+  u32 *parents;
+  u64 *visited;
+  u64 examined;
+  u64 frontierEdges;   // out-edges of the frontier
+  u64 unexploredEdges; // in-edges of the unvisited vertices
+} DirectionContext;
+
+static u32 inDegreeOf(DirectionContext *C, u32 v) {
+  return C->R == NULL ? degree(v, C->G) : C->R->first[v + 1] - C->R->first[v];
+}
+
+/**
+ * @brief Helper function. Marks `w`, reached from `v` on `level`.
+ */
+static void visit(DirectionContext *C, u32 v, u32 w, u32 level) {
+  setBit(C->visited, w);
+  if (C->levels != NULL)
+    C->levels[w] = level;
+  if (C->parents != NULL)
+    C->parents[w] = v;
+  C->frontierEdges += degree(w, C->G);
+  C->unexploredEdges -= inDegreeOf(C, w);
+}
+
+/**
+ * @brief Helper function. Expands the `size` vertices of `current` along
+ * their out-edges into `next`.
+ *
+ * @return The size of the next frontier.
+ */
+static u32 topDownStep(DirectionContext *C, u32 *current, u32 size,
+                       u32 *next, u32 level) {
+  Graph *G = C->G;
+  u32 nextSize = 0;
+  for (u32 k = 0; k < size; k++) {
+    u32 v = current[k];
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    C->examined += last - first;
+    for (u32 i = first; i < last; i++) {
+      u32 w = (G->_edges)[i].y;
+      if (testBit(C->visited, w))
+        continue;
+      visit(C, v, w, level);
+      next[nextSize++] = w;
+    }
+  }
+  return nextSize;
+}
+
+/**
+ * @brief Helper function. Lets every unvisited vertex look among its
+ * in-neighbours for one in the `frontier` bitmap, and adds those that find
+ * one to the `next` bitmap.
+ *
+ * @return The size of the next frontier.
+ */
+static u32 bottomUpStep(DirectionContext *C, const u64 *frontier, u64 *next,
+                        u32 level) {
+  Graph *G = C->G;
+  u32 words = C->n / 64 + 1;
+  u32 nextSize = 0;
+  for (u32 word = 0; word < words; word++) {
+    u64 unvisited = ~C->visited[word];
+    if (word == words - 1)
+      unvisited &= (1ULL << (C->n & 63)) - 1;
+    while (unvisited != 0) {
+      u32 v = word * 64 + __builtin_ctzll(unvisited);
+      unvisited &= unvisited - 1;
+      u32 first, last;
+      if (C->R == NULL) {
+        first = firstNeighbourIndex(G, v);
+        last = first + degree(v, G);
+      } else {
+        first = C->R->first[v];
+        last = C->R->first[v + 1];
+      }
+      for (u32 i = first; i < last; i++) {
+        C->examined++;
+        u32 u = C->R == NULL ? (G->_edges)[i].y
+                             : (G->_edges)[C->R->edges[i]].x;
+        if (testBit(frontier, u)) {
+          visit(C, u, v, level);
+          setBit(next, v);
+          nextSize++;
+          break;
+        }
+      }
+    }
+  }
+  return nextSize;
+}
+
+/**
+ * @brief Runs a direction-optimizing BFS from `s`, following out-edges in
+ * digraphs. Each level is expanded top-down from a frontier array or
+ * bottom-up against a frontier bitmap, as chosen by the BFS_ALPHA and
+ * BFS_BETA heuristics.
+ *
+ * @param R The in-edges of `G` if it is a digraph, as built by
+ * buildReverseIndex; if NULL they are built and freed here. Ignored for
+ * undirected graphs.
+ * @param[out] levels, parents As in BFSLevels; parents may differ from
+ * those of BFSLevels, but are at the same levels.
+ * @param[out] edgesExamined If not NULL, receives the number of edges the
+ * search looked at.
+ * @return The number of vertices reached, `s` included.
+ */
+u32 directionOptimizingBFS(Graph *G, u32 s, ReverseIndex *R, u32 *levels,
+                           u32 *parents, u64 *edgesExamined) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n);
+  bool directed = G->_g_flag & D_FLAG;
+  ReverseIndex *own = NULL;
+  if (directed && R == NULL)
+    R = own = buildReverseIndex(G);
+  if (!directed)
+    R = NULL;
+  if (levels != NULL) {
+    for (u32 v = 0; v < n; v++)
+      levels[v] = INT_MAX;
+    levels[s] = 0;
+  }
+  if (parents != NULL) {
+    for (u32 v = 0; v < n; v++)
+      parents[v] = NO_PARENT;
+    parents[s] = s;
+  }
+
+  DirectionContext C = {G, R, n, levels, parents, createBitmap(n), 0, 0, 0};
+  C.unexploredEdges = directed ? numberOfEdges(G) : 2 * (u64)numberOfEdges(G);
+  visit(&C, s, s, 0);
+  u64 *frontierBits = createBitmap(n);
+  u64 *nextBits = createBitmap(n);
+  u32 *current = genArray(n);
+  u32 *next = genArray(n);
+  current[0] = s;
+  u32 size = 1, previousSize = 0, reached = 1;
+  bool bottomUp = false;
+
+  for (u32 level = 1; size > 0; level++) {
+    if (!bottomUp && size > previousSize &&
+        C.frontierEdges > C.unexploredEdges / BFS_ALPHA) {
+      memset(frontierBits, 0, (n / 64 + 1) * sizeof(u64));
+      for (u32 k = 0; k < size; k++)
+        setBit(frontierBits, current[k]);
+      bottomUp = true;
+    } else if (bottomUp && size < previousSize && size < n / BFS_BETA) {
+      u32 k = 0;
+      for (u32 v = 0; v < n; v++) {
+        if (testBit(frontierBits, v))
+          current[k++] = v;
+      }
+      bottomUp = false;
+    }
+
+    previousSize = size;
+    C.frontierEdges = 0;
+    if (bottomUp) {
+      memset(nextBits, 0, (n / 64 + 1) * sizeof(u64));
+      size = bottomUpStep(&C, frontierBits, nextBits, level);
+      u64 *t = frontierBits;
+      frontierBits = nextBits;
+      nextBits = t;
+    } else {
+      size = topDownStep(&C, current, size, next, level);
+      u32 *t = current;
+      current = next;
+      next = t;
+    }
+    reached += size;
+  }
+
+  if (edgesExamined != NULL)
+    *edgesExamined = C.examined;
+  free(C.visited);
+  free(frontierBits);
+  free(nextBits);
+  free(current);
+  free(next);
+  dumpReverseIndex(own);
+  return reached;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Parallel ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef struct {
+  u32 *array;
+  u32 size;
+  u32 capacity;
+  u64 edges; // out-edges of the vertices in the buffer
+} FrontierBuffer;
+
+typedef struct {
+  Graph *G;
+  ThreadPool *pool;
+  u32 *levels;
+  u32 *parents;
+  u32 *frontiers[2]; // frontiers[level & 1] is expanded on `level`
+  FrontierBuffer *local;
+  u32 *offsets; // offsets[t]: where thread t copies its buffer
+  u32 size;     // size of the current frontier
+  u32 chunk;    // frontier vertices claimed at a time
+  u32 cursor;   // next unclaimed frontier position
+  u32 reached;
+} ParallelBFSContext;
+
+static void pushFrontier(FrontierBuffer *buffer, u32 v) {
+  if (buffer->size == buffer->capacity) {
+    buffer->capacity = buffer->capacity == 0 ? 64 : 2 * buffer->capacity;
+    buffer->array =
+        (u32 *)realloc(buffer->array, buffer->capacity * sizeof(u32));
+    if (buffer->array == NULL) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  buffer->array[buffer->size++] = v;
+}
+
+/**
+ * @brief Helper function. Sizes the chunks so that each holds about
+ * PARALLEL_BFS_CHUNK_EDGES edges, which keeps chunks short when the
+ * frontier holds hubs, while leaving every thread a few chunks.
+ */
+static u32 chunkSize(u32 size, u64 edges, u32 nThreads) {
+  u64 chunk = edges == 0 ? size : PARALLEL_BFS_CHUNK_EDGES * (u64)size / edges;
+  if (chunk > size / (4 * nThreads))
+    chunk = size / (4 * nThreads);
+  return chunk == 0 ? 1 : (u32)chunk;
+}
+
+/**
+ * @brief Task. Expands the frontier level by level until it is empty.
+ */
+static void parallelBFSTask(u32 t, u32 nThreads, void *ctx) {
+  ParallelBFSContext *C = (ParallelBFSContext *)ctx;
+  Graph *G = C->G;
+  FrontierBuffer *mine = &C->local[t];
+
+  for (u32 level = 1; C->size > 0; level++) {
+    const u32 *current = C->frontiers[level & 1];
+    while (true) {
+      u32 start = __atomic_fetch_add(&C->cursor, C->chunk, __ATOMIC_RELAXED);
+      if (start >= C->size)
+        break;
+      u32 end = min(start + C->chunk, C->size);
+      for (u32 k = start; k < end; k++) {
+        u32 v = current[k];
+        u32 first = firstNeighbourIndex(G, v);
+        u32 last = first + degree(v, G);
+        for (u32 i = first; i < last; i++) {
+          u32 w = (G->_edges)[i].y;
+          u32 parent = __atomic_load_n(&C->parents[w], __ATOMIC_RELAXED);
+          if (parent != NO_PARENT ||
+              !__atomic_compare_exchange_n(&C->parents[w], &parent, v, false,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            continue;
+          if (C->levels != NULL)
+            C->levels[w] = level;
+          pushFrontier(mine, w);
+          mine->edges += degree(w, G);
+        }
+      }
+    }
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+
+    if (t == 0) {
+      u64 edges = 0;
+      C->offsets[0] = 0;
+      for (u32 k = 0; k < nThreads; k++) {
+        C->offsets[k + 1] = C->offsets[k] + C->local[k].size;
+        edges += C->local[k].edges;
+      }
+      C->size = C->offsets[nThreads];
+      C->reached += C->size;
+      C->chunk = chunkSize(C->size, edges, nThreads);
+      C->cursor = 0;
+    }
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+
+    if (mine->size > 0)
+      memcpy(&C->frontiers[(level + 1) & 1][C->offsets[t]], mine->array,
+             mine->size * sizeof(u32));
+    mine->size = 0;
+    mine->edges = 0;
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+  }
+}
+
+/**
+ * @brief Runs a level-synchronous BFS from `s` on the threads of `pool`,
+ * following out-edges in digraphs.
+ *
+ * @param[out] levels If not NULL, as in BFSLevels.
+ * @param[out] parents If not NULL, as in BFSLevels; which of several parents
+ * on the previous level a vertex gets depends on the schedule.
+ * @param pool The threads to use, or NULL to run on the calling thread.
+ * @return The number of vertices reached, `s` included.
+ */
+u32 parallelBFS(Graph *G, u32 s, u32 *levels, u32 *parents, ThreadPool *pool) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n);
+  u32 nThreads = poolSize(pool);
+  u32 *ownParents = parents == NULL ? genArray(n) : NULL;
+  if (parents == NULL)
+    parents = ownParents;
+  for (u32 v = 0; v < n; v++)
+    parents[v] = NO_PARENT;
+  parents[s] = s;
+  if (levels != NULL) {
+    for (u32 v = 0; v < n; v++)
+      levels[v] = INT_MAX;
+    levels[s] = 0;
+  }
+
+  ParallelBFSContext C = {G, pool, levels, parents, {genArray(n), genArray(n)},
+                          NULL, genArray(nThreads + 1), 1, 1, 0, 1};
+  C.local = (FrontierBuffer *)calloc(nThreads, sizeof(FrontierBuffer));
+  if (C.local == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  C.frontiers[1][0] = s;
+  if (pool == NULL)
+    parallelBFSTask(0, 1, &C);
+  else
+    poolRun(pool, parallelBFSTask, &C);
+
+  for (u32 t = 0; t < nThreads; t++)
+    free(C.local[t].array);
+  free(C.local);
+  free(C.offsets);
+  free(C.frontiers[0]);
+  free(C.frontiers[1]);
+  free(ownParents);
+  return C.reached;
+}
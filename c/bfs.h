@@ -0,0 +1,53 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bfs.h
+ * @brief Breadth-first search producing level and parent arrays, with no
+ * per-vertex allocation: top-down, direction-optimizing or parallel.
+ */
+
+#ifndef BFS_H
+#define BFS_H
+
+#include "diapi.h"
+#include "graphStruct.h"
+#include "threadpool.h"
+
+// Direction-optimizing BFS turns bottom-up once a growing frontier has more
+// than 1 / BFS_ALPHA of the edges of the unvisited vertices, and top-down
+// again once a shrinking frontier has fewer than n / BFS_BETA vertices.
+#define BFS_ALPHA 15
+#define BFS_BETA 18
+
+// Parallel BFS hands out frontier chunks holding about this many edges.
+#define PARALLEL_BFS_CHUNK_EDGES 4096
+
+u32 BFSLevels(Graph *G, u32 s, u32 *levels, u32 *parents);
+u32 directionOptimizingBFS(Graph *G, u32 s, ReverseIndex *R, u32 *levels,
+                           u32 *parents, u64 *edgesExamined);
+u32 parallelBFS(Graph *G, u32 s, u32 *levels, u32 *parents, ThreadPool *pool);
+
+#endif
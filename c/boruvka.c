@@ -0,0 +1,211 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file boruvka.c
+ * @brief Borůvka's minimum spanning forest algorithm on a thread pool.
+ *
+ * Every round, each component picks the lightest edge leaving it and all
+ * picked edges are contracted at once, which at least halves the number of
+ * components. Edges are ranked by (weight, index), a total order, so the
+ * picked edges never close a cycle even among equal weights.
+ *
+ * A round is two parallel passes. The first, over the edges still joining
+ * two components, drops the others and lowers the best key of both
+ * components of each with a compare-and-swap. The second compacts the
+ * survivors and merges every component with the edge it picked through a
+ * concurrent union-find.
+ */
+
+#include "boruvka.h"
+#include "api.h"
+#include "kruskal.h"
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Best key of a component that has not picked an edge yet.
+#define NO_EDGE 0xFFFFFFFFFFFFFFFF
+
+typedef struct {
+  Graph *G;
+  UnionFind *U;
+  u64 *best;         // best[r], the least key leaving the component of root r
+  KeyedEdge *edges;  // edges[0..size), the edges joining two components
+  KeyedEdge *buffer; // where they are compacted
+  u32 size;
+  u32 *offsets;      // per-thread counts of live edges, then offsets
+  u32 *chosen;
+  u32 count;
+  ThreadPool *pool;
+} BoruvkaContext;
+
+static void roundBarrier(BoruvkaContext *C) {
+  if (C->pool != NULL)
+    poolBarrier(C->pool);
+}
+
+static void atomicMin(u64 *slot, u64 key) {
+  u64 current = __atomic_load_n(slot, __ATOMIC_RELAXED);
+  while (key < current &&
+         !__atomic_compare_exchange_n(slot, &current, key, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+/**
+ * @brief Task. Runs rounds until no edge joins two components.
+ */
+static void boruvkaTask(u32 thread, u32 nThreads, void *ctx) {
+  BoruvkaContext *C = (BoruvkaContext *)ctx;
+  Graph *G = C->G;
+  u32 n = numberOfVertices(G);
+  u32 vlo = (u64)n * thread / nThreads;
+  u32 vhi = (u64)n * (thread + 1) / nThreads;
+
+  while (true) {
+    u32 lo = (u64)C->size * thread / nThreads;
+    u32 hi = (u64)C->size * (thread + 1) / nThreads;
+
+    // Lightest edge leaving each component. The live edges of the block
+    // are moved to its front, with their ends replaced by their roots so
+    // that later finds are short.
+    u32 live = lo;
+    for (u32 i = lo; i < hi; i++) {
+      KeyedEdge e = C->edges[i];
+      u32 rx = concurrentFindSet(C->U, e.x);
+      u32 ry = concurrentFindSet(C->U, e.y);
+      if (rx == ry)
+        continue;
+      atomicMin(&C->best[rx], e.key);
+      atomicMin(&C->best[ry], e.key);
+      C->edges[live++] = (KeyedEdge){e.key, rx, ry};
+    }
+    C->offsets[thread] = live - lo;
+    roundBarrier(C);
+    if (thread == 0) {
+      u32 running = 0;
+      for (u32 t = 0; t < nThreads; t++) {
+        u32 c = C->offsets[t];
+        C->offsets[t] = running;
+        running += c;
+      }
+      C->size = running;
+    }
+    roundBarrier(C);
+    if (C->size == 0)
+      break;
+
+    memcpy(C->buffer + C->offsets[thread], C->edges + lo,
+           (live - lo) * sizeof(KeyedEdge));
+
+    // Contraction.
+    for (u32 r = vlo; r < vhi; r++) {
+      if (C->best[r] == NO_EDGE)
+        continue;
+      u32 index = (u32)C->best[r];
+      C->best[r] = NO_EDGE;
+      Edge e = (G->_edges)[index];
+      if (concurrentUnionSets(C->U, e.x, e.y))
+        C->chosen[__atomic_fetch_add(&C->count, 1, __ATOMIC_RELAXED)] = index;
+    }
+    roundBarrier(C);
+    if (thread == 0) {
+      KeyedEdge *t = C->edges;
+      C->edges = C->buffer;
+      C->buffer = t;
+    }
+    roundBarrier(C);
+  }
+}
+
+/**
+ * @brief Computes a minimum spanning forest of `G` with Borůvka's algorithm
+ * on the threads of `pool` (NULL runs on the calling thread), in
+ * O(log n) rounds of O((n + m) / p) work per thread.
+ *
+ * @param[out] chosen Receives the indices in G->_edges of the edges of the
+ * forest; it must have room for n - 1 of them.
+ * @param[out] totalWeight If not NULL, receives the weight of the forest.
+ * @return The number of edges of the forest.
+ */
+u32 boruvkaEdges(Graph *G, u32 *chosen, u64 *totalWeight, ThreadPool *pool) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(!(G->_g_flag & D_FLAG));
+  assert(isFormatted(G));
+  assert(chosen != NULL || numberOfVertices(G) <= 1);
+  u32 n = numberOfVertices(G);
+
+  BoruvkaContext C = {G, NULL, NULL, NULL, NULL, 0, NULL, chosen, 0, pool};
+  C.size = keyedEdges(G, &C.edges, &C.buffer);
+  C.U = createUnionFind(n);
+  C.best = (u64 *)malloc((n + 1) * sizeof(u64));
+  if (C.best == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  for (u32 v = 0; v < n; v++)
+    C.best[v] = NO_EDGE;
+  C.offsets = genArray(poolSize(pool));
+
+  if (pool == NULL)
+    boruvkaTask(0, 1, &C);
+  else
+    poolRun(pool, boruvkaTask, &C);
+
+  if (totalWeight != NULL) {
+    *totalWeight = 0;
+    for (u32 i = 0; i < C.count; i++)
+      *totalWeight += *(G->_edges)[chosen[i]].w;
+  }
+  dumpUnionFind(C.U);
+  free(C.best);
+  free(C.edges);
+  free(C.buffer);
+  free(C.offsets);
+  return C.count;
+}
+
+/**
+ * @brief Computes a minimum spanning tree of `G`, or a minimum spanning
+ * forest if `G` is disconnected, with Borůvka's algorithm on the threads of
+ * `pool` (NULL runs on the calling thread).
+ *
+ * @return A weighted graph on the n vertices of `G`, to be freed with
+ * dumpGraph.
+ */
+Graph *boruvka(Graph *G, ThreadPool *pool) {
+  u32 n = numberOfVertices(G);
+  u32 *chosen = genArray(n);
+  u32 k = boruvkaEdges(G, chosen, NULL, pool);
+  Graph *F = forestFromEdges(G, chosen, k);
+  free(chosen);
+  return F;
+}
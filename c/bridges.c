@@ -0,0 +1,313 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bridges.c
+ * @brief Tarjan's low-link depth-first search and what it tells about
+ * 2-connectivity.
+ *
+ * In a DFS of an undirected graph every non-tree edge joins a vertex to one
+ * of its ancestors. low[v] is the earliest discovery time reachable from
+ * the subtree of v through at most one such edge. The tree edge from p to
+ * its child v is a bridge iff low[v] > discovery[p], and p separates the
+ * subtree of v from the rest iff low[v] >= discovery[p].
+ *
+ * The search keeps an explicit stack of DFSFrame, so it handles paths of
+ * millions of vertices. Only the first entry back to the parent is skipped,
+ * so parallel edges count as cycles. Components are then labelled in one
+ * pass over the vertices in preorder, with no edge stack.
+ */
+
+#include "bridges.h"
+#include "api.h"
+#include "components.h"
+#include "search.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+  u32 n;
+  u32 *discovery; // NO_PARENT until discovered
+  u32 *low;
+  u32 *parents;
+  u32 *parentEdges; // index in G->_edges of the tree edge from the parent
+  u32 *preorder;
+} LowLink;
+
+static void dumpLowLink(LowLink *L) {
+  free(L->discovery);
+  free(L->low);
+  free(L->parents);
+  free(L->parentEdges);
+  free(L->preorder);
+}
+
+/**
+ * @brief Helper function. Runs the low-link DFS from every undiscovered
+ * vertex in increasing order.
+ */
+static LowLink lowLink(Graph *G) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  assert(!(G->_g_flag & D_FLAG));
+  u32 n = numberOfVertices(G);
+  LowLink L = {n, genArray(n), genArray(n), genArray(n), genArray(n),
+               genArray(n)};
+  for (u32 v = 0; v < n; v++) {
+    L.discovery[v] = NO_PARENT;
+    L.parents[v] = NO_PARENT;
+    L.parentEdges[v] = NO_PARENT;
+  }
+  bool *skipped = (bool *)calloc(n + 1, sizeof(bool));
+  DFSFrame *stack = (DFSFrame *)malloc((n + 1) * sizeof(DFSFrame));
+  if (skipped == NULL || stack == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+
+  u32 clock = 0;
+  for (u32 r = 0; r < n; r++) {
+    if (L.discovery[r] != NO_PARENT)
+      continue;
+    u32 top = 0;
+    L.discovery[r] = L.low[r] = clock;
+    L.preorder[clock++] = r;
+    stack[top++] = (DFSFrame){r, firstNeighbourIndex(G, r)};
+    while (top > 0) {
+      DFSFrame *f = &stack[top - 1];
+      u32 v = f->vertex;
+      if (f->next < firstNeighbourIndex(G, v) + degree(v, G)) {
+        u32 i = f->next++;
+        u32 w = (G->_edges)[i].y;
+        if (w == L.parents[v] && !skipped[v]) {
+          skipped[v] = true;
+          continue;
+        }
+        if (L.discovery[w] == NO_PARENT) {
+          L.parents[w] = v;
+          L.parentEdges[w] = i;
+          L.discovery[w] = L.low[w] = clock;
+          L.preorder[clock++] = w;
+          stack[top++] = (DFSFrame){w, firstNeighbourIndex(G, w)};
+        } else {
+          L.low[v] = min(L.low[v], L.discovery[w]);
+        }
+        continue;
+      }
+      top--;
+      u32 p = L.parents[v];
+      if (p != NO_PARENT)
+        L.low[p] = min(L.low[p], L.low[v]);
+    }
+  }
+  free(skipped);
+  free(stack);
+  return L;
+}
+
+/**
+ * @brief Finds the bridges of `G`, the edges whose removal disconnects
+ * their ends, in O(n + m).
+ *
+ * @param[out] bridges If not NULL, receives the index in G->_edges of one of
+ * the two entries of each bridge; it must hold n - 1 entries.
+ * @return The number of bridges.
+ */
+u32 findBridges(Graph *G, u32 *bridges) {
+  LowLink L = lowLink(G);
+  u32 count = 0;
+  for (u32 v = 0; v < L.n; v++) {
+    u32 p = L.parents[v];
+    if (p != NO_PARENT && L.low[v] > L.discovery[p]) {
+      if (bridges != NULL)
+        bridges[count] = L.parentEdges[v];
+      count++;
+    }
+  }
+  dumpLowLink(&L);
+  return count;
+}
+
+/**
+ * @brief Finds the articulation points of `G`, the vertices whose removal
+ * disconnects their component, in O(n + m).
+ *
+ * @param[out] isArticulation If not NULL, receives for each vertex whether
+ * it is an articulation point.
+ * @return The number of articulation points.
+ */
+u32 articulationPoints(Graph *G, bool *isArticulation) {
+  LowLink L = lowLink(G);
+  u32 *separated = genArray(L.n); // children whose subtree p separates
+  for (u32 v = 0; v < L.n; v++) {
+    u32 p = L.parents[v];
+    if (p != NO_PARENT && L.low[v] >= L.discovery[p])
+      separated[p]++;
+  }
+  u32 count = 0;
+  for (u32 v = 0; v < L.n; v++) {
+    // A root separates its children only if it has two of them.
+    bool cut = separated[v] > (L.parents[v] == NO_PARENT ? 1 : 0);
+    if (isArticulation != NULL)
+      isArticulation[v] = cut;
+    count += cut;
+  }
+  free(separated);
+  dumpLowLink(&L);
+  return count;
+}
+
+/**
+ * @brief Labels the biconnected components of `G`, the maximal sets of
+ * edges any two of which lie on a common simple cycle, in O(n + m).
+ *
+ * The tree edge into v starts a new component when its parent separates v,
+ * and otherwise shares the component of the tree edge into the parent. A
+ * non-tree edge belongs with the tree edge into its deeper end.
+ *
+ * @param[out] edgeLabels If not NULL, receives the component of each entry
+ * of G->_edges, the same for both entries of an edge; self-loops get
+ * NO_COMPONENT.
+ * @return The number of biconnected components.
+ */
+u32 biconnectedComponents(Graph *G, u32 *edgeLabels) {
+  LowLink L = lowLink(G);
+  u32 *labels = genArray(L.n); // component of the tree edge into each vertex
+  u32 count = 0;
+  for (u32 k = 0; k < L.n; k++) {
+    u32 v = L.preorder[k];
+    u32 p = L.parents[v];
+    if (p == NO_PARENT)
+      labels[v] = NO_COMPONENT;
+    else if (L.low[v] >= L.discovery[p])
+      labels[v] = count++;
+    else
+      labels[v] = labels[p];
+  }
+  for (u32 i = 0; edgeLabels != NULL && i < G->_edgeArraySize; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x == e.y)
+      edgeLabels[i] = NO_COMPONENT;
+    else
+      edgeLabels[i] = labels[L.discovery[e.x] > L.discovery[e.y] ? e.x : e.y];
+  }
+  free(labels);
+  dumpLowLink(&L);
+  return count;
+}
+
+/**
+ * @brief Labels the 2-edge-connected components of `G`, the components left
+ * after removing every bridge, in O(n + m).
+ *
+ * @param[out] labels If not NULL, receives the component of each vertex,
+ * numbered in the order of DFS discovery.
+ * @return The number of 2-edge-connected components.
+ */
+u32 twoEdgeConnectedComponents(Graph *G, u32 *labels) {
+  LowLink L = lowLink(G);
+  u32 *own = labels == NULL ? genArray(L.n) : NULL;
+  if (labels == NULL)
+    labels = own;
+  u32 count = 0;
+  for (u32 k = 0; k < L.n; k++) {
+    u32 v = L.preorder[k];
+    u32 p = L.parents[v];
+    if (p == NO_PARENT || L.low[v] > L.discovery[p])
+      labels[v] = count++;
+    else
+      labels[v] = labels[p];
+  }
+  free(own);
+  dumpLowLink(&L);
+  return count;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Oracle ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Builds a BridgeOracle for `G` in O(n + m). It answers isBridge in
+ * O(1) until `G` changes, and can then be rebuilt in place.
+ */
+BridgeOracle *createBridgeOracle(Graph *G) {
+  BridgeOracle *O = (BridgeOracle *)malloc(sizeof(BridgeOracle));
+  if (O == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  O->n = 0;
+  O->parents = NULL;
+  O->bridge = NULL;
+  rebuildBridgeOracle(O, G);
+  return O;
+}
+
+/**
+ * @brief Recomputes the bridges of `O` for `G`, which may have changed,
+ * even in its number of vertices.
+ */
+void rebuildBridgeOracle(BridgeOracle *O, Graph *G) {
+  LowLink L = lowLink(G);
+  if (L.n != O->n) {
+    free(O->bridge);
+    O->bridge = (bool *)malloc((L.n + 1) * sizeof(bool));
+    if (O->bridge == NULL) {
+      printf("Error: malloc failed\n");
+      exit(1);
+    }
+    O->n = L.n;
+  }
+  O->nBridges = 0;
+  for (u32 v = 0; v < L.n; v++) {
+    u32 p = L.parents[v];
+    O->bridge[v] = p != NO_PARENT && L.low[v] > L.discovery[p];
+    O->nBridges += O->bridge[v];
+  }
+  free(O->parents);
+  O->parents = L.parents;
+  L.parents = NULL;
+  dumpLowLink(&L);
+}
+
+/**
+ * @brief Tells whether the edge {x, y} of the graph `O` was built from is a
+ * bridge, in O(1).
+ */
+bool isBridge(BridgeOracle *O, u32 x, u32 y) {
+  assert(O != NULL && x < O->n && y < O->n);
+  return (O->parents[y] == x && O->bridge[y]) ||
+         (O->parents[x] == y && O->bridge[x]);
+}
+
+void dumpBridgeOracle(BridgeOracle *O) {
+  if (O == NULL)
+    return;
+  free(O->parents);
+  free(O->bridge);
+  free(O);
+}
@@ -0,0 +1,57 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bridges.h
+ * @brief Bridges, articulation points, biconnected and 2-edge-connected
+ * components of undirected graphs, from one low-link depth-first search.
+ */
+
+#ifndef BRIDGES_H
+#define BRIDGES_H
+
+#include "graphStruct.h"
+
+// A snapshot of the bridges of a graph, valid until the graph changes.
+// parents is the DFS forest (NO_PARENT at roots), and bridge[v] tells
+// whether the tree edge from parents[v] to v is a bridge; no other edge can
+// be one.
+typedef struct {
+  u32 n;
+  u32 nBridges;
+  u32 *parents;
+  bool *bridge;
+} BridgeOracle;
+
+u32 findBridges(Graph *G, u32 *bridges);
+u32 articulationPoints(Graph *G, bool *isArticulation);
+u32 biconnectedComponents(Graph *G, u32 *edgeLabels);
+u32 twoEdgeConnectedComponents(Graph *G, u32 *labels);
+BridgeOracle *createBridgeOracle(Graph *G);
+void rebuildBridgeOracle(BridgeOracle *O, Graph *G);
+bool isBridge(BridgeOracle *O, u32 x, u32 y);
+void dumpBridgeOracle(BridgeOracle *O);
+
+#endif
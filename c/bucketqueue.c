@@ -0,0 +1,177 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bucketqueue.c
+ * @brief Radix heap and Dial's bucket queue. Neither compares keys on
+ * insertion: a radix heap moves each node down at most log C times, and a
+ * bucket queue places it directly in its bucket.
+ */
+
+#include "bucketqueue.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Helper function. Appends a node to a bucket, growing it if needed.
+ */
+static void pushNode(NodeBucket *bucket, HeapNode node) {
+  if (bucket->size == bucket->capacity) {
+    bucket->capacity = bucket->capacity == 0 ? 4 : 2 * bucket->capacity;
+    bucket->array = (HeapNode *)realloc(bucket->array,
+                                        bucket->capacity * sizeof(HeapNode));
+    if (bucket->array == NULL) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  bucket->array[bucket->size++] = node;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Radix heap ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+RadixHeap *createRadixHeap() {
+  RadixHeap *heap = (RadixHeap *)calloc(1, sizeof(RadixHeap));
+  if (heap == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  return heap;
+}
+
+void dumpRadixHeap(RadixHeap *heap) {
+  for (u32 i = 0; i < 33; i++)
+    free(heap->buckets[i].array);
+  free(heap);
+}
+
+/**
+ * @brief Helper function. Index of the bucket of `value` relative to `last`.
+ */
+static u32 radixBucket(u32 value, u32 last) {
+  return value == last ? 0 : 32 - __builtin_clz(value ^ last);
+}
+
+/**
+ * @brief Inserts a node. Duplicated labels are allowed, so a decrease-key is
+ * simply a new insertion; stale entries are to be skipped by the caller.
+ *
+ * @pre `value` is not smaller than the last extracted value.
+ */
+void radixInsert(RadixHeap *heap, u32 label, u32 value) {
+  assert(value >= heap->last);
+  pushNode(&heap->buckets[radixBucket(value, heap->last)],
+           (HeapNode){label, value});
+  heap->size++;
+}
+
+/**
+ * @brief Removes and returns a node of minimum value.
+ *
+ * When bucket 0 is empty, the first non-empty bucket is emptied into lower
+ * buckets relative to its minimum, which becomes the new `last`.
+ *
+ * @pre The heap is not empty.
+ */
+HeapNode radixExtractMin(RadixHeap *heap) {
+  assert(heap->size > 0);
+  if (heap->buckets[0].size == 0) {
+    u32 i = 1;
+    while (heap->buckets[i].size == 0)
+      i++;
+    NodeBucket *bucket = &heap->buckets[i];
+    u32 newLast = bucket->array[0].value;
+    for (u32 j = 1; j < bucket->size; j++) {
+      if (bucket->array[j].value < newLast)
+        newLast = bucket->array[j].value;
+    }
+    heap->last = newLast;
+    for (u32 j = 0; j < bucket->size; j++) {
+      HeapNode node = bucket->array[j];
+      pushNode(&heap->buckets[radixBucket(node.value, newLast)], node);
+    }
+    bucket->size = 0;
+  }
+  heap->size--;
+  return heap->buckets[0].array[--heap->buckets[0].size];
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Bucket queue ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Creates a bucket queue for values at most `maxGap` above the last
+ * extracted one (e.g. the maximum edge weight, in Dijkstra's algorithm).
+ */
+BucketQueue *createBucketQueue(u32 maxGap) {
+  BucketQueue *queue = (BucketQueue *)calloc(1, sizeof(BucketQueue));
+  if (queue == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  queue->nBuckets = maxGap + 1;
+  queue->buckets = (NodeBucket *)calloc(queue->nBuckets, sizeof(NodeBucket));
+  if (queue->buckets == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  return queue;
+}
+
+void dumpBucketQueue(BucketQueue *queue) {
+  for (u32 i = 0; i < queue->nBuckets; i++)
+    free(queue->buckets[i].array);
+  free(queue->buckets);
+  free(queue);
+}
+
+/**
+ * @brief Inserts a node. As with the radix heap, duplicated labels are allowed.
+ *
+ * @pre current <= value <= current + maxGap.
+ */
+void bucketInsert(BucketQueue *queue, u32 label, u32 value) {
+  assert(value >= queue->current && value - queue->current < queue->nBuckets);
+  pushNode(&queue->buckets[value % queue->nBuckets], (HeapNode){label, value});
+  queue->size++;
+}
+
+/**
+ * @brief Removes and returns a node of minimum value, scanning the buckets
+ * circularly from the last extracted one.
+ *
+ * @pre The queue is not empty.
+ */
+HeapNode bucketExtractMin(BucketQueue *queue) {
+  assert(queue->size > 0);
+  while (queue->buckets[queue->cursor].size == 0) {
+    queue->cursor = (queue->cursor + 1) % queue->nBuckets;
+  }
+  NodeBucket *bucket = &queue->buckets[queue->cursor];
+  HeapNode node = bucket->array[--bucket->size];
+  queue->current = node.value;
+  queue->size--;
+  return node;
+}
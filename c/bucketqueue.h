@@ -0,0 +1,74 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file bucketqueue.h
+ * @brief Monotone integer priority queues: a radix heap and Dial's bucket
+ * queue. Both require that inserted values are never smaller than the last
+ * extracted one, which holds for Dijkstra's algorithm with non-negative
+ * integer weights.
+ */
+
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include "heap.h"
+
+typedef struct {
+  HeapNode *array;
+  u32 size;
+  u32 capacity;
+} NodeBucket;
+
+// Bucket 0 holds values equal to `last`; bucket i > 0 holds values whose
+// highest bit differing from `last` is bit i - 1.
+typedef struct {
+  NodeBucket buckets[33];
+  u32 last;
+  u32 size;
+} RadixHeap;
+
+// Circular array of maxGap + 1 buckets, where bucket i holds values congruent
+// to i modulo maxGap + 1. Valid as long as every value in the queue is at most
+// maxGap above the last extracted one.
+typedef struct {
+  NodeBucket *buckets;
+  u32 nBuckets;
+  u32 cursor;  // bucket of the last extracted value
+  u32 current; // last extracted value
+  u32 size;
+} BucketQueue;
+
+RadixHeap *createRadixHeap();
+void radixInsert(RadixHeap *heap, u32 label, u32 value);
+HeapNode radixExtractMin(RadixHeap *heap);
+void dumpRadixHeap(RadixHeap *heap);
+
+BucketQueue *createBucketQueue(u32 maxGap);
+void bucketInsert(BucketQueue *queue, u32 label, u32 value);
+HeapNode bucketExtractMin(BucketQueue *queue);
+void dumpBucketQueue(BucketQueue *queue);
+
+#endif
@@ -0,0 +1,965 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file ch.c
+ * @brief Contraction hierarchies (Geisberger et al.).
+ *
+ * Vertices are contracted cheapest first, in rounds of vertices far enough
+ * apart to be contracted at once. Contracting v removes it from the
+ * remaining graph and, for every pair of arcs u -> v -> w, adds a shortcut
+ * u -> w unless a witness search finds a path from u to w avoiding v that
+ * is no longer. The rank of a vertex is its position in
+ * this order. Every shortest path then has a counterpart that climbs in
+ * rank and then descends, so a query runs Dijkstra's algorithm upwards from
+ * both s and t and meets at the top.
+ */
+
+#include "ch.h"
+#include "api.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A witness search gives up after settling this many vertices, in which
+// case the shortcut is added just in case.
+#define CH_WITNESS_LIMIT 500
+
+// Keeps contraction priorities, which may be negative, unsigned.
+#define CH_PRIORITY_BIAS 0x80000000
+
+// Identifies hierarchy files, followed by the format version.
+#define CH_MAGIC 0x48434743 // "CGCH"
+#define CH_VERSION 1
+
+typedef struct {
+  CHArc *arcs;
+  u32 size;
+  u32 capacity;
+} ArcList;
+
+// The graph during contraction. The lists of a contracted vertex are kept
+// as they were, and it is removed from the lists of its neighbours.
+typedef struct {
+  u32 n;
+  ArcList *out;
+  ArcList *in;
+  bool *contracted;
+  u32 *deletedNeighbours;
+} Overlay;
+
+// A shortcut from -> to bypassing `middle`, found while contracting it and
+// added to the overlay once the round is over.
+typedef struct {
+  u32 from;
+  u32 to;
+  u32 weight;
+  u32 middle;
+} Shortcut;
+
+typedef struct {
+  Shortcut *shortcuts;
+  u32 size;
+  u32 capacity;
+} ShortcutList;
+
+// Scratch space for witness searches, one per thread.
+typedef struct {
+  u32 *distances;
+  u32 *touched;
+  u32 nTouched;
+  bool *isTarget; // marks the out-neighbours of the vertex being contracted
+  IndexedHeap *heap;
+} Witness;
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Overlay ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. Appends an arc to L, growing it if needed.
+ */
+static void pushArc(ArcList *L, u32 vertex, u32 weight, u32 middle) {
+  if (L->size == L->capacity) {
+    L->capacity = L->capacity == 0 ? 4 : 2 * L->capacity;
+    L->arcs = (CHArc *)realloc(L->arcs, L->capacity * sizeof(CHArc));
+    if (L->arcs == NULL) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  L->arcs[L->size++] = (CHArc){vertex, weight, middle};
+}
+
+/**
+ * @brief Helper function. Returns the arc of L towards `vertex`, or NULL.
+ */
+static CHArc *findListArc(ArcList *L, u32 vertex) {
+  for (u32 i = 0; i < L->size; i++) {
+    if (L->arcs[i].vertex == vertex)
+      return &L->arcs[i];
+  }
+  return NULL;
+}
+
+/**
+ * @brief Helper function. Removes the arc of L towards `vertex`, if any.
+ */
+static void removeListArc(ArcList *L, u32 vertex) {
+  CHArc *a = findListArc(L, vertex);
+  if (a != NULL)
+    *a = L->arcs[--L->size];
+}
+
+/**
+ * @brief Helper function. Adds the arc u -> w, or lowers the weight of an
+ * existing one, so that there is at most one arc per ordered pair.
+ */
+static void addOverlayArc(Overlay *O, u32 u, u32 w, u32 weight, u32 middle) {
+  CHArc *forward = findListArc(&O->out[u], w);
+  if (forward == NULL) {
+    pushArc(&O->out[u], w, weight, middle);
+    pushArc(&O->in[w], u, weight, middle);
+    return;
+  }
+  if (forward->weight <= weight)
+    return;
+  CHArc *backward = findListArc(&O->in[w], u);
+  forward->weight = backward->weight = weight;
+  forward->middle = backward->middle = middle;
+}
+
+static Overlay *createOverlay(Graph *G) {
+  Overlay *O = (Overlay *)malloc(sizeof(Overlay));
+  if (O == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 n = numberOfVertices(G);
+  O->n = n;
+  O->out = (ArcList *)calloc(n, sizeof(ArcList));
+  O->in = (ArcList *)calloc(n, sizeof(ArcList));
+  O->contracted = (bool *)calloc(n, sizeof(bool));
+  O->deletedNeighbours = (u32 *)calloc(n, sizeof(u32));
+  if (O->out == NULL || O->in == NULL || O->contracted == NULL ||
+      O->deletedNeighbours == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  // Undirected graphs store both directions of every edge already.
+  u32 entries = G->_g_flag & D_FLAG ? G->m : 2 * G->m;
+  for (u32 i = 0; i < entries; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x != e.y)
+      addOverlayArc(O, e.x, e.y, *e.w, CH_NO_MIDDLE);
+  }
+  return O;
+}
+
+static void dumpOverlay(Overlay *O) {
+  for (u32 v = 0; v < O->n; v++) {
+    free(O->out[v].arcs);
+    free(O->in[v].arcs);
+  }
+  free(O->out);
+  free(O->in);
+  free(O->contracted);
+  free(O->deletedNeighbours);
+  free(O);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Witness searches ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static Witness *createWitness(u32 n) {
+  Witness *W = (Witness *)malloc(sizeof(Witness));
+  if (W == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  W->distances = genArray(n);
+  for (u32 i = 0; i < n; i++)
+    W->distances[i] = INT_MAX;
+  W->touched = genArray(n);
+  W->nTouched = 0;
+  W->isTarget = (bool *)calloc(n, sizeof(bool));
+  if (W->isTarget == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  W->heap = createIndexedHeap(n);
+  return W;
+}
+
+static void dumpWitness(Witness *W) {
+  free(W->distances);
+  free(W->touched);
+  free(W->isTarget);
+  dumpIndexedHeap(W->heap);
+  free(W);
+}
+
+/**
+ * @brief Helper function. Computes distances from `source` in the remaining
+ * graph without `skip`, exact up to `maxCost`, into W->distances. Stops
+ * early once the `targets` vertices marked in W->isTarget are settled. Only
+ * the vertices in W->touched are set, so the next search need not reset
+ * all n.
+ */
+static void witnessSearch(Overlay *O, Witness *W, u32 source, u32 skip,
+                          u32 maxCost, u32 targets) {
+  for (u32 i = 0; i < W->nTouched; i++)
+    W->distances[W->touched[i]] = INT_MAX;
+  W->nTouched = 0;
+  clearIndexedHeap(W->heap);
+
+  W->distances[source] = 0;
+  W->touched[W->nTouched++] = source;
+  indexedInsert(W->heap, source, 0);
+  u32 settled = 0;
+  while (W->heap->size > 0 && settled < CH_WITNESS_LIMIT) {
+    HeapNode node = indexedExtractMin(W->heap);
+    if (node.value > maxCost)
+      break;
+    if (W->isTarget[node.label] && --targets == 0)
+      break;
+    settled++;
+    ArcList *L = &O->out[node.label];
+    for (u32 i = 0; i < L->size; i++) {
+      CHArc a = L->arcs[i];
+      if (a.vertex == skip || O->contracted[a.vertex])
+        continue;
+      u32 candidate = node.value + a.weight;
+      if (candidate >= W->distances[a.vertex])
+        continue;
+      if (W->distances[a.vertex] == INT_MAX)
+        W->touched[W->nTouched++] = a.vertex;
+      W->distances[a.vertex] = candidate;
+      if (heapContains(W->heap, a.vertex))
+        decreaseKey(W->heap, a.vertex, candidate);
+      else
+        indexedInsert(W->heap, a.vertex, candidate);
+    }
+  }
+}
+
+/**
+ * @brief Helper function. Appends a shortcut to L, growing it if needed.
+ */
+static void pushShortcut(ShortcutList *L, Shortcut shortcut) {
+  if (L->size == L->capacity) {
+    L->capacity = L->capacity == 0 ? 16 : 2 * L->capacity;
+    L->shortcuts =
+        (Shortcut *)realloc(L->shortcuts, L->capacity * sizeof(Shortcut));
+    if (L->shortcuts == NULL) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  L->shortcuts[L->size++] = shortcut;
+}
+
+/**
+ * @brief Helper function. Counts the shortcuts that contracting `v` needs,
+ * and appends them to `found` unless it is NULL. Only reads the overlay, so
+ * threads may contract different vertices at once.
+ */
+static u32 contractVertex(Overlay *O, Witness *W, u32 v, ShortcutList *found) {
+  ArcList *in = &O->in[v], *out = &O->out[v];
+  u32 maxOut = 0, targets = 0;
+  for (u32 j = 0; j < out->size; j++) {
+    CHArc b = out->arcs[j];
+    if (O->contracted[b.vertex])
+      continue;
+    W->isTarget[b.vertex] = true;
+    targets++;
+    if (b.weight > maxOut)
+      maxOut = b.weight;
+  }
+
+  u32 shortcuts = 0;
+  for (u32 i = 0; i < in->size; i++) {
+    CHArc a = in->arcs[i];
+    if (O->contracted[a.vertex])
+      continue;
+    witnessSearch(O, W, a.vertex, v, a.weight + maxOut, targets);
+    for (u32 j = 0; j < out->size; j++) {
+      CHArc b = out->arcs[j];
+      if (O->contracted[b.vertex] || b.vertex == a.vertex)
+        continue;
+      u32 viaV = a.weight + b.weight;
+      if (W->distances[b.vertex] <= viaV)
+        continue;
+      shortcuts++;
+      if (found != NULL)
+        pushShortcut(found, (Shortcut){a.vertex, b.vertex, viaV, v});
+    }
+  }
+  for (u32 j = 0; j < out->size; j++)
+    W->isTarget[out->arcs[j].vertex] = false;
+  return shortcuts;
+}
+
+/**
+ * @brief Helper function. The contraction priority of `v`: its edge
+ * difference (shortcuts added minus arcs removed) plus its number of
+ * contracted neighbours, which spreads contraction evenly over the graph.
+ */
+static u32 priority(Overlay *O, Witness *W, u32 v) {
+  u32 removed = 0;
+  for (u32 i = 0; i < O->in[v].size; i++)
+    removed += !O->contracted[O->in[v].arcs[i].vertex];
+  for (u32 i = 0; i < O->out[v].size; i++)
+    removed += !O->contracted[O->out[v].arcs[i].vertex];
+  u32 added = contractVertex(O, W, v, NULL);
+  return CH_PRIORITY_BIAS + added + O->deletedNeighbours[v] - removed;
+}
+
+/**
+ * @brief Helper function. Whether `u` comes before `v` in the contraction
+ * order: lower priority first, ties broken by label.
+ */
+static bool precedes(u32 *priorities, u32 u, u32 v) {
+  return priorities[u] < priorities[v] ||
+         (priorities[u] == priorities[v] && u < v);
+}
+
+/**
+ * @brief Helper function. Whether `v` precedes every remaining vertex at
+ * most two arcs away from it, in either direction. Such vertices share no
+ * neighbour, so they can be contracted in the same round.
+ */
+static bool isLocalMinimum(Overlay *O, u32 *priorities, u32 v) {
+  ArcList *lists[2] = {&O->in[v], &O->out[v]};
+  for (u32 l = 0; l < 2; l++) {
+    for (u32 i = 0; i < lists[l]->size; i++) {
+      u32 u = lists[l]->arcs[i].vertex;
+      if (precedes(priorities, u, v))
+        return false;
+      ArcList *next[2] = {&O->in[u], &O->out[u]};
+      for (u32 m = 0; m < 2; m++) {
+        for (u32 j = 0; j < next[m]->size; j++) {
+          u32 x = next[m]->arcs[j].vertex;
+          if (x != v && precedes(priorities, x, v))
+            return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Shared by the tasks of a contraction round. Each task works on the
+// `size` vertices of `vertices`.
+typedef struct {
+  Overlay *O;
+  Witness **witnesses;
+  ShortcutList *found; // one per thread
+  u32 *priorities;
+  bool *selected;
+  u32 *vertices;
+  u32 size;
+} ContractionContext;
+
+/**
+ * @brief Task. Recomputes the priorities of C->vertices.
+ */
+static void updatePriorities(u32 thread, u32 nThreads, void *ctx) {
+  ContractionContext *C = (ContractionContext *)ctx;
+  for (u32 k = thread; k < C->size; k += nThreads) {
+    u32 v = C->vertices[k];
+    C->priorities[v] = priority(C->O, C->witnesses[thread], v);
+  }
+}
+
+/**
+ * @brief Task. Selects the local minima among C->vertices.
+ */
+static void selectVertices(u32 thread, u32 nThreads, void *ctx) {
+  ContractionContext *C = (ContractionContext *)ctx;
+  for (u32 k = thread; k < C->size; k += nThreads) {
+    u32 v = C->vertices[k];
+    C->selected[v] = isLocalMinimum(C->O, C->priorities, v);
+  }
+}
+
+/**
+ * @brief Task. Runs the witness searches of C->vertices, each thread on a
+ * contiguous slice, into the shortcut list of the thread. Concatenating the
+ * lists in thread order gives the same shortcuts in the same order for any
+ * number of threads.
+ */
+static void findShortcuts(u32 thread, u32 nThreads, void *ctx) {
+  ContractionContext *C = (ContractionContext *)ctx;
+  u32 lo = (u64)C->size * thread / nThreads;
+  u32 hi = (u64)C->size * (thread + 1) / nThreads;
+  for (u32 k = lo; k < hi; k++)
+    contractVertex(C->O, C->witnesses[thread], C->vertices[k],
+                   &C->found[thread]);
+}
+
+static void runTask(ThreadPool *pool, PoolTask task, void *ctx) {
+  if (pool == NULL)
+    task(0, 1, ctx);
+  else
+    poolRun(pool, task, ctx);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Preprocessing ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. Packs the arcs of each list whose other endpoint
+ * is ranked higher into a CSR array.
+ */
+static CHArc *packHigherArcs(ArcList *lists, u32 *rank, u32 n, u32 **first) {
+  *first = genArray(n + 1);
+  (*first)[0] = 0;
+  for (u32 v = 0; v < n; v++) {
+    u32 count = 0;
+    for (u32 i = 0; i < lists[v].size; i++)
+      count += rank[lists[v].arcs[i].vertex] > rank[v];
+    (*first)[v + 1] = (*first)[v] + count;
+  }
+  CHArc *arcs = (CHArc *)malloc(((*first)[n] + 1) * sizeof(CHArc));
+  if (arcs == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 k = 0;
+  for (u32 v = 0; v < n; v++) {
+    for (u32 i = 0; i < lists[v].size; i++) {
+      if (rank[lists[v].arcs[i].vertex] > rank[v])
+        arcs[k++] = lists[v].arcs[i];
+    }
+  }
+  return arcs;
+}
+
+/**
+ * @brief Helper function. Removes the contracted vertex `v` from the lists
+ * of its remaining neighbours.
+ */
+static void detachVertex(Overlay *O, u32 v) {
+  for (u32 side = 0; side < 2; side++) {
+    ArcList *L = side == 0 ? &O->out[v] : &O->in[v];
+    for (u32 i = 0; i < L->size; i++) {
+      u32 w = L->arcs[i].vertex;
+      if (O->contracted[w])
+        continue;
+      O->deletedNeighbours[w]++;
+      removeListArc(side == 0 ? &O->in[w] : &O->out[w], v);
+    }
+  }
+}
+
+/**
+ * @brief Helper function. Appends to `check` the remaining vertices at most
+ * two arcs away from `v`, and `v` itself if it remains: those whose
+ * selection may change once `v` is contracted or its priority changes.
+ */
+static void markTwoHops(Overlay *O, u32 v, bool *inCheck, u32 *check,
+                        u32 *nCheck) {
+  if (!O->contracted[v] && !inCheck[v]) {
+    inCheck[v] = true;
+    check[(*nCheck)++] = v;
+  }
+  ArcList *lists[2] = {&O->in[v], &O->out[v]};
+  for (u32 l = 0; l < 2; l++) {
+    for (u32 i = 0; i < lists[l]->size; i++) {
+      u32 u = lists[l]->arcs[i].vertex;
+      if (O->contracted[u])
+        continue;
+      if (!inCheck[u]) {
+        inCheck[u] = true;
+        check[(*nCheck)++] = u;
+      }
+      ArcList *next[2] = {&O->in[u], &O->out[u]};
+      for (u32 m = 0; m < 2; m++) {
+        for (u32 j = 0; j < next[m]->size; j++) {
+          u32 x = next[m]->arcs[j].vertex;
+          if (!O->contracted[x] && !inCheck[x]) {
+            inCheck[x] = true;
+            check[(*nCheck)++] = x;
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Builds the contraction hierarchy of the weighted graph or digraph
+ * `G`.
+ *
+ * Contraction runs in rounds on the threads of `pool`, which may be NULL.
+ * Each round picks the remaining vertices that precede, in order of
+ * priority (see `priority`), all vertices within two arcs of them. Their
+ * priorities are recomputed, and those that did not grow are contracted
+ * together; the others wait for a later round. The witness searches of a
+ * round run in parallel and see its vertices as already gone, so no witness
+ * path relies on a vertex contracted alongside. The shortcuts they find are
+ * merged in a fixed order before the next round, so the hierarchy does not
+ * depend on the number of threads. `G` may be dumped afterwards.
+ *
+ * @return The hierarchy, to be freed with dumpContractionHierarchy.
+ */
+ContractionHierarchy *buildContractionHierarchy(Graph *G, ThreadPool *pool) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  Overlay *O = createOverlay(G);
+
+  u32 nThreads = poolSize(pool);
+  Witness **witnesses = (Witness **)malloc(nThreads * sizeof(Witness *));
+  ShortcutList *found = (ShortcutList *)calloc(nThreads, sizeof(ShortcutList));
+  bool *selected = (bool *)calloc(n + 1, sizeof(bool));
+  if (witnesses == NULL || found == NULL || selected == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  for (u32 i = 0; i < nThreads; i++)
+    witnesses[i] = createWitness(n);
+  // Only the vertices in `check` may have become local minima since the
+  // last round; every other remaining vertex is known not to be one.
+  u32 *check = genArray(n + 1);
+  bool *inCheck = (bool *)calloc(n + 1, sizeof(bool));
+  u32 *batch = genArray(n + 1);
+  u32 *previous = genArray(n + 1);
+  if (inCheck == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  for (u32 v = 0; v < n; v++)
+    check[v] = v;
+  ContractionContext C = {O,        witnesses, found, genArray(n + 1),
+                          selected, check,     n};
+  runTask(pool, updatePriorities, &C);
+
+  u32 *rank = genArray(n);
+  u32 order = 0, nCheck = n;
+  while (order < n) {
+    C.vertices = check;
+    C.size = nCheck;
+    runTask(pool, selectVertices, &C);
+    u32 nBatch = 0;
+    for (u32 k = 0; k < nCheck; k++) {
+      u32 v = check[k];
+      inCheck[v] = false;
+      if (selected[v]) {
+        selected[v] = false;
+        previous[nBatch] = C.priorities[v];
+        batch[nBatch++] = v;
+      }
+    }
+    nCheck = 0;
+
+    // Lazy updates: a candidate whose priority grew since it was last
+    // computed waits for the next round with its new priority.
+    C.vertices = batch;
+    C.size = nBatch;
+    runTask(pool, updatePriorities, &C);
+    u32 kept = 0;
+    for (u32 k = 0; k < nBatch; k++) {
+      u32 v = batch[k];
+      if (C.priorities[v] > previous[k]) {
+        markTwoHops(O, v, inCheck, check, &nCheck);
+        continue;
+      }
+      batch[kept++] = v;
+      O->contracted[v] = true;
+      rank[v] = order++;
+    }
+
+    C.size = kept;
+    runTask(pool, findShortcuts, &C);
+    for (u32 t = 0; t < nThreads; t++) {
+      for (u32 i = 0; i < found[t].size; i++) {
+        Shortcut sc = found[t].shortcuts[i];
+        addOverlayArc(O, sc.from, sc.to, sc.weight, sc.middle);
+      }
+      found[t].size = 0;
+    }
+    for (u32 k = 0; k < kept; k++)
+      detachVertex(O, batch[k]);
+    for (u32 k = 0; k < kept; k++)
+      markTwoHops(O, batch[k], inCheck, check, &nCheck);
+  }
+
+  ContractionHierarchy *H =
+      (ContractionHierarchy *)malloc(sizeof(ContractionHierarchy));
+  if (H == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  H->n = n;
+  H->rank = rank;
+  H->up = packHigherArcs(O->out, rank, n, &H->upFirst);
+  H->down = packHigherArcs(O->in, rank, n, &H->downFirst);
+
+  for (u32 i = 0; i < nThreads; i++) {
+    dumpWitness(witnesses[i]);
+    free(found[i].shortcuts);
+  }
+  free(witnesses);
+  free(found);
+  free(selected);
+  free(check);
+  free(inCheck);
+  free(batch);
+  free(previous);
+  free(C.priorities);
+  dumpOverlay(O);
+  return H;
+}
+
+void dumpContractionHierarchy(ContractionHierarchy *H) {
+  if (H == NULL)
+    return;
+  free(H->rank);
+  free(H->upFirst);
+  free(H->up);
+  free(H->downFirst);
+  free(H->down);
+  free(H);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Queries ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Allocates the scratch space for queries on `H`. Each query only
+ * resets the vertices the previous one touched, so it costs O(1) to start.
+ */
+CHQuery *createCHQuery(ContractionHierarchy *H) {
+  assert(H != NULL);
+  CHQuery *Q = (CHQuery *)malloc(sizeof(CHQuery));
+  if (Q == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  Q->H = H;
+  for (u32 side = 0; side < 2; side++) {
+    Q->distances[side] = genArray(H->n);
+    for (u32 i = 0; i < H->n; i++)
+      Q->distances[side][i] = INT_MAX;
+    Q->parents[side] = genArray(H->n);
+    Q->parentArcs[side] = genArray(H->n);
+    Q->heaps[side] = createIndexedHeap(H->n);
+  }
+  Q->touched = genArray(2 * H->n);
+  Q->nTouched = 0;
+  Q->settled = 0;
+  Q->path = Q->stack = NULL;
+  Q->pathLength = Q->pathCapacity = Q->stackCapacity = 0;
+  return Q;
+}
+
+void dumpCHQuery(CHQuery *Q) {
+  if (Q == NULL)
+    return;
+  for (u32 side = 0; side < 2; side++) {
+    free(Q->distances[side]);
+    free(Q->parents[side]);
+    free(Q->parentArcs[side]);
+    dumpIndexedHeap(Q->heaps[side]);
+  }
+  free(Q->touched);
+  free(Q->path);
+  free(Q->stack);
+  free(Q);
+}
+
+/**
+ * @brief Helper function. Runs the upward searches from `s` (forward) and
+ * `t` (backward), each until its smallest key reaches the best distance
+ * found, and returns the vertex where the searches meet, or CH_NO_MIDDLE.
+ */
+static u32 chSearch(CHQuery *Q, u32 s, u32 t, u32 *best) {
+  ContractionHierarchy *H = Q->H;
+  assert(s < H->n && t < H->n);
+  for (u32 i = 0; i < Q->nTouched; i++) {
+    Q->distances[0][Q->touched[i]] = INT_MAX;
+    Q->distances[1][Q->touched[i]] = INT_MAX;
+  }
+  Q->nTouched = 0;
+  Q->settled = 0;
+
+  u32 roots[2] = {s, t};
+  u32 *first[2] = {H->upFirst, H->downFirst};
+  CHArc *arcs[2] = {H->up, H->down};
+  for (u32 side = 0; side < 2; side++) {
+    clearIndexedHeap(Q->heaps[side]);
+    Q->distances[side][roots[side]] = 0;
+    Q->touched[Q->nTouched++] = roots[side];
+    indexedInsert(Q->heaps[side], roots[side], 0);
+  }
+
+  *best = INT_MAX;
+  u32 meet = CH_NO_MIDDLE;
+  while (Q->heaps[0]->size > 0 || Q->heaps[1]->size > 0) {
+    u32 side = Q->heaps[1]->size == 0 ||
+                       (Q->heaps[0]->size > 0 &&
+                        Q->heaps[0]->array[0].value <=
+                            Q->heaps[1]->array[0].value)
+                   ? 0
+                   : 1;
+    IndexedHeap *heap = Q->heaps[side];
+    if (heap->array[0].value >= *best) {
+      clearIndexedHeap(heap);
+      continue;
+    }
+    HeapNode node = indexedExtractMin(heap);
+    u32 v = node.label;
+    Q->settled++;
+    u32 other = Q->distances[1 - side][v];
+    if (other != INT_MAX && node.value + other < *best) {
+      *best = node.value + other;
+      meet = v;
+    }
+
+    u32 *distances = Q->distances[side];
+    for (u32 k = first[side][v]; k < first[side][v + 1]; k++) {
+      CHArc a = arcs[side][k];
+      u32 candidate = node.value + a.weight;
+      if (candidate >= distances[a.vertex])
+        continue;
+      if (Q->distances[0][a.vertex] == INT_MAX &&
+          Q->distances[1][a.vertex] == INT_MAX)
+        Q->touched[Q->nTouched++] = a.vertex;
+      distances[a.vertex] = candidate;
+      Q->parents[side][a.vertex] = v;
+      Q->parentArcs[side][a.vertex] = k;
+      if (heapContains(heap, a.vertex))
+        decreaseKey(heap, a.vertex, candidate);
+      else
+        indexedInsert(heap, a.vertex, candidate);
+    }
+  }
+  return meet;
+}
+
+/**
+ * @brief Computes the distance from `s` to `t`, or INT_MAX if `t` is
+ * unreachable. Q->settled is the number of vertices settled.
+ */
+u32 chDistance(CHQuery *Q, u32 s, u32 t) {
+  assert(Q != NULL);
+  u32 best;
+  chSearch(Q, s, t, &best);
+  return best;
+}
+
+/**
+ * @brief Helper function. Returns the middle of the arc a -> b, which is
+ * stored at its lower ranked endpoint.
+ */
+static u32 arcMiddle(ContractionHierarchy *H, u32 a, u32 b) {
+  bool upward = H->rank[a] < H->rank[b];
+  u32 low = upward ? a : b, high = upward ? b : a;
+  u32 *first = upward ? H->upFirst : H->downFirst;
+  CHArc *arcs = upward ? H->up : H->down;
+  for (u32 k = first[low]; k < first[low + 1]; k++) {
+    if (arcs[k].vertex == high)
+      return arcs[k].middle;
+  }
+  assert(false);
+  return CH_NO_MIDDLE;
+}
+
+/**
+ * @brief Helper function. Grows `words` to hold at least `size` integers,
+ * doubling its capacity.
+ */
+static u32 *reserveWords(u32 *words, u32 *capacity, u32 size) {
+  if (size <= *capacity)
+    return words;
+  while (*capacity < size)
+    *capacity = *capacity == 0 ? 64 : 2 * *capacity;
+  words = (u32 *)realloc(words, *capacity * sizeof(u32));
+  if (words == NULL) {
+    printf("Error: realloc failed\n");
+    exit(1);
+  }
+  return words;
+}
+
+/**
+ * @brief Helper function. Pushes the arc a -> b with the given middle onto
+ * the stack of arcs to unpack, which holds `size` integers.
+ */
+static void pushPackedArc(CHQuery *Q, u32 *size, u32 a, u32 b, u32 middle) {
+  Q->stack = reserveWords(Q->stack, &Q->stackCapacity, *size + 3);
+  Q->stack[(*size)++] = a;
+  Q->stack[(*size)++] = b;
+  Q->stack[(*size)++] = middle;
+}
+
+/**
+ * @brief Helper function. Unpacks the arcs on the stack, the top one first,
+ * appending to Q->path the vertices of the original path they stand for,
+ * each arc's tail excluded.
+ */
+static void unpackArcs(CHQuery *Q, u32 size) {
+  ContractionHierarchy *H = Q->H;
+  while (size > 0) {
+    u32 middle = Q->stack[--size];
+    u32 b = Q->stack[--size];
+    u32 a = Q->stack[--size];
+    if (middle == CH_NO_MIDDLE) {
+      Q->path = reserveWords(Q->path, &Q->pathCapacity, Q->pathLength + 1);
+      Q->path[Q->pathLength++] = b;
+      continue;
+    }
+    pushPackedArc(Q, &size, middle, b, arcMiddle(H, middle, b));
+    pushPackedArc(Q, &size, a, middle, arcMiddle(H, a, middle));
+  }
+}
+
+/**
+ * @brief Computes a shortest path from `s` to `t`, with every shortcut
+ * unpacked into the original vertices it bypasses. The path is unpacked in
+ * the buffers of Q, so a query allocates only the returned path, sized to
+ * its length.
+ *
+ * @return The path, to be freed with dumpPath.
+ */
+Path *chShortestPath(CHQuery *Q, u32 s, u32 t) {
+  assert(Q != NULL);
+  ContractionHierarchy *H = Q->H;
+  u32 best;
+  u32 meet = chSearch(Q, s, t, &best);
+  Path *P = emptyPath();
+  P->settled = Q->settled;
+  if (meet == CH_NO_MIDDLE)
+    return P;
+
+  Q->path = reserveWords(Q->path, &Q->pathCapacity, 1);
+  Q->path[0] = s;
+  Q->pathLength = 1;
+  // The upward arcs from s to meet are found backwards, from meet. Pushed
+  // in that order, the first arc ends on top of the stack.
+  u32 size = 0;
+  for (u32 v = meet; v != s; v = Q->parents[0][v]) {
+    CHArc a = H->up[Q->parentArcs[0][v]];
+    pushPackedArc(Q, &size, Q->parents[0][v], v, a.middle);
+  }
+  unpackArcs(Q, size);
+  // The downward arcs from meet to t, in order.
+  for (u32 v = meet; v != t; v = Q->parents[1][v]) {
+    CHArc a = H->down[Q->parentArcs[1][v]];
+    size = 0;
+    pushPackedArc(Q, &size, v, Q->parents[1][v], a.middle);
+    unpackArcs(Q, size);
+  }
+
+  P->distance = best;
+  P->length = Q->pathLength;
+  P->vertices = genArray(P->length);
+  memcpy(P->vertices, Q->path, P->length * sizeof(u32));
+  return P;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Save and load ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. Writes `count` integers to `f`, exiting on error.
+ */
+static void writeWords(FILE *f, void *words, u64 count) {
+  if (fwrite(words, sizeof(u32), count, f) != count) {
+    printf("Error writing file!\n");
+    exit(1);
+  }
+}
+
+/**
+ * @brief Helper function. Reads `count` integers from `f`, exiting on error.
+ */
+static void readWords(FILE *f, void *words, u64 count) {
+  if (fread(words, sizeof(u32), count, f) != count) {
+    printf("Error: truncated hierarchy file\n");
+    exit(1);
+  }
+}
+
+/**
+ * @brief Writes the hierarchy to a binary file: a header (magic, version,
+ * n, number of up and down arcs), the ranks and both CSR arrays, in native
+ * byte order.
+ */
+void writeContractionHierarchy(ContractionHierarchy *H, char *fname) {
+  assert(H != NULL);
+  FILE *f = fopen(fname, "wb");
+  if (f == NULL) {
+    printf("Error opening file!\n");
+    exit(1);
+  }
+  u32 n = H->n;
+  u32 header[5] = {CH_MAGIC, CH_VERSION, n, H->upFirst[n], H->downFirst[n]};
+  writeWords(f, header, 5);
+  writeWords(f, H->rank, n);
+  writeWords(f, H->upFirst, n + 1);
+  writeWords(f, H->up, 3 * (u64)H->upFirst[n]);
+  writeWords(f, H->downFirst, n + 1);
+  writeWords(f, H->down, 3 * (u64)H->downFirst[n]);
+  fclose(f);
+}
+
+/**
+ * @brief Reads a hierarchy written by writeContractionHierarchy.
+ */
+ContractionHierarchy *readContractionHierarchy(char *fname) {
+  FILE *f = fopen(fname, "rb");
+  if (f == NULL) {
+    printf("Error opening file!\n");
+    exit(1);
+  }
+  u32 header[5];
+  readWords(f, header, 5);
+  if (header[0] != CH_MAGIC || header[1] != CH_VERSION) {
+    printf("Error: %s is not a contraction hierarchy file\n", fname);
+    exit(1);
+  }
+  ContractionHierarchy *H =
+      (ContractionHierarchy *)malloc(sizeof(ContractionHierarchy));
+  CHArc *up = (CHArc *)malloc((header[3] + 1) * sizeof(CHArc));
+  CHArc *down = (CHArc *)malloc((header[4] + 1) * sizeof(CHArc));
+  if (H == NULL || up == NULL || down == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 n = H->n = header[2];
+  H->rank = genArray(n);
+  H->upFirst = genArray(n + 1);
+  H->downFirst = genArray(n + 1);
+  H->up = up;
+  H->down = down;
+  readWords(f, H->rank, n);
+  readWords(f, H->upFirst, n + 1);
+  readWords(f, H->up, 3 * (u64)header[3]);
+  readWords(f, H->downFirst, n + 1);
+  readWords(f, H->down, 3 * (u64)header[4]);
+  fclose(f);
+  return H;
+}
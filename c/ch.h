@@ -0,0 +1,91 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file ch.h
+ * @brief Contraction hierarchies: a one-off preprocessing of a static
+ * weighted graph after which shortest path queries settle only a few
+ * hundred vertices.
+ */
+
+#ifndef CH_H
+#define CH_H
+
+#include "dijkstra.h"
+#include "heap.h"
+#include "threadpool.h"
+
+// Marks an arc of the original graph, which bypasses no vertex.
+#define CH_NO_MIDDLE 0xFFFFFFFF
+
+// An arc of the hierarchy, stored at one of its endpoints. A shortcut
+// replaces the two arcs through the vertex `middle`, contracted before both
+// of its endpoints.
+typedef struct {
+  u32 vertex; // the other endpoint
+  u32 weight;
+  u32 middle;
+} CHArc;
+
+// The arcs u -> v with rank[v] > rank[u] are up[k] for upFirst[u] <= k <
+// upFirst[u + 1], with vertex = v. The arcs u -> v with rank[u] > rank[v]
+// are down[k] for downFirst[v] <= k < downFirst[v + 1], with vertex = u.
+typedef struct {
+  u32 n;
+  u32 *rank; // contraction order
+  u32 *upFirst;
+  CHArc *up;
+  u32 *downFirst;
+  CHArc *down;
+} ContractionHierarchy;
+
+// Scratch space for the queries on one hierarchy; one per querying thread.
+typedef struct {
+  ContractionHierarchy *H;
+  u32 *distances[2]; // forward (from s, on up) and backward (to t, on down)
+  u32 *parents[2];
+  u32 *parentArcs[2]; // index in up (forward) or down (backward)
+  u32 *touched;
+  u32 nTouched;
+  IndexedHeap *heaps[2];
+  u32 settled; // vertices settled by the last query
+  // Grown on demand by chShortestPath, and kept for the next query.
+  u32 *path; // the unpacked path
+  u32 pathLength;
+  u32 pathCapacity;
+  u32 *stack; // arcs still to unpack, as triples (a, b, middle)
+  u32 stackCapacity;
+} CHQuery;
+
+ContractionHierarchy *buildContractionHierarchy(Graph *G, ThreadPool *pool);
+CHQuery *createCHQuery(ContractionHierarchy *H);
+u32 chDistance(CHQuery *Q, u32 s, u32 t);
+Path *chShortestPath(CHQuery *Q, u32 s, u32 t);
+void writeContractionHierarchy(ContractionHierarchy *H, char *fname);
+ContractionHierarchy *readContractionHierarchy(char *fname);
+void dumpCHQuery(CHQuery *Q);
+void dumpContractionHierarchy(ContractionHierarchy *H);
+
+#endif
@@ -0,0 +1,333 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file components.c
+ * @brief Connected components, sequentially by BFS and in parallel with
+ * Afforest (Sutton, Ben-Nun and Barak).
+ *
+ * Both versions number the components 0, 1, ... in the order of their
+ * smallest vertex, so they produce the same labels.
+ *
+ * Afforest hooks roots together through a concurrent union-find, which
+ * always hangs the larger root below the smaller. It first links each
+ * vertex to a few of its neighbours, which is usually enough to gather most
+ * of a large component under one root. That root is then found by sampling,
+ * and only vertices outside its component go through their remaining
+ * edges, so the bulk of the edges of the largest component is never read.
+ */
+
+#include "components.h"
+#include "api.h"
+#include "diapi.h"
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Labels the connected components of `G`, or the weakly connected
+ * components of a digraph, by BFS in O(n + m).
+ *
+ * @param[out] labels If not NULL, receives the component of each vertex, in
+ * [0, count), numbered in the order of their smallest vertex.
+ * @return The number of components, count.
+ */
+u32 connectedComponents(Graph *G, u32 *labels) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  u32 *own = labels == NULL ? genArray(n) : NULL;
+  if (labels == NULL)
+    labels = own;
+  ReverseIndex *R = G->_g_flag & D_FLAG ? buildReverseIndex(G) : NULL;
+  for (u32 v = 0; v < n; v++)
+    labels[v] = NO_COMPONENT;
+
+  u32 *queue = genArray(n);
+  u32 count = 0;
+  for (u32 s = 0; s < n; s++) {
+    if (labels[s] != NO_COMPONENT)
+      continue;
+    u32 head = 0, tail = 0;
+    labels[s] = count;
+    queue[tail++] = s;
+    while (head < tail) {
+      u32 v = queue[head++];
+      u32 first = firstNeighbourIndex(G, v);
+      u32 last = first + degree(v, G);
+      for (u32 i = first; i < last; i++) {
+        u32 w = (G->_edges)[i].y;
+        if (labels[w] == NO_COMPONENT) {
+          labels[w] = count;
+          queue[tail++] = w;
+        }
+      }
+      if (R == NULL)
+        continue;
+      for (u32 k = R->first[v]; k < R->first[v + 1]; k++) {
+        u32 w = (G->_edges)[R->edges[k]].x;
+        if (labels[w] == NO_COMPONENT) {
+          labels[w] = count;
+          queue[tail++] = w;
+        }
+      }
+    }
+    count++;
+  }
+
+  free(queue);
+  free(own);
+  dumpReverseIndex(R);
+  return count;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Afforest ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Number of vertices a thread claims at a time in the final linking pass.
+#define AFFOREST_CHUNK 256
+
+typedef struct {
+  Graph *G;
+  ReverseIndex *R; // in-edges, for digraphs only
+  ThreadPool *pool;
+  UnionFind *U;
+  u32 largest; // root of the most frequent component among the samples
+  u32 cursor;  // next unclaimed vertex of the final linking pass
+} AfforestContext;
+
+static void afforestBarrier(AfforestContext *C) {
+  if (C->pool != NULL)
+    poolBarrier(C->pool);
+}
+
+/**
+ * @brief Helper function. Points every vertex of [lo, hi) straight at its
+ * root.
+ */
+static void compress(UnionFind *U, u32 lo, u32 hi) {
+  for (u32 v = lo; v < hi; v++)
+    __atomic_store_n(&U->parent[v], concurrentFindSet(U, v), __ATOMIC_RELAXED);
+}
+
+static int compareU32(const void *a, const void *b) {
+  u32 x = *(const u32 *)a, y = *(const u32 *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Helper function. Finds the most frequent root among
+ * AFFOREST_SAMPLES pseudo-random vertices.
+ */
+static u32 sampleLargest(UnionFind *U) {
+  u32 samples[AFFOREST_SAMPLES];
+  u32 state = 2463534242u;
+  for (u32 k = 0; k < AFFOREST_SAMPLES; k++) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    samples[k] = U->parent[state % U->n];
+  }
+  qsort(samples, AFFOREST_SAMPLES, sizeof(u32), compareU32);
+  u32 best = samples[0], bestRun = 0, run = 0;
+  for (u32 k = 0; k < AFFOREST_SAMPLES; k++) {
+    run = k > 0 && samples[k] == samples[k - 1] ? run + 1 : 1;
+    if (run > bestRun) {
+      bestRun = run;
+      best = samples[k];
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Task. Links sampled neighbours, finds the largest component, then
+ * links the remaining edges of the vertices outside it.
+ */
+static void afforestTask(u32 thread, u32 nThreads, void *ctx) {
+  AfforestContext *C = (AfforestContext *)ctx;
+  Graph *G = C->G;
+  UnionFind *U = C->U;
+  u32 n = numberOfVertices(G);
+  u32 lo = (u64)n * thread / nThreads;
+  u32 hi = (u64)n * (thread + 1) / nThreads;
+
+  for (u32 r = 0; r < AFFOREST_ROUNDS; r++) {
+    for (u32 v = lo; v < hi; v++) {
+      if (degree(v, G) > r)
+        concurrentUnionSets(U, v, neighbour(r, v, G));
+    }
+    afforestBarrier(C);
+    compress(U, lo, hi);
+    afforestBarrier(C);
+  }
+
+  if (thread == 0)
+    C->largest = sampleLargest(U);
+  afforestBarrier(C);
+
+  // An edge with an end outside the largest component is linked from that
+  // end; digraphs need the in-edges to see edges from the largest component.
+  while (true) {
+    u32 start = __atomic_fetch_add(&C->cursor, AFFOREST_CHUNK, __ATOMIC_RELAXED);
+    if (start >= n)
+      break;
+    u32 end = min(start + AFFOREST_CHUNK, n);
+    for (u32 v = start; v < end; v++) {
+      if (concurrentFindSet(U, v) == C->largest)
+        continue;
+      u32 first = firstNeighbourIndex(G, v);
+      u32 last = first + degree(v, G);
+      for (u32 i = first + AFFOREST_ROUNDS; i < last; i++)
+        concurrentUnionSets(U, v, (G->_edges)[i].y);
+      if (C->R == NULL)
+        continue;
+      for (u32 k = C->R->first[v]; k < C->R->first[v + 1]; k++)
+        concurrentUnionSets(U, v, (G->_edges)[C->R->edges[k]].x);
+    }
+  }
+  afforestBarrier(C);
+  compress(U, lo, hi);
+}
+
+/**
+ * @brief As connectedComponents, with Afforest on the threads of `pool`
+ * (NULL runs on the calling thread). The labels are the same.
+ */
+u32 parallelConnectedComponents(Graph *G, u32 *labels, ThreadPool *pool) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  if (n == 0)
+    return 0;
+  AfforestContext C = {G, NULL, pool, createUnionFind(n), 0, 0};
+  if (G->_g_flag & D_FLAG)
+    C.R = buildReverseIndex(G);
+  if (pool == NULL)
+    afforestTask(0, 1, &C);
+  else
+    poolRun(pool, afforestTask, &C);
+
+  // Roots are the smallest vertices of their components, so each root is
+  // labelled before the rest of its component.
+  u32 count = C.U->sets;
+  if (labels != NULL) {
+    u32 next = 0;
+    for (u32 v = 0; v < n; v++)
+      labels[v] = C.U->parent[v] == v ? next++ : labels[C.U->parent[v]];
+    assert(next == count);
+  }
+  dumpUnionFind(C.U);
+  dumpReverseIndex(C.R);
+  return count;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Counts the vertices of each of the `count` components of
+ * `labels`.
+ *
+ * @return An array of `count` sizes, to be freed by the caller.
+ */
+u32 *componentSizes(u32 *labels, u32 n, u32 count) {
+  assert(labels != NULL || n == 0);
+  u32 *sizes = genArray(count);
+  for (u32 v = 0; v < n; v++) {
+    assert(labels[v] < count);
+    sizes[labels[v]]++;
+  }
+  return sizes;
+}
+
+/**
+ * @brief Builds the subgraph of `G` induced by the vertices labelled
+ * `label`, with the same flags, weights and capacities. Vertices keep their
+ * relative order.
+ *
+ * @param[out] vertices If not NULL, receives the vertex of `G` behind each
+ * vertex of the subgraph; it must hold as many entries as the component.
+ * @return The subgraph, to be freed with dumpGraph.
+ */
+Graph *componentSubgraph(Graph *G, u32 *labels, u32 label, u32 *vertices) {
+  assert(G != NULL && labels != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  bool directed = G->_g_flag & D_FLAG;
+  u32 *index = genArray(n);
+  u32 size = 0;
+  u64 entries = 0;
+  for (u32 v = 0; v < n; v++) {
+    if (labels[v] != label)
+      continue;
+    if (vertices != NULL)
+      vertices[size] = v;
+    index[v] = size++;
+    entries += degree(v, G);
+  }
+
+  // An undirected edge has two entries, a self-loop included; keep the one
+  // with x < y, and every other self-loop entry.
+  Graph *H = initGraph(size, directed ? entries : entries / 2, G->_g_flag);
+  u32 i = 0;
+  bool keepLoop = false;
+  for (u32 v = 0; v < n; v++) {
+    if (labels[v] != label)
+      continue;
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 j = first; j < last; j++) {
+      Edge e = (G->_edges)[j];
+      if (!directed && e.y < v)
+        continue;
+      if (!directed && e.y == v && !(keepLoop = !keepLoop))
+        continue;
+      setEdge(H, i++, index[v], index[e.y], e.w, e.c);
+    }
+  }
+  assert(i == numberOfEdges(H));
+  formatEdges(H);
+  free(index);
+  return H;
+}
+
+/**
+ * @brief Builds the subgraph induced by the largest of the `count`
+ * components of `labels`, the one with the smallest label among ties.
+ *
+ * @param[out] vertices As in componentSubgraph.
+ */
+Graph *largestComponent(Graph *G, u32 *labels, u32 count, u32 *vertices) {
+  assert(count > 0);
+  u32 *sizes = componentSizes(labels, numberOfVertices(G), count);
+  u32 largest = 0;
+  for (u32 c = 1; c < count; c++) {
+    if (sizes[c] > sizes[largest])
+      largest = c;
+  }
+  free(sizes);
+  return componentSubgraph(G, labels, largest, vertices);
+}
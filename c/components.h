@@ -0,0 +1,52 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file components.h
+ * @brief Connected components: labels, sizes and the largest component.
+ * Digraphs get their weakly connected components.
+ */
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "graphStruct.h"
+#include "threadpool.h"
+
+// Label of a vertex not yet assigned to a component.
+#define NO_COMPONENT 0xFFFFFFFF
+
+// Afforest links every vertex to its first AFFOREST_ROUNDS neighbours
+// before looking for the largest component among AFFOREST_SAMPLES vertices.
+#define AFFOREST_ROUNDS 2
+#define AFFOREST_SAMPLES 1024
+
+u32 connectedComponents(Graph *G, u32 *labels);
+u32 parallelConnectedComponents(Graph *G, u32 *labels, ThreadPool *pool);
+u32 *componentSizes(u32 *labels, u32 n, u32 count);
+Graph *componentSubgraph(Graph *G, u32 *labels, u32 label, u32 *vertices);
+Graph *largestComponent(Graph *G, u32 *labels, u32 count, u32 *vertices);
+
+#endif
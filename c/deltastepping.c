@@ -0,0 +1,303 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file deltastepping.c
+ * @brief Meyer and Sanders' delta-stepping algorithm.
+ *
+ * Tentative distances are kept in buckets of width Δ. The lowest non-empty
+ * bucket is repeatedly emptied by relaxing the light edges (weight <= Δ) of
+ * its vertices in parallel, which may refill it; once it stays empty, the
+ * heavy edges of every vertex removed from it are relaxed, also in parallel.
+ * Distances are lowered with an atomic compare-and-swap minimum, and each
+ * thread keeps its own buckets, so threads only synchronise between phases.
+ */
+
+#include "deltastepping.h"
+#include "api.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of frontier vertices a thread claims at a time.
+#define DELTA_CHUNK 64
+
+typedef struct {
+  u32 *array;
+  u32 size;
+  u32 capacity;
+} VertexList;
+
+typedef struct {
+  VertexList *buckets; // buckets[i] holds vertices with distance in
+                       // [iΔ, (i + 1)Δ), possibly stale or duplicated
+  u32 nBuckets;
+  VertexList removed; // vertices removed from the current bucket
+} LocalBuckets;
+
+typedef struct {
+  Graph *G;
+  ThreadPool *pool;
+  u32 delta;
+  u32 *distances;
+  u32 *removedFrom; // removedFrom[v] = b + 1 iff v was removed from bucket b
+  LocalBuckets *local;
+  u32 bucket;
+  u32 *frontier;
+  u32 frontierCapacity;
+  u32 *offsets; // offsets[t]: where thread t copies its part of the frontier
+  u32 cursor;   // next unclaimed frontier position
+} DeltaContext;
+
+static void pushVertex(VertexList *list, u32 v) {
+  if (list->size == list->capacity) {
+    list->capacity = list->capacity == 0 ? 16 : 2 * list->capacity;
+    list->array = (u32 *)realloc(list->array, list->capacity * sizeof(u32));
+    if (list->array == NULL) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  list->array[list->size++] = v;
+}
+
+/**
+ * @brief Helper function. Lowers distances[v] to `candidate` atomically.
+ *
+ * @return `true` iff this call lowered the distance.
+ */
+static bool atomicMin(u32 *distances, u32 v, u32 candidate) {
+  u32 current = __atomic_load_n(&distances[v], __ATOMIC_RELAXED);
+  while (candidate < current) {
+    if (__atomic_compare_exchange_n(&distances[v], &current, candidate, true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Helper function. Relaxes the light (or heavy) edges of `v`, placing
+ * every improved vertex in a bucket of thread `t`.
+ */
+static void relaxEdges(DeltaContext *C, u32 t, u32 v, bool light) {
+  Graph *G = C->G;
+  u32 d = __atomic_load_n(&C->distances[v], __ATOMIC_RELAXED);
+  u32 first = firstNeighbourIndex(G, v);
+  u32 last = first + degree(v, G);
+  for (u32 i = first; i < last; i++) {
+    Edge e = (G->_edges)[i];
+    u32 w = *(e.w);
+    if ((w <= C->delta) != light)
+      continue;
+    u32 candidate = d + w;
+    if (!atomicMin(C->distances, e.y, candidate))
+      continue;
+
+    LocalBuckets *L = &C->local[t];
+    u32 b = candidate / C->delta;
+    if (b >= L->nBuckets) {
+      u32 nBuckets = max(2 * L->nBuckets, b + 1);
+      L->buckets =
+          (VertexList *)realloc(L->buckets, nBuckets * sizeof(VertexList));
+      if (L->buckets == NULL) {
+        printf("Error: realloc failed\n");
+        exit(1);
+      }
+      memset(&L->buckets[L->nBuckets], 0,
+             (nBuckets - L->nBuckets) * sizeof(VertexList));
+      L->nBuckets = nBuckets;
+    }
+    pushVertex(&L->buckets[b], e.y);
+  }
+}
+
+/**
+ * @brief Task. Gathers the current bucket of every thread into the shared
+ * frontier, then relaxes the light edges of the frontier, claiming it in
+ * chunks so that work is balanced among threads.
+ */
+static void lightPhase(u32 t, u32 nThreads, void *ctx) {
+  (void)nThreads;
+  DeltaContext *C = (DeltaContext *)ctx;
+  LocalBuckets *L = &C->local[t];
+  u32 b = C->bucket;
+
+  if (b < L->nBuckets) {
+    VertexList *mine = &L->buckets[b];
+    if (mine->size > 0)
+      memcpy(&C->frontier[C->offsets[t]], mine->array,
+             mine->size * sizeof(u32));
+    mine->size = 0;
+  }
+  if (C->pool != NULL)
+    poolBarrier(C->pool);
+
+  u32 size = C->offsets[poolSize(C->pool)];
+  while (true) {
+    u32 start = __atomic_fetch_add(&C->cursor, DELTA_CHUNK, __ATOMIC_RELAXED);
+    if (start >= size)
+      break;
+    u32 end = min(start + DELTA_CHUNK, size);
+    for (u32 k = start; k < end; k++) {
+      u32 v = C->frontier[k];
+      if (__atomic_load_n(&C->distances[v], __ATOMIC_RELAXED) / C->delta != b)
+        continue; // stale entry: v has moved to a lower bucket
+      if (__atomic_exchange_n(&C->removedFrom[v], b + 1, __ATOMIC_RELAXED) !=
+          b + 1)
+        pushVertex(&L->removed, v);
+      relaxEdges(C, t, v, true);
+    }
+  }
+}
+
+/**
+ * @brief Task. Relaxes the heavy edges of the vertices this thread removed
+ * from the current bucket.
+ */
+static void heavyPhase(u32 t, u32 nThreads, void *ctx) {
+  (void)nThreads;
+  DeltaContext *C = (DeltaContext *)ctx;
+  LocalBuckets *L = &C->local[t];
+  for (u32 k = 0; k < L->removed.size; k++)
+    relaxEdges(C, t, L->removed.array[k], false);
+  L->removed.size = 0;
+}
+
+static void runPhase(DeltaContext *C, PoolTask task) {
+  if (C->pool == NULL)
+    task(0, 1, C);
+  else
+    poolRun(C->pool, task, C);
+}
+
+/**
+ * @brief Helper function. Computes where each thread copies its part of the
+ * current bucket and returns the size of the whole bucket.
+ */
+static u32 prepareFrontier(DeltaContext *C, u32 nThreads) {
+  C->offsets[0] = 0;
+  for (u32 t = 0; t < nThreads; t++) {
+    LocalBuckets *L = &C->local[t];
+    u32 size = C->bucket < L->nBuckets ? L->buckets[C->bucket].size : 0;
+    C->offsets[t + 1] = C->offsets[t] + size;
+  }
+  u32 size = C->offsets[nThreads];
+  if (size > C->frontierCapacity) {
+    C->frontierCapacity = max(size, 2 * C->frontierCapacity);
+    free(C->frontier);
+    C->frontier = genArray(C->frontierCapacity);
+  }
+  C->cursor = 0;
+  return size;
+}
+
+/**
+ * @brief Bucket width chosen from the graph: the maximum weight divided by
+ * the average degree, so that a vertex has about one light edge reaching
+ * into its own bucket.
+ */
+u32 deltaSteppingWidth(Graph *G) {
+  u32 n = numberOfVertices(G);
+  u32 averageDegree = n == 0 ? 1 : max(1, G->_edgeArraySize / n);
+  return max(1, (maxEdgeWeight(G) + averageDegree - 1) / averageDegree);
+}
+
+/**
+ * @brief Computes the minimum distance from `s` to every vertex of `G` by
+ * delta-stepping.
+ *
+ * @param s Source vertex.
+ * @param G A formatted weighted graph or digraph.
+ * @param delta Bucket width, or 0 to pick it with deltaSteppingWidth(G).
+ * @param pool Threads to use, or NULL to run on the calling thread only.
+ * @return The same array as `dijkstra(s, G)`. The caller must free it.
+ */
+u32 *deltaStepping(u32 s, Graph *G, u32 delta, ThreadPool *pool) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n);
+
+  u32 nThreads = poolSize(pool);
+  DeltaContext C = {0};
+  C.G = G;
+  C.pool = pool;
+  C.delta = delta == 0 ? deltaSteppingWidth(G) : delta;
+  C.distances = genArray(n);
+  C.removedFrom = genArray(n);
+  C.local = (LocalBuckets *)calloc(nThreads, sizeof(LocalBuckets));
+  C.offsets = genArray(nThreads + 1);
+  if (C.local == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  for (u32 i = 0; i < n; i++)
+    C.distances[i] = INT_MAX;
+  C.distances[s] = 0;
+
+  LocalBuckets *root = &C.local[0];
+  root->nBuckets = 1;
+  root->buckets = (VertexList *)calloc(1, sizeof(VertexList));
+  pushVertex(&root->buckets[0], s);
+
+  C.bucket = 0;
+  while (true) {
+    while (prepareFrontier(&C, nThreads) > 0)
+      runPhase(&C, lightPhase);
+    runPhase(&C, heavyPhase);
+
+    // Move on to the lowest non-empty bucket of any thread.
+    u32 next = UINT32_MAX;
+    for (u32 t = 0; t < nThreads; t++) {
+      LocalBuckets *L = &C.local[t];
+      for (u32 b = C.bucket + 1; b < L->nBuckets && b < next; b++) {
+        if (L->buckets[b].size > 0) {
+          next = b;
+          break;
+        }
+      }
+    }
+    if (next == UINT32_MAX)
+      break;
+    C.bucket = next;
+  }
+
+  for (u32 t = 0; t < nThreads; t++) {
+    for (u32 b = 0; b < C.local[t].nBuckets; b++)
+      free(C.local[t].buckets[b].array);
+    free(C.local[t].buckets);
+    free(C.local[t].removed.array);
+  }
+  free(C.local);
+  free(C.offsets);
+  free(C.frontier);
+  free(C.removedFrom);
+  return C.distances;
+}
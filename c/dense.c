@@ -0,0 +1,356 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file dense.c
+ * @brief Dijkstra's and Prim's algorithms in their O(n^2) array-scan form.
+ *
+ * On dense graphs a heap does not pay off: every settled vertex relaxes a
+ * whole row anyway. Keys live in one packed array, where settled vertices
+ * hold DENSE_DONE and unreached ones INT_MAX, so each step is a single
+ * pass that relaxes the row of the settled vertex and computes the new
+ * minimum key, followed by a search for the first vertex holding it. Both
+ * passes are branch-free SIMD loops; the AVX-512, AVX2 or scalar version
+ * is picked at runtime from what the CPU supports.
+ */
+
+#include "dense.h"
+#include "api.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DENSE_X86
+#include <immintrin.h>
+#endif
+
+// Relaxes every entry v of `keys` not yet settled with base + row[v],
+// recording u as the parent of the improved ones, and returns the smallest
+// key afterwards.
+typedef u32 (*RelaxKernel)(u32 *keys, u32 *parents, const u32 *row, u32 base,
+                           u32 u, u32 stride);
+// Returns the first index of `keys` holding `value`.
+typedef u32 (*FindKernel)(const u32 *keys, u32 value, u32 stride);
+
+typedef struct {
+  RelaxKernel relax;
+  FindKernel find;
+} Kernel;
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Kernels ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static u32 relaxScalar(u32 *keys, u32 *parents, const u32 *row, u32 base,
+                       u32 u, u32 stride) {
+  u32 best = DENSE_DONE;
+  for (u32 v = 0; v < stride; v++) {
+    u32 key = keys[v];
+    u32 candidate = base + row[v];
+    if (key != DENSE_DONE && candidate < key) {
+      keys[v] = key = candidate;
+      parents[v] = u;
+    }
+    if (key < best)
+      best = key;
+  }
+  return best;
+}
+
+static u32 findScalar(const u32 *keys, u32 value, u32 stride) {
+  for (u32 v = 0; v < stride; v++) {
+    if (keys[v] == value)
+      return v;
+  }
+  return stride;
+}
+
+#ifdef DENSE_X86
+
+__attribute__((target("avx2"))) static u32
+relaxAVX2(u32 *keys, u32 *parents, const u32 *row, u32 base, u32 u,
+          u32 stride) {
+  // AVX2 only compares signed integers: flipping the sign bit of both
+  // sides turns it into an unsigned comparison.
+  const __m256i sign = _mm256_set1_epi32((int)0x80000000);
+  const __m256i done = _mm256_set1_epi32((int)DENSE_DONE);
+  const __m256i baseV = _mm256_set1_epi32((int)base);
+  const __m256i uV = _mm256_set1_epi32((int)u);
+  __m256i best = done;
+  for (u32 v = 0; v < stride; v += 8) {
+    __m256i key = _mm256_loadu_si256((const __m256i *)(keys + v));
+    __m256i candidate = _mm256_add_epi32(
+        baseV, _mm256_loadu_si256((const __m256i *)(row + v)));
+    __m256i less = _mm256_cmpgt_epi32(_mm256_xor_si256(key, sign),
+                                      _mm256_xor_si256(candidate, sign));
+    __m256i improved = _mm256_andnot_si256(_mm256_cmpeq_epi32(key, done), less);
+    key = _mm256_blendv_epi8(key, candidate, improved);
+    _mm256_storeu_si256((__m256i *)(keys + v), key);
+    __m256i parent = _mm256_loadu_si256((const __m256i *)(parents + v));
+    _mm256_storeu_si256((__m256i *)(parents + v),
+                        _mm256_blendv_epi8(parent, uV, improved));
+    best = _mm256_min_epu32(best, key);
+  }
+  __m128i m = _mm_min_epu32(_mm256_castsi256_si128(best),
+                            _mm256_extracti128_si256(best, 1));
+  m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (u32)_mm_cvtsi128_si32(m);
+}
+
+__attribute__((target("avx2"))) static u32 findAVX2(const u32 *keys,
+                                                    u32 value, u32 stride) {
+  const __m256i target = _mm256_set1_epi32((int)value);
+  for (u32 v = 0; v < stride; v += 8) {
+    __m256i equal = _mm256_cmpeq_epi32(
+        _mm256_loadu_si256((const __m256i *)(keys + v)), target);
+    u32 mask = (u32)_mm256_movemask_ps(_mm256_castsi256_ps(equal));
+    if (mask != 0)
+      return v + __builtin_ctz(mask);
+  }
+  return stride;
+}
+
+__attribute__((target("avx512f"))) static u32
+relaxAVX512(u32 *keys, u32 *parents, const u32 *row, u32 base, u32 u,
+            u32 stride) {
+  const __m512i done = _mm512_set1_epi32((int)DENSE_DONE);
+  const __m512i baseV = _mm512_set1_epi32((int)base);
+  const __m512i uV = _mm512_set1_epi32((int)u);
+  __m512i best = done;
+  for (u32 v = 0; v < stride; v += 16) {
+    __m512i key = _mm512_loadu_si512(keys + v);
+    __m512i candidate = _mm512_add_epi32(baseV, _mm512_loadu_si512(row + v));
+    __mmask16 open = _mm512_cmpneq_epi32_mask(key, done);
+    __mmask16 improved = _mm512_mask_cmplt_epu32_mask(open, candidate, key);
+    key = _mm512_mask_mov_epi32(key, improved, candidate);
+    _mm512_storeu_si512(keys + v, key);
+    _mm512_mask_storeu_epi32(parents + v, improved, uV);
+    best = _mm512_min_epu32(best, key);
+  }
+  return (u32)_mm512_reduce_min_epu32(best);
+}
+
+__attribute__((target("avx512f"))) static u32
+findAVX512(const u32 *keys, u32 value, u32 stride) {
+  const __m512i target = _mm512_set1_epi32((int)value);
+  for (u32 v = 0; v < stride; v += 16) {
+    __mmask16 mask =
+        _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(keys + v), target);
+    if (mask != 0)
+      return v + __builtin_ctz(mask);
+  }
+  return stride;
+}
+
+#endif
+
+static const Kernel kernels[4] = {
+    {relaxScalar, findScalar}, // DENSE_AUTO, never used as such
+    {relaxScalar, findScalar},
+#ifdef DENSE_X86
+    {relaxAVX2, findAVX2},
+    {relaxAVX512, findAVX512},
+#else
+    {relaxScalar, findScalar},
+    {relaxScalar, findScalar},
+#endif
+};
+
+// The kernel in use, resolved on first use.
+static u32 activeKernel = DENSE_AUTO;
+
+/**
+ * @brief Chooses the kernels of denseDijkstra and densePrim. DENSE_AUTO
+ * picks the widest one the CPU supports; a kernel the CPU lacks falls back
+ * to the next narrower one.
+ *
+ * @return The kernel now in use.
+ */
+DenseKernel selectDenseKernel(DenseKernel kernel) {
+#ifdef DENSE_X86
+  __builtin_cpu_init();
+  bool avx2 = __builtin_cpu_supports("avx2");
+  bool avx512 = __builtin_cpu_supports("avx512f");
+  if (kernel == DENSE_AUTO)
+    kernel = DENSE_AVX512;
+  if (kernel == DENSE_AVX512 && !avx512)
+    kernel = DENSE_AVX2;
+  if (kernel == DENSE_AVX2 && !avx2)
+    kernel = DENSE_SCALAR;
+#else
+  kernel = DENSE_SCALAR;
+#endif
+  __atomic_store_n(&activeKernel, (u32)kernel, __ATOMIC_RELAXED);
+  return kernel;
+}
+
+static const Kernel *currentKernel() {
+  u32 kernel = __atomic_load_n(&activeKernel, __ATOMIC_RELAXED);
+  if (kernel == DENSE_AUTO)
+    kernel = selectDenseKernel(DENSE_AUTO);
+  return &kernels[kernel];
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Dense graphs ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Builds the weight matrix of `G`, in O(n^2) memory. Unweighted
+ * graphs get weight 1 on every edge; of parallel edges, the lightest is
+ * kept.
+ */
+DenseGraph *denseFromGraph(Graph *G) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  DenseGraph *D = (DenseGraph *)malloc(sizeof(DenseGraph));
+  if (D == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 n = numberOfVertices(G);
+  D->n = n;
+  D->stride = (n + DENSE_LANES - 1) / DENSE_LANES * DENSE_LANES;
+  D->directed = G->_g_flag & D_FLAG;
+  u64 size = (u64)n * D->stride;
+  D->weights = (u32 *)malloc((size + 1) * sizeof(u32));
+  if (D->weights == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  for (u64 i = 0; i < size; i++)
+    D->weights[i] = INT_MAX;
+
+  u32 entries = D->directed ? G->m : 2 * G->m;
+  for (u32 i = 0; i < entries; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x == e.y)
+      continue;
+    u32 w = G->_g_flag & W_FLAG ? *e.w : 1;
+    u32 *entry = &D->weights[(u64)e.x * D->stride + e.y];
+    if (w < *entry)
+      *entry = w;
+  }
+  return D;
+}
+
+void dumpDenseGraph(DenseGraph *D) {
+  if (D == NULL)
+    return;
+  free(D->weights);
+  free(D);
+}
+
+/**
+ * @brief Helper function. Allocates the key array: INT_MAX for the n
+ * vertices, DENSE_DONE for the padding, and 0 for `s`.
+ */
+static u32 *initialKeys(DenseGraph *D, u32 s) {
+  u32 *keys = genArray(D->stride);
+  for (u32 v = 0; v < D->stride; v++)
+    keys[v] = v < D->n ? INT_MAX : DENSE_DONE;
+  keys[s] = 0;
+  return keys;
+}
+
+/**
+ * @brief Computes the minimum distance from `s` to every vertex, in O(n^2)
+ * time with vectorized passes over the weight rows.
+ *
+ * @param[out] parents If not NULL, receives the predecessor of each vertex
+ * on a shortest path; `s` is its own parent and unreachable vertices get
+ * NO_PARENT.
+ * @return The same array as `dijkstra(s, G)`, to be freed by the caller.
+ */
+u32 *denseDijkstra(DenseGraph *D, u32 s, u32 *parents) {
+  assert(D != NULL && s < D->n);
+  const Kernel *K = currentKernel();
+  u32 *keys = initialKeys(D, s);
+  u32 *from = genArray(D->stride);
+  u32 *distances = genArray(D->n);
+  for (u32 v = 0; v < D->n; v++)
+    distances[v] = INT_MAX;
+
+  u32 u = s;
+  while (true) {
+    u32 du = keys[u];
+    distances[u] = du;
+    keys[u] = DENSE_DONE;
+    const u32 *row = D->weights + (u64)u * D->stride;
+    u32 best = K->relax(keys, from, row, du, u, D->stride);
+    if (best >= INT_MAX)
+      break;
+    u = K->find(keys, best, D->stride);
+  }
+
+  if (parents != NULL) {
+    for (u32 v = 0; v < D->n; v++)
+      parents[v] = distances[v] == INT_MAX ? NO_PARENT : from[v];
+    parents[s] = s;
+  }
+  free(keys);
+  free(from);
+  return distances;
+}
+
+/**
+ * @brief Computes a minimum spanning tree of the component of `s` in the
+ * undirected graph `D`, in O(n^2) time with vectorized passes over the
+ * weight rows.
+ *
+ * @param[out] totalWeight If not NULL, receives the weight of the tree.
+ * @return The parent of each vertex in the tree, to be freed by the caller:
+ * `s` is its own parent and vertices outside the component of `s` get
+ * NO_PARENT. See treeFromParents.
+ */
+u32 *densePrim(DenseGraph *D, u32 s, u64 *totalWeight) {
+  assert(D != NULL && s < D->n);
+  assert(!D->directed);
+  const Kernel *K = currentKernel();
+  u32 *keys = initialKeys(D, s);
+  u32 *parents = genArray(D->stride);
+  for (u32 v = 0; v < D->stride; v++)
+    parents[v] = NO_PARENT;
+  parents[s] = s;
+
+  u64 total = 0;
+  u32 u = s;
+  while (true) {
+    total += keys[u];
+    keys[u] = DENSE_DONE;
+    const u32 *row = D->weights + (u64)u * D->stride;
+    u32 best = K->relax(keys, parents, row, 0, u, D->stride);
+    if (best >= INT_MAX)
+      break;
+    u = K->find(keys, best, D->stride);
+  }
+
+  if (totalWeight != NULL)
+    *totalWeight = total;
+  free(keys);
+  return parents;
+}
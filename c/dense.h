@@ -0,0 +1,61 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file dense.h
+ * @brief O(n^2) Dijkstra and Prim for dense graphs, on a weight matrix with
+ * SIMD relaxation and argmin kernels chosen at runtime.
+ */
+
+#ifndef DENSE_H
+#define DENSE_H
+
+#include "graphStruct.h"
+
+// Key of a vertex already settled; larger than every real key.
+#define DENSE_DONE 0xFFFFFFFF
+
+// Rows are padded to a multiple of this many entries, the width of the
+// widest kernel.
+#define DENSE_LANES 16
+
+typedef enum { DENSE_AUTO, DENSE_SCALAR, DENSE_AVX2, DENSE_AVX512 } DenseKernel;
+
+// weights[u * stride + v] is the weight of the arc u -> v, or INT_MAX if
+// there is none. Padding entries are INT_MAX as well.
+typedef struct {
+  u32 n;
+  u32 stride;
+  bool directed;
+  u32 *weights;
+} DenseGraph;
+
+DenseGraph *denseFromGraph(Graph *G);
+void dumpDenseGraph(DenseGraph *D);
+DenseKernel selectDenseKernel(DenseKernel kernel);
+u32 *denseDijkstra(DenseGraph *D, u32 s, u32 *parents);
+u32 *densePrim(DenseGraph *D, u32 s, u64 *totalWeight);
+
+#endif
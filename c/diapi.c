@@ -35,6 +35,7 @@
  */
 
 #include "api.h"
+#include "diapi.h"
 #include "graphStruct.h"
 #include "utils.h"
 #include <assert.h>
@@ -88,3 +89,50 @@ void setEdgeDigraph(Graph *G, u32 i, u32 x, u32 y, u32 *w, u32 *c) {
   (G->Δ) = max(G->_outdegrees[x], G->Δ);
   G->_formatted = false;
 }
+
+/**
+ * @brief Builds the in-edges of every vertex of a digraph, so that searches
+ * can walk edges backwards.
+ *
+ * Edges are bucketed by target with a counting sort, in O(n + m) time.
+ * Within each bucket edge indices are increasing, i.e. sources are ordered
+ * increasingly. The index refers to positions in `G -> _edges` and must be
+ * rebuilt whenever the graph is modified.
+ *
+ * @param G A formatted digraph.
+ */
+ReverseIndex *buildReverseIndex(Graph *G) {
+  assert(G != NULL);
+  assert(G->_g_flag & D_FLAG);
+  assert(G->_formatted);
+
+  ReverseIndex *R = (ReverseIndex *)malloc(sizeof(ReverseIndex));
+  if (R == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  R->n = G->n;
+  R->first = genArray(G->n + 1);
+  R->edges = genArray(max(G->m, 1));
+
+  for (u32 y = 0; y < G->n; y++) {
+    R->first[y + 1] = R->first[y] + (G->_indegrees)[y];
+  }
+  u32 *next = genArray(G->n);
+  for (u32 y = 0; y < G->n; y++) {
+    next[y] = R->first[y];
+  }
+  for (u32 i = 0; i < G->m; i++) {
+    R->edges[next[(G->_edges)[i].y]++] = i;
+  }
+  free(next);
+  return R;
+}
+
+void dumpReverseIndex(ReverseIndex *R) {
+  if (R == NULL)
+    return;
+  free(R->first);
+  free(R->edges);
+  free(R);
+}
@@ -28,7 +28,22 @@
 
 
 
+#ifndef DIAPI_H
+#define DIAPI_H
+
 #include "graphStruct.h"
 
+// In-edges of a digraph: the edges entering vertex y are
+// G->_edges[edges[k]] for first[y] <= k < first[y + 1].
+typedef struct {
+  u32 n;
+  u32 *first;
+  u32 *edges;
+} ReverseIndex;
+
 u32 inDegree(u32 i, Graph *G);
 void setEdgeDigraph(Graph *G, u32 i, u32 x, u32 y, u32 *w, u32 *c);
+ReverseIndex *buildReverseIndex(Graph *G);
+void dumpReverseIndex(ReverseIndex *R);
+
+#endif
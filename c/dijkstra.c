@@ -35,6 +35,9 @@
  */
 
 #include "api.h"
+#include "bucketqueue.h"
+#include "dijkstra.h"
+#include "heap.h"
 #include "utils.h"
 #include <assert.h>
 #include <limits.h>
@@ -42,48 +45,572 @@
 #include <stdlib.h>
 #include <string.h>
 
-u32 *dijkstra(u32 s, Graph *G) {
+/**
+ * @brief Computes the minimum distance from `s` to every vertex of `G`,
+ * into the workspace W: afterwards workspaceDistance(W, v) is the distance
+ * to v, W->parents[v] its predecessor on a shortest path and
+ * W->parentEdges[v] the edge between them.
+ *
+ * Vertices are settled in order of distance using an indexed heap with
+ * decrease-key, so the running time is O((n + m) log n). Edges of the
+ * settled vertex are read by their position in the edge array, so no
+ * edge lookup is needed. Works for both graphs and digraphs. Only the
+ * vertices reached are touched, so W can be reused for many searches.
+ */
+void workspaceDijkstra(u32 s, Graph *G, SearchWorkspace *W) {
   assert(G != NULL);
   assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  assert(W != NULL && W->n >= numberOfVertices(G));
+  assert(s < numberOfVertices(G));
+
+  resetWorkspace(W);
+  u32 epoch = W->epoch;
+  W->stamp[s] = epoch;
+  W->distances[s] = 0;
+  W->parents[s] = s;
+  W->parentEdges[s] = NO_PARENT;
+  indexedInsert(W->heap, s, 0);
+
+  while (W->heap->size > 0) {
+    HeapNode node = indexedExtractMin(W->heap);
+    u32 v = node.label;
+    u32 vDistance = node.value;
 
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 i = first; i < last; i++) {
+      Edge e = (G->_edges)[i];
+      u32 candidate = vDistance + *(e.w);
+      if (W->stamp[e.y] == epoch && candidate >= W->distances[e.y])
+        continue;
+      W->distances[e.y] = candidate;
+      W->parents[e.y] = v;
+      W->parentEdges[e.y] = i;
+      if (W->stamp[e.y] == epoch && heapContains(W->heap, e.y)) {
+        decreaseKey(W->heap, e.y, candidate);
+      } else {
+        W->stamp[e.y] = epoch;
+        indexedInsert(W->heap, e.y, candidate);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Computes the minimum distance from `s` to every vertex of `G`, and
+ * the shortest path tree the distances come from.
+ *
+ * @param[out] parents If not NULL, receives for each vertex its predecessor
+ * on a shortest path from `s`; `s` is its own parent and unreachable
+ * vertices get NO_PARENT. See extractPath and treeFromParents.
+ * @param[out] parentEdges If not NULL, receives for each vertex the index in
+ * G->_edges of the edge from its parent, or NO_PARENT for `s` and
+ * unreachable vertices.
+ * @return An array D of n integers such that D[i] is the distance from `s`
+ * to `i`, or INT_MAX if `i` is unreachable. The caller must free it.
+ */
+u32 *dijkstraWithParents(u32 s, Graph *G, u32 *parents, u32 *parentEdges) {
+  assert(G != NULL);
   u32 n = numberOfVertices(G);
-  u32 *distances = genArray(n);
-  u32 *visited = genArray(n);
+  SearchWorkspace *W = createSearchWorkspace(n);
+  workspaceDijkstra(s, G, W);
+  u32 *distances = W->distances;
+  for (u32 i = 0; i < n; i++) {
+    bool reached = W->stamp[i] == W->epoch;
+    if (!reached)
+      distances[i] = INT_MAX;
+    if (parents != NULL)
+      parents[i] = reached ? W->parents[i] : NO_PARENT;
+    if (parentEdges != NULL)
+      parentEdges[i] = reached ? W->parentEdges[i] : NO_PARENT;
+  }
+  W->distances = NULL;
+  dumpSearchWorkspace(W);
+  return distances;
+}
 
-  // Initial distances
+/**
+ * @brief Computes the minimum distance from `s` to every vertex of `G`.
+ * See workspaceDijkstra to run many searches without allocating.
+ *
+ * @return An array D of n integers such that D[i] is the distance from `s`
+ * to `i`, or INT_MAX if `i` is unreachable. The caller must free it.
+ */
+u32 *dijkstra(u32 s, Graph *G) { return dijkstraWithParents(s, G, NULL, NULL); }
+
+/**
+ * @brief Helper function. Allocates the distance array, with every vertex
+ * but `s` at distance INT_MAX.
+ */
+static u32 *initialDistances(u32 s, u32 n) {
+  assert(s < n);
+  u32 *distances = genArray(n);
   for (u32 i = 0; i < n; i++) {
     distances[i] = INT_MAX;
   }
   distances[s] = 0;
+  return distances;
+}
+
+/**
+ * @brief Dijkstra's algorithm on a radix heap.
+ *
+ * Since weights are non-negative integers, the extracted distances never
+ * decrease and a radix heap applies. Decrease-key is replaced by a new
+ * insertion, and stale entries are skipped on extraction. Runs in
+ * O(m + n log C), where C is the maximum edge weight.
+ *
+ * @return The same array as `dijkstra(s, G)`.
+ */
+u32 *radixDijkstra(u32 s, Graph *G) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+
+  u32 *distances = initialDistances(s, numberOfVertices(G));
+  RadixHeap *heap = createRadixHeap();
+  radixInsert(heap, s, 0);
+
+  while (heap->size > 0) {
+    HeapNode node = radixExtractMin(heap);
+    u32 v = node.label;
+    if (node.value != distances[v])
+      continue;
+
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 i = first; i < last; i++) {
+      Edge e = (G->_edges)[i];
+      u32 candidate = node.value + *(e.w);
+      if (candidate < distances[e.y]) {
+        distances[e.y] = candidate;
+        radixInsert(heap, e.y, candidate);
+      }
+    }
+  }
+  dumpRadixHeap(heap);
+  return distances;
+}
+
+/**
+ * @brief Dial's algorithm: Dijkstra's algorithm on a circular array of C + 1
+ * buckets, where C is the maximum edge weight. Runs in O(m + nC), which is
+ * the fastest option when C is small.
+ *
+ * @return The same array as `dijkstra(s, G)`.
+ */
+u32 *dialDijkstra(u32 s, Graph *G) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+
+  u32 *distances = initialDistances(s, numberOfVertices(G));
+  BucketQueue *queue = createBucketQueue(maxEdgeWeight(G));
+  bucketInsert(queue, s, 0);
+
+  while (queue->size > 0) {
+    HeapNode node = bucketExtractMin(queue);
+    u32 v = node.label;
+    if (node.value != distances[v])
+      continue;
+
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 i = first; i < last; i++) {
+      Edge e = (G->_edges)[i];
+      u32 candidate = node.value + *(e.w);
+      if (candidate < distances[e.y]) {
+        distances[e.y] = candidate;
+        bucketInsert(queue, e.y, candidate);
+      }
+    }
+  }
+  dumpBucketQueue(queue);
+  return distances;
+}
+
+/**
+ * @brief Shortest distances from `s` using a monotone integer priority queue
+ * chosen from the maximum edge weight C: Dial's buckets if C is at most
+ * DIAL_MAX_WEIGHT, a radix heap otherwise.
+ *
+ * @return The same array as `dijkstra(s, G)`.
+ */
+u32 *integerDijkstra(u32 s, Graph *G) {
+  if (maxEdgeWeight(G) <= DIAL_MAX_WEIGHT)
+    return dialDijkstra(s, G);
+  return radixDijkstra(s, G);
+}
+
+/**
+ * @brief Computes the minimum distance from every vertex of the digraph `G`
+ * to `t`, by running Dijkstra's algorithm on the in-edges listed in `R`.
+ * For undirected graphs `R` is ignored and this is `dijkstra(t, G)`.
+ *
+ * @return An array D of n integers such that D[i] is the distance from `i`
+ * to `t`, or INT_MAX if `t` is unreachable from `i`.
+ */
+u32 *reverseDijkstra(u32 t, Graph *G, ReverseIndex *R) {
+  assert(G != NULL);
+  if (!(G->_g_flag & D_FLAG))
+    return dijkstra(t, G);
+  assert(R != NULL && R->n == numberOfVertices(G));
+
+  u32 n = numberOfVertices(G);
+  u32 *distances = initialDistances(t, n);
+  IndexedHeap *heap = createIndexedHeap(n);
+  indexedInsert(heap, t, 0);
+
+  while (heap->size > 0) {
+    HeapNode node = indexedExtractMin(heap);
+    u32 v = node.label;
+    for (u32 k = R->first[v]; k < R->first[v + 1]; k++) {
+      Edge e = (G->_edges)[R->edges[k]];
+      u32 candidate = node.value + *(e.w);
+      if (candidate >= distances[e.x])
+        continue;
+      distances[e.x] = candidate;
+      if (heapContains(heap, e.x))
+        decreaseKey(heap, e.x, candidate);
+      else
+        indexedInsert(heap, e.x, candidate);
+    }
+  }
+  dumpIndexedHeap(heap);
+  return distances;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~ Point-to-point queries ~~~~~~~~~~~~~~~~~~~~~~~~~
+
+void dumpPath(Path *P) {
+  if (P == NULL)
+    return;
+  free(P->vertices);
+  free(P);
+}
 
+/**
+ * @brief Allocates a Path for an unreachable target: distance INT_MAX and
+ * no vertices. Callers that find a path fill it with appendPathTo.
+ */
+Path *emptyPath() {
+  Path *P = (Path *)calloc(1, sizeof(Path));
+  if (P == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  P->distance = INT_MAX;
+  return P;
+}
+
+/**
+ * @brief Extracts the path from `s` to `t` in a tree given by its parent
+ * array, such as the one filled by dijkstraWithParents or BFSWithParents.
+ * Runs in O(path length): only the path is walked and allocated.
+ *
+ * @param distances Distances from `s`, for P->distance; may be NULL.
+ * @return The path, to be freed with dumpPath. If `t` is not in the tree,
+ * its distance is INT_MAX and its length 0.
+ */
+Path *extractPath(u32 *parents, u32 *distances, u32 s, u32 t) {
+  assert(parents != NULL);
+  Path *P = emptyPath();
+  if (t != s && parents[t] == NO_PARENT)
+    return P;
+  u32 length = 1;
+  for (u32 v = t; v != s; v = parents[v])
+    length++;
+  P->vertices = genArray(length);
+  P->length = length;
+  for (u32 v = t, i = length; i > 0; v = parents[v])
+    P->vertices[--i] = v;
+  P->distance = distances != NULL ? distances[t] : INT_MAX;
+  return P;
+}
+
+/**
+ * @brief Appends to P the vertices from `s` to `v` by following `parents`
+ * backwards from `v`, in O(path length). P->vertices must have room for them.
+ */
+void appendPathTo(Path *P, u32 *parents, u32 s, u32 v) {
+  u32 start = P->length;
   while (true) {
+    P->vertices[P->length++] = v;
+    if (v == s)
+      break;
+    v = parents[v];
+  }
+  for (u32 i = start, j = P->length - 1; i < j; i++, j--)
+    swap_u32_pointers(&P->vertices[i], &P->vertices[j]);
+}
 
-    u32 v;
-    u32 vDistance = INT_MAX;
-    for (u32 w = 0; w < n; w++) {
-      if (visited[w] != 0 || distances[w] == INT_MAX)
+/**
+ * @brief Checks that P is a path of G from `s` to `t` whose weight is
+ * P->distance, taking the lightest of parallel edges (weight 1 on
+ * unweighted graphs).
+ *
+ * @return `true` if it is, `false` otherwise, including if P is empty.
+ */
+bool isPathOf(Path *P, Graph *G, u32 s, u32 t) {
+  assert(P != NULL && G != NULL && isFormatted(G));
+  if (P->length == 0 || P->vertices[0] != s ||
+      P->vertices[P->length - 1] != t)
+    return false;
+  u64 total = 0;
+  for (u32 i = 0; i + 1 < P->length; i++) {
+    u32 x = P->vertices[i], y = P->vertices[i + 1];
+    u32 best = INT_MAX;
+    u32 first = firstNeighbourIndex(G, x);
+    for (u32 j = first; j < first + degree(x, G); j++) {
+      Edge e = (G->_edges)[j];
+      if (e.y == y)
+        best = min(best, e.w != NULL ? *e.w : 1);
+    }
+    if (best == INT_MAX)
+      return false;
+    total += best;
+  }
+  return total == P->distance;
+}
+
+/**
+ * @brief Computes a shortest path from `s` to `t` with Dijkstra's algorithm,
+ * stopping as soon as `t` is settled. The search runs in the workspace W,
+ * so its cost depends on the vertices reached rather than on n.
+ *
+ * @return The path, to be freed with dumpPath.
+ */
+Path *workspaceShortestPath(Graph *G, u32 s, u32 t, SearchWorkspace *W) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n && t < n);
+  assert(W != NULL && W->n >= n);
+
+  u32 settled = 0;
+  resetWorkspace(W);
+  u32 epoch = W->epoch;
+  W->stamp[s] = epoch;
+  W->distances[s] = 0;
+  W->parents[s] = s;
+  W->parentEdges[s] = NO_PARENT;
+  indexedInsert(W->heap, s, 0);
+
+  while (W->heap->size > 0) {
+    HeapNode node = indexedExtractMin(W->heap);
+    u32 v = node.label;
+    settled++;
+    if (v == t)
+      break;
+
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 i = first; i < last; i++) {
+      Edge e = (G->_edges)[i];
+      u32 candidate = node.value + *(e.w);
+      if (W->stamp[e.y] == epoch && candidate >= W->distances[e.y])
         continue;
-      if (distances[w] < vDistance) {
-        vDistance = distances[w];
-        v = w;
+      W->distances[e.y] = candidate;
+      W->parents[e.y] = v;
+      W->parentEdges[e.y] = i;
+      if (W->stamp[e.y] == epoch && heapContains(W->heap, e.y)) {
+        decreaseKey(W->heap, e.y, candidate);
+      } else {
+        W->stamp[e.y] = epoch;
+        indexedInsert(W->heap, e.y, candidate);
       }
     }
-    visited[v] = 1;
+  }
+
+  Path *P = W->stamp[t] == epoch ? extractPath(W->parents, W->distances, s, t)
+                                  : emptyPath();
+  P->settled = settled;
+  return P;
+}
 
-    // This only happens if all vertices were visited
-    if (vDistance == INT_MAX) {
-      free(visited);
-      return distances;
+/**
+ * @brief Computes a shortest path from `s` to `t` with Dijkstra's algorithm,
+ * stopping as soon as `t` is settled.
+ *
+ * @return The path, to be freed with dumpPath.
+ */
+Path *shortestPath(Graph *G, u32 s, u32 t) {
+  assert(G != NULL);
+  SearchWorkspace *W = createSearchWorkspace(numberOfVertices(G));
+  Path *P = workspaceShortestPath(G, s, t, W);
+  dumpSearchWorkspace(W);
+  return P;
+}
+
+// One side of a bidirectional search, run in its own workspace: u has been
+// reached by this side iff W->stamp[u] == epoch.
+typedef struct {
+  SearchWorkspace *W;
+  u32 epoch;
+} SearchSide;
+
+static void initSide(SearchSide *S, SearchWorkspace *W, u32 root) {
+  resetWorkspace(W);
+  S->W = W;
+  S->epoch = W->epoch;
+  W->stamp[root] = S->epoch;
+  W->distances[root] = 0;
+  W->parents[root] = root;
+  indexedInsert(W->heap, root, 0);
+}
+
+static u32 sideDistance(SearchSide *S, u32 u) {
+  return S->W->stamp[u] == S->epoch ? S->W->distances[u] : INT_MAX;
+}
+
+/**
+ * @brief Helper function. Relaxes the edge from `v` to `u` of weight `w` on
+ * one side, and records it if it closes a better path with the other side.
+ */
+static void relaxSide(SearchSide *side, SearchSide *other, u32 v, u32 u, u32 w,
+                      u32 *best, u32 *meetFrom, u32 *meetTo) {
+  SearchWorkspace *W = side->W;
+  u32 candidate = W->distances[v] + w;
+  if (candidate < sideDistance(side, u)) {
+    bool queued = W->stamp[u] == side->epoch && heapContains(W->heap, u);
+    W->stamp[u] = side->epoch;
+    W->distances[u] = candidate;
+    W->parents[u] = v;
+    if (queued)
+      decreaseKey(W->heap, u, candidate);
+    else
+      indexedInsert(W->heap, u, candidate);
+  }
+  u32 rest = sideDistance(other, u);
+  if (rest != INT_MAX && candidate + rest < *best) {
+    *best = candidate + rest;
+    *meetFrom = v;
+    *meetTo = u;
+  }
+}
+
+/**
+ * @brief Computes a shortest path from `s` to `t` with a bidirectional
+ * Dijkstra search.
+ *
+ * A forward search from `s` and a backward search from `t` are alternated,
+ * always advancing the side whose next vertex is closer. Every relaxed edge
+ * joining both searches yields a candidate path, and the search stops once
+ * the two queue minima add up to at least the best candidate found. This
+ * settles roughly the vertices within half the s-t distance of each end,
+ * instead of every vertex within the full distance of `s`. The sides run in
+ * the workspaces F and B, so a query costs the vertices it reaches, and the
+ * path is extracted in O(path length).
+ *
+ * @param R In-edges of G, used by the backward search on digraphs. May be
+ * NULL, in which case they are built (in O(n + m)) for digraphs. Ignored for
+ * undirected graphs.
+ * @return The path, to be freed with dumpPath.
+ */
+Path *workspaceBidirectionalShortestPath(Graph *G, u32 s, u32 t,
+                                         ReverseIndex *R, SearchWorkspace *F,
+                                         SearchWorkspace *B) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n && t < n);
+  assert(F != NULL && B != NULL && F != B);
+  assert(F->n >= n && B->n >= n);
+
+  bool isDirected = G->_g_flag & D_FLAG;
+  ReverseIndex *ownIndex = NULL;
+  if (isDirected && R == NULL)
+    R = ownIndex = buildReverseIndex(G);
+
+  Path *P = emptyPath();
+  SearchSide forward, backward;
+  initSide(&forward, F, s);
+  initSide(&backward, B, t);
+  u32 best = s == t ? 0 : INT_MAX;
+  u32 meetFrom = s, meetTo = s; // the path crosses from forward to backward
+                                // through the edge meetFrom -> meetTo
+
+  while (F->heap->size > 0 && B->heap->size > 0) {
+    u32 topForward = F->heap->array[0].value;
+    u32 topBackward = B->heap->array[0].value;
+    if (best != INT_MAX && topForward + topBackward >= best)
+      break;
+
+    if (topForward <= topBackward) {
+      u32 v = indexedExtractMin(F->heap).label;
+      P->settled++;
+      u32 first = firstNeighbourIndex(G, v);
+      u32 last = first + degree(v, G);
+      for (u32 i = first; i < last; i++) {
+        Edge e = (G->_edges)[i];
+        relaxSide(&forward, &backward, v, e.y, *e.w, &best, &meetFrom,
+                  &meetTo);
+      }
+    } else {
+      u32 v = indexedExtractMin(B->heap).label;
+      P->settled++;
+      if (isDirected) {
+        for (u32 k = R->first[v]; k < R->first[v + 1]; k++) {
+          Edge e = (G->_edges)[R->edges[k]];
+          // Reversed edge: the backward side steps from v to e.x.
+          relaxSide(&backward, &forward, v, e.x, *e.w, &best, &meetTo,
+                    &meetFrom);
+        }
+      } else {
+        u32 first = firstNeighbourIndex(G, v);
+        u32 last = first + degree(v, G);
+        for (u32 i = first; i < last; i++) {
+          Edge e = (G->_edges)[i];
+          relaxSide(&backward, &forward, v, e.y, *e.w, &best, &meetTo,
+                    &meetFrom);
+        }
+      }
     }
+  }
 
-    // Traverse neighbours of v and update its distances
-    for (u32 i = 0; i < degree(v, G); i++) {
-      u32 iNeighbour = neighbour(i, v, G);
-      if (visited[iNeighbour])
-        continue;
-      Edge e = getEdge(v, iNeighbour, G);
-      u32 weight = *(e.w);
-      distances[iNeighbour] = min(distances[iNeighbour], vDistance + weight);
+  if (best != INT_MAX) {
+    P->distance = best;
+    u32 length = 1;
+    for (u32 v = meetFrom; v != s; v = F->parents[v])
+      length++;
+    if (meetTo != meetFrom) {
+      length++;
+      for (u32 v = meetTo; v != t; v = B->parents[v])
+        length++;
+    }
+    P->vertices = genArray(length);
+    appendPathTo(P, F->parents, s, meetFrom);
+    if (meetTo != meetFrom) {
+      // Walk the backward parents from meetTo up to t.
+      u32 v = meetTo;
+      while (true) {
+        P->vertices[P->length++] = v;
+        if (v == t)
+          break;
+        v = B->parents[v];
+      }
     }
+    assert(P->length == length);
   }
+  dumpReverseIndex(ownIndex);
+  return P;
+}
+
+/**
+ * @brief As workspaceBidirectionalShortestPath, with two temporary
+ * workspaces.
+ *
+ * @return The path, to be freed with dumpPath.
+ */
+Path *bidirectionalShortestPath(Graph *G, u32 s, u32 t, ReverseIndex *R) {
+  assert(G != NULL);
+  SearchWorkspace *F = createSearchWorkspace(numberOfVertices(G));
+  SearchWorkspace *B = createSearchWorkspace(numberOfVertices(G));
+  Path *P = workspaceBidirectionalShortestPath(G, s, t, R, F, B);
+  dumpSearchWorkspace(F);
+  dumpSearchWorkspace(B);
+  return P;
 }
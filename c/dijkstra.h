@@ -28,6 +28,44 @@
 
 
 
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
 #include "api.h"
+#include "diapi.h"
+#include "workspace.h"
+
+// A shortest path s = vertices[0], ..., vertices[length - 1] = t. If t is
+// unreachable, distance is INT_MAX and length is 0. `settled` counts the
+// vertices settled by the search that found it.
+typedef struct {
+  u32 distance;
+  u32 length;
+  u32 *vertices;
+  u32 settled;
+} Path;
+
+// Largest edge weight for which integerDijkstra picks Dial's algorithm over
+// a radix heap.
+#define DIAL_MAX_WEIGHT 256
 
 u32 *dijkstra(u32 s, Graph *G);
+u32 *dijkstraWithParents(u32 s, Graph *G, u32 *parents, u32 *parentEdges);
+void workspaceDijkstra(u32 s, Graph *G, SearchWorkspace *W);
+u32 *radixDijkstra(u32 s, Graph *G);
+u32 *dialDijkstra(u32 s, Graph *G);
+u32 *integerDijkstra(u32 s, Graph *G);
+u32 *reverseDijkstra(u32 t, Graph *G, ReverseIndex *R);
+Path *shortestPath(Graph *G, u32 s, u32 t);
+Path *workspaceShortestPath(Graph *G, u32 s, u32 t, SearchWorkspace *W);
+Path *bidirectionalShortestPath(Graph *G, u32 s, u32 t, ReverseIndex *R);
+Path *workspaceBidirectionalShortestPath(Graph *G, u32 s, u32 t,
+                                         ReverseIndex *R, SearchWorkspace *F,
+                                         SearchWorkspace *B);
+Path *emptyPath();
+Path *extractPath(u32 *parents, u32 *distances, u32 s, u32 t);
+void appendPathTo(Path *P, u32 *parents, u32 s, u32 v);
+bool isPathOf(Path *P, Graph *G, u32 s, u32 t);
+void dumpPath(Path *P);
+
+#endif
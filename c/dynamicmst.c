@@ -0,0 +1,445 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file dynamicmst.c
+ * @brief A minimum spanning forest kept up to date as edges come, go and
+ * change weight.
+ *
+ * The forest is stored in link-cut trees (Sleator and Tarjan), in which
+ * every edge is a node of its own between its two ends. Path-maximum
+ * queries then find the heaviest forest edge on the cycle a new edge
+ * closes, so insertions and weight decreases take O(log n) amortized time.
+ * When a forest edge is deleted or made heavier, the lightest edge
+ * reconnecting the two halves is searched among all non-forest edges, in
+ * O(m log n) time.
+ */
+
+#include "dynamicmst.h"
+#include "api.h"
+#include "kruskal.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NIL 0xFFFFFFFF
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Link-cut trees ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. The weight of node `v` for path maxima: vertices
+ * weigh less than every edge.
+ */
+static u64 nodeKey(DynamicMST *D, u32 v) {
+  return v < D->n ? 0 : (u64)D->weights[v - D->n] << 1 | 1;
+}
+
+static bool isSplayRoot(DynamicMST *D, u32 x) {
+  u32 p = D->parent[x];
+  return p == NIL || (D->left[p] != x && D->right[p] != x);
+}
+
+static void pushDown(DynamicMST *D, u32 x) {
+  if (!D->flip[x])
+    return;
+  u32 t = D->left[x];
+  D->left[x] = D->right[x];
+  D->right[x] = t;
+  if (D->left[x] != NIL)
+    D->flip[D->left[x]] ^= 1;
+  if (D->right[x] != NIL)
+    D->flip[D->right[x]] ^= 1;
+  D->flip[x] = false;
+}
+
+static void pullUp(DynamicMST *D, u32 x) {
+  u32 best = x;
+  u32 l = D->left[x], r = D->right[x];
+  if (l != NIL && nodeKey(D, D->heaviest[l]) > nodeKey(D, best))
+    best = D->heaviest[l];
+  if (r != NIL && nodeKey(D, D->heaviest[r]) > nodeKey(D, best))
+    best = D->heaviest[r];
+  D->heaviest[x] = best;
+}
+
+static void rotate(DynamicMST *D, u32 x) {
+  u32 p = D->parent[x], g = D->parent[p];
+  bool pIsRoot = isSplayRoot(D, p);
+  if (D->left[p] == x) {
+    D->left[p] = D->right[x];
+    if (D->left[p] != NIL)
+      D->parent[D->left[p]] = p;
+    D->right[x] = p;
+  } else {
+    D->right[p] = D->left[x];
+    if (D->right[p] != NIL)
+      D->parent[D->right[p]] = p;
+    D->left[x] = p;
+  }
+  D->parent[p] = x;
+  D->parent[x] = g;
+  if (!pIsRoot) {
+    if (D->left[g] == p)
+      D->left[g] = x;
+    else
+      D->right[g] = x;
+  }
+  pullUp(D, p);
+  pullUp(D, x);
+}
+
+/**
+ * @brief Helper function. Brings `x` to the root of its splay tree, after
+ * pushing down the pending reversals above it.
+ */
+static void splay(DynamicMST *D, u32 x) {
+  u32 depth = 0;
+  for (u32 y = x;; y = D->parent[y]) {
+    D->stack[depth++] = y;
+    if (isSplayRoot(D, y))
+      break;
+  }
+  while (depth > 0)
+    pushDown(D, D->stack[--depth]);
+
+  while (!isSplayRoot(D, x)) {
+    u32 p = D->parent[x];
+    if (!isSplayRoot(D, p)) {
+      u32 g = D->parent[p];
+      bool zigZig = (D->left[g] == p) == (D->left[p] == x);
+      rotate(D, zigZig ? p : x);
+    }
+    rotate(D, x);
+  }
+}
+
+/**
+ * @brief Helper function. Makes the path from the root of the tree of `x`
+ * down to `x` preferred, leaving `x` at the root of its splay tree.
+ */
+static void access(DynamicMST *D, u32 x) {
+  u32 last = NIL;
+  for (u32 y = x; y != NIL; y = D->parent[y]) {
+    splay(D, y);
+    D->right[y] = last;
+    pullUp(D, y);
+    last = y;
+  }
+  splay(D, x);
+}
+
+static void makeRoot(DynamicMST *D, u32 x) {
+  access(D, x);
+  D->flip[x] ^= 1;
+}
+
+static u32 findRoot(DynamicMST *D, u32 x) {
+  access(D, x);
+  while (true) {
+    pushDown(D, x);
+    if (D->left[x] == NIL)
+      break;
+    x = D->left[x];
+  }
+  splay(D, x);
+  return x;
+}
+
+static void link(DynamicMST *D, u32 x, u32 y) {
+  makeRoot(D, x);
+  D->parent[x] = y;
+}
+
+static void cut(DynamicMST *D, u32 x, u32 y) {
+  makeRoot(D, x);
+  access(D, y);
+  // The path is x, y: x is all of the left subtree of y.
+  assert(D->left[y] == x && D->right[x] == NIL);
+  D->left[y] = NIL;
+  D->parent[x] = NIL;
+  pullUp(D, y);
+}
+
+/**
+ * @brief Helper function. The heaviest node on the path between `x` and
+ * `y`, which must be in the same tree.
+ */
+static u32 pathHeaviest(DynamicMST *D, u32 x, u32 y) {
+  makeRoot(D, x);
+  access(D, y);
+  return D->heaviest[y];
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Edges ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static void linkEdge(DynamicMST *D, u32 e) {
+  link(D, D->ends[2 * e], D->n + e);
+  link(D, D->n + e, D->ends[2 * e + 1]);
+  D->inForest[e] = true;
+  D->forestEdges++;
+  D->forestWeight += D->weights[e];
+}
+
+static void cutEdge(DynamicMST *D, u32 e) {
+  cut(D, D->ends[2 * e], D->n + e);
+  cut(D, D->n + e, D->ends[2 * e + 1]);
+  D->inForest[e] = false;
+  D->forestEdges--;
+  D->forestWeight -= D->weights[e];
+}
+
+/**
+ * @brief Helper function. Adds the non-forest edge `e` to the forest if its
+ * ends are in different trees, or if it is lighter than the heaviest edge
+ * on the cycle it closes, which then leaves the forest.
+ */
+static void offerEdge(DynamicMST *D, u32 e) {
+  u32 x = D->ends[2 * e], y = D->ends[2 * e + 1];
+  if (x == y)
+    return;
+  if (findRoot(D, x) != findRoot(D, y)) {
+    linkEdge(D, e);
+    return;
+  }
+  u32 f = pathHeaviest(D, x, y) - D->n;
+  if (D->weights[f] > D->weights[e]) {
+    cutEdge(D, f);
+    linkEdge(D, e);
+  }
+}
+
+/**
+ * @brief Helper function. Joins the trees of `x` and `y`, just split by
+ * removing an edge, with the lightest live non-forest edge between them,
+ * if any.
+ */
+static void reconnect(DynamicMST *D, u32 x, u32 y) {
+  u32 rx = findRoot(D, x), ry = findRoot(D, y);
+  u32 best = NIL;
+  for (u32 f = 0; f < D->m; f++) {
+    if (!D->alive[f] || D->inForest[f])
+      continue;
+    if (best != NIL && D->weights[f] >= D->weights[best])
+      continue;
+    u32 a = findRoot(D, D->ends[2 * f]);
+    u32 b = findRoot(D, D->ends[2 * f + 1]);
+    if ((a == rx && b == ry) || (a == ry && b == rx))
+      best = f;
+  }
+  if (best != NIL)
+    linkEdge(D, best);
+}
+
+static void *grow(void *array, u32 count, size_t size) {
+  array = realloc(array, count * size);
+  if (array == NULL) {
+    printf("Error: realloc failed\n");
+    exit(1);
+  }
+  return array;
+}
+
+/**
+ * @brief Helper function. Makes room for `capacity` edges, initializing the
+ * link-cut nodes of the new ones as single-node trees.
+ */
+static void reserveEdges(DynamicMST *D, u32 capacity) {
+  u32 first = D->n + D->capacity;
+  u32 nodes = D->n + capacity;
+  D->ends = (u32 *)grow(D->ends, 2 * capacity, sizeof(u32));
+  D->weights = (u32 *)grow(D->weights, capacity, sizeof(u32));
+  D->alive = (bool *)grow(D->alive, capacity, sizeof(bool));
+  D->inForest = (bool *)grow(D->inForest, capacity, sizeof(bool));
+  D->left = (u32 *)grow(D->left, nodes, sizeof(u32));
+  D->right = (u32 *)grow(D->right, nodes, sizeof(u32));
+  D->parent = (u32 *)grow(D->parent, nodes, sizeof(u32));
+  D->heaviest = (u32 *)grow(D->heaviest, nodes, sizeof(u32));
+  D->flip = (bool *)grow(D->flip, nodes, sizeof(bool));
+  D->stack = (u32 *)grow(D->stack, nodes, sizeof(u32));
+  for (u32 v = first; v < nodes; v++) {
+    D->left[v] = D->right[v] = D->parent[v] = NIL;
+    D->heaviest[v] = v;
+    D->flip[v] = false;
+  }
+  D->capacity = capacity;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ API ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Builds the structure for the undirected weighted graph `G`, with a
+ * minimum spanning forest computed by kruskal.
+ *
+ * Edge e, for e < m, is the e-th entry (x, y) with x < y of G->_edges;
+ * edges inserted later get the following numbers. Self-loops of `G` are
+ * left out.
+ */
+DynamicMST *createDynamicMST(Graph *G) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(!(G->_g_flag & D_FLAG));
+  assert(isFormatted(G));
+  DynamicMST *D = (DynamicMST *)calloc(1, sizeof(DynamicMST));
+  if (D == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 n = numberOfVertices(G);
+  u32 entries = 2 * numberOfEdges(G);
+  D->n = n;
+  reserveEdges(D, numberOfEdges(G) > 16 ? numberOfEdges(G) : 16);
+  for (u32 v = 0; v < n; v++) {
+    D->left[v] = D->right[v] = D->parent[v] = NIL;
+    D->heaviest[v] = v;
+    D->flip[v] = false;
+  }
+
+  u32 *chosen = genArray(n);
+  u32 k = kruskalEdges(G, chosen, NULL, NULL);
+  bool *inForest = (bool *)calloc(entries + 1, sizeof(bool));
+  if (inForest == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  for (u32 i = 0; i < k; i++)
+    inForest[chosen[i]] = true;
+
+  for (u32 i = 0; i < entries; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x >= e.y)
+      continue;
+    u32 id = D->m++;
+    D->ends[2 * id] = e.x;
+    D->ends[2 * id + 1] = e.y;
+    D->weights[id] = *(e.w);
+    D->alive[id] = true;
+    D->inForest[id] = false;
+    if (inForest[i])
+      linkEdge(D, id);
+  }
+  free(chosen);
+  free(inForest);
+  return D;
+}
+
+/**
+ * @brief Adds the edge {x, y} of weight `w`, in O(log n) amortized time.
+ *
+ * @return The number of the new edge.
+ */
+u32 dynamicMSTInsert(DynamicMST *D, u32 x, u32 y, u32 w) {
+  assert(D != NULL && x < D->n && y < D->n);
+  if (D->m == D->capacity)
+    reserveEdges(D, 2 * D->capacity);
+  u32 e = D->m++;
+  D->ends[2 * e] = x;
+  D->ends[2 * e + 1] = y;
+  D->weights[e] = w;
+  D->alive[e] = true;
+  D->inForest[e] = false;
+  offerEdge(D, e);
+  return e;
+}
+
+/**
+ * @brief Changes the weight of edge `e` to `w`. Decreases, and increases of
+ * edges outside the forest, take O(log n) amortized time; increasing a
+ * forest edge searches for a replacement in O(m log n) time.
+ */
+void dynamicMSTSetWeight(DynamicMST *D, u32 e, u32 w) {
+  assert(D != NULL && e < D->m && D->alive[e]);
+  if (!D->inForest[e]) {
+    D->weights[e] = w;
+    offerEdge(D, e);
+  } else if (w <= D->weights[e]) {
+    // Still minimum: only the path maxima through e change.
+    access(D, D->n + e);
+    D->forestWeight -= D->weights[e] - w;
+    D->weights[e] = w;
+    pullUp(D, D->n + e);
+  } else {
+    cutEdge(D, e);
+    D->weights[e] = w;
+    reconnect(D, D->ends[2 * e], D->ends[2 * e + 1]);
+  }
+}
+
+/**
+ * @brief Removes edge `e`. If it was in the forest, the lightest edge
+ * reconnecting its two halves replaces it, found in O(m log n) time.
+ */
+void dynamicMSTDelete(DynamicMST *D, u32 e) {
+  assert(D != NULL && e < D->m && D->alive[e]);
+  D->alive[e] = false;
+  if (D->inForest[e]) {
+    cutEdge(D, e);
+    reconnect(D, D->ends[2 * e], D->ends[2 * e + 1]);
+  }
+}
+
+/**
+ * @brief Whether `x` and `y` are joined by the live edges.
+ */
+bool dynamicMSTConnected(DynamicMST *D, u32 x, u32 y) {
+  assert(D != NULL && x < D->n && y < D->n);
+  return x == y || findRoot(D, x) == findRoot(D, y);
+}
+
+u64 dynamicMSTWeight(DynamicMST *D) { return D->forestWeight; }
+
+/**
+ * @brief The current minimum spanning forest, as a weighted graph on the n
+ * vertices, to be freed with dumpGraph.
+ */
+Graph *dynamicMSTForest(DynamicMST *D) {
+  assert(D != NULL);
+  Graph *F = initGraph(D->n, D->forestEdges, W_FLAG);
+  u32 i = 0;
+  for (u32 e = 0; e < D->m; e++) {
+    if (D->inForest[e])
+      setEdge(F, i++, D->ends[2 * e], D->ends[2 * e + 1], &D->weights[e],
+              NULL);
+  }
+  formatEdges(F);
+  return F;
+}
+
+void dumpDynamicMST(DynamicMST *D) {
+  if (D == NULL)
+    return;
+  free(D->ends);
+  free(D->weights);
+  free(D->alive);
+  free(D->inForest);
+  free(D->left);
+  free(D->right);
+  free(D->parent);
+  free(D->heaviest);
+  free(D->flip);
+  free(D->stack);
+  free(D);
+}
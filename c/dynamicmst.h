@@ -0,0 +1,68 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file dynamicmst.h
+ * @brief A minimum spanning forest maintained under edge insertions,
+ * deletions and weight changes, on link-cut trees.
+ */
+
+#ifndef DYNAMICMST_H
+#define DYNAMICMST_H
+
+#include "graphStruct.h"
+
+// Nodes 0, ..., n - 1 of the link-cut trees are the vertices and node n + e
+// stands for edge e, so that a tree edge is a node whose weight paths can
+// be maximized over. Slots of deleted edges are not reused.
+typedef struct {
+  u32 n;
+  u32 m;        // edge slots in use
+  u32 capacity; // edge slots allocated
+  u32 *ends;    // ends[2e], ends[2e + 1], the ends of edge e
+  u32 *weights;
+  bool *alive;
+  bool *inForest;
+  u32 forestEdges;
+  u64 forestWeight;
+  // Link-cut tree nodes.
+  u32 *left;
+  u32 *right;
+  u32 *parent;
+  u32 *heaviest; // node of largest weight in the splay subtree
+  bool *flip;
+  u32 *stack; // scratch space for splay
+} DynamicMST;
+
+DynamicMST *createDynamicMST(Graph *G);
+u32 dynamicMSTInsert(DynamicMST *D, u32 x, u32 y, u32 w);
+void dynamicMSTSetWeight(DynamicMST *D, u32 e, u32 w);
+void dynamicMSTDelete(DynamicMST *D, u32 e);
+bool dynamicMSTConnected(DynamicMST *D, u32 x, u32 y);
+u64 dynamicMSTWeight(DynamicMST *D);
+Graph *dynamicMSTForest(DynamicMST *D);
+void dumpDynamicMST(DynamicMST *D);
+
+#endif
@@ -267,51 +267,391 @@ Graph *genFromRandomTree(u32 n, u32 m) {
     return T;
 }
 
+// The graph left while genFromKn removes edges, with a spanning tree of
+// it. adj[v * n + i], i < nUntried[v], are the neighbours of v whose edge
+// has not been tried yet; those from nUntried[v] to degrees[v] were tried
+// and kept. pos[v * n + w] is the index of w in the neighbours of v.
+typedef struct {
+    u32 n;
+    u32 *adj;
+    u32 *pos;
+    u32 *degrees;
+    u32 *nUntried;
+    bool *inTree;   // n x n, whether {v, w} is a tree edge
+    u32 **treeAdj;  // tree neighbours of each vertex
+    u32 *treeDegrees;
+    u32 *marks;     // side marks of the replacement search
+    u32 mark;
+    u32 *queues[2];
+} ShrinkingGraph;
+
+/**
+ * @brief Helper function. Swaps the neighbours at indices i and j of v.
+ */
+static void swapNeighbours(ShrinkingGraph *K, u32 v, u32 i, u32 j) {
+    u32 *row = &K->adj[(u64)v * K->n];
+    u32 x = row[i], y = row[j];
+    row[i] = y;
+    row[j] = x;
+    K->pos[(u64)v * K->n + y] = i;
+    K->pos[(u64)v * K->n + x] = j;
+}
+
+/**
+ * @brief Helper function. Marks the edge from v to w as tried.
+ */
+static void markTried(ShrinkingGraph *K, u32 v, u32 w) {
+    u32 i = K->pos[(u64)v * K->n + w];
+    if (i < K->nUntried[v]) {
+        swapNeighbours(K, v, i, --K->nUntried[v]);
+    }
+}
+
+/**
+ * @brief Helper function. Removes the edge {v, w}, in O(1).
+ */
+static void deleteNeighbour(ShrinkingGraph *K, u32 v, u32 w) {
+    markTried(K, v, w);
+    swapNeighbours(K, v, K->pos[(u64)v * K->n + w], --K->degrees[v]);
+}
+
+/**
+ * @brief Helper function. Adds w to the tree neighbours of v.
+ */
+static void pushTreeNeighbour(ShrinkingGraph *K, u32 v, u32 w) {
+    u32 d = K->treeDegrees[v];
+    if ((d & (d - 1)) == 0) { // full at powers of two
+        K->treeAdj[v] = (u32 *)realloc(K->treeAdj[v],
+                                       (d == 0 ? 1 : 2 * d) * sizeof(u32));
+        if (K->treeAdj[v] == NULL) {
+            printf("Error: realloc failed\n");
+            exit(1);
+        }
+    }
+    K->treeAdj[v][K->treeDegrees[v]++] = w;
+}
+
+/**
+ * @brief Helper function. Removes w from the tree neighbours of v.
+ */
+static void dropTreeNeighbour(ShrinkingGraph *K, u32 v, u32 w) {
+    u32 *T = K->treeAdj[v];
+    u32 i = 0;
+    while (T[i] != w) {
+        i++;
+    }
+    T[i] = T[--K->treeDegrees[v]];
+}
+
+/**
+ * @brief Helper function. Adds {v, w} to the spanning tree.
+ */
+static void linkTree(ShrinkingGraph *K, u32 v, u32 w) {
+    pushTreeNeighbour(K, v, w);
+    pushTreeNeighbour(K, w, v);
+    K->inTree[(u64)v * K->n + w] = K->inTree[(u64)w * K->n + v] = true;
+}
+
+/**
+ * @brief Helper function. Removes {v, w} from the spanning tree.
+ */
+static void cutTree(ShrinkingGraph *K, u32 v, u32 w) {
+    dropTreeNeighbour(K, v, w);
+    dropTreeNeighbour(K, w, v);
+    K->inTree[(u64)v * K->n + w] = K->inTree[(u64)w * K->n + v] = false;
+}
+
+/**
+ * @brief Helper function. Removes the tree edge {v, w} unless it is a
+ * bridge, in which case it is kept.
+ *
+ * The tree is cut at {v, w} and both halves are searched breadth-first in
+ * lockstep, one tree edge at a time, until one of them is exhausted. That
+ * is the smaller half, found in time proportional to its size. Its edges
+ * are then scanned for one leaving it, which replaces {v, w} in the tree.
+ *
+ * @return Whether the edge was removed.
+ */
+static bool removeTreeEdge(ShrinkingGraph *K, u32 v, u32 w) {
+    cutTree(K, v, w);
+    u32 roots[2] = {v, w}, heads[2] = {0, 0}, tails[2] = {1, 1};
+    u32 next[2] = {0, 0}, side = 0;
+    K->mark += 2;
+    for (u32 s = 0; s < 2; s++) {
+        K->queues[s][0] = roots[s];
+        K->marks[roots[s]] = K->mark + s;
+    }
+    while (true) {
+        u32 *Q = K->queues[side];
+        if (heads[side] == tails[side]) {
+            break;
+        }
+        u32 u = Q[heads[side]];
+        if (next[side] == K->treeDegrees[u]) {
+            heads[side]++;
+            next[side] = 0;
+        } else {
+            u32 x = K->treeAdj[u][next[side]++];
+            if (K->marks[x] != K->mark + side) {
+                K->marks[x] = K->mark + side;
+                Q[tails[side]++] = x;
+            }
+        }
+        side ^= 1;
+    }
+
+    u32 *S = K->queues[side], mark = K->mark + side;
+    for (u32 i = 0; i < tails[side]; i++) {
+        u32 u = S[i];
+        u32 *row = &K->adj[(u64)u * K->n];
+        for (u32 j = 0; j < K->degrees[u]; j++) {
+            u32 x = row[j];
+            if (K->marks[x] == mark || (u == roots[side] && x == roots[!side]))
+                continue;
+            linkTree(K, u, x);
+            deleteNeighbour(K, v, w);
+            deleteNeighbour(K, w, v);
+            return true;
+        }
+    }
+    linkTree(K, v, w);
+    return false;
+}
+
 /**
  * @brief Generates a connected graph by removing edges from a complete graph.
+ *
+ * Random edges are removed unless they are bridges. The remaining graph is
+ * kept as adjacency arrays with O(1) removal, together with a spanning
+ * tree. Removing an edge off the tree never disconnects the graph, so only
+ * tree edges need a search for a replacement, see removeTreeEdge. A tree
+ * edge is tried with probability about n / |E|, so over the run there are
+ * about n log(n^2 / m) such searches, each usually over a small half.
+ *
  * @param n Number of vertices in the graph.
  * @param m Number of edges to retain in the graph.
  * @return Pointer to the generated connected graph.
  */
 Graph *genFromKn(u32 n, u32 m) {
-    assert(m <= n*(n-1)/2 && m >= n - 1);
-   
-    Graph *Kn = genCompleteGraph(n);
-    u32** Γ = genGammas(Kn);
-    u32* R = genArray(n);
-    u32* nCandidates = genArray(n);
+    u64 pairs = (u64)n * (n - 1) / 2;
+    assert(n > 0 && m <= pairs && m >= n - 1);
 
-    for (u32 i = 0; i < n; i++) {
-        R[i] = i;
-        nCandidates[i] = n-1;
+    ShrinkingGraph K;
+    K.n = n;
+    K.adj = (u32 *)malloc((u64)n * n * sizeof(u32));
+    K.pos = (u32 *)malloc((u64)n * n * sizeof(u32));
+    K.inTree = (bool *)calloc((u64)n * n, sizeof(bool));
+    K.treeAdj = (u32 **)calloc(n, sizeof(u32 *));
+    K.degrees = genArray(n);
+    K.nUntried = genArray(n);
+    K.treeDegrees = genArray(n);
+    K.marks = genArray(n);
+    K.queues[0] = genArray(n);
+    K.queues[1] = genArray(n);
+    K.mark = 0;
+    u32 *R = genArray(n);
+    u32 *rPos = genArray(n);
+    if (K.adj == NULL || K.pos == NULL || K.inTree == NULL ||
+        K.treeAdj == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    for (u32 v = 0; v < n; v++) {
+        u32 i = 0;
+        for (u32 w = 0; w < n; w++) {
+            if (w != v) {
+                K.adj[(u64)v * n + i] = w;
+                K.pos[(u64)v * n + w] = i++;
+            }
+        }
+        K.degrees[v] = K.nUntried[v] = n - 1;
+        K.treeDegrees[v] = 0;
+        K.marks[v] = 0;
+        R[v] = rPos[v] = v;
+    }
+    for (u32 v = 1; v < n; v++) {
+        linkTree(&K, 0, v);
     }
 
+    u64 edges = pairs;
     u32 nRemovable = n;
-    while (numberOfEdges(Kn) > m) {
-        u32 vIndex = generate_random_u32_in_range(0, nRemovable-1); 
-        u32 v = R[vIndex];
-        u32 wIndex = generate_random_u32_in_range(0, nCandidates[v] - 1);
-        u32 w = Γ[v][wIndex];
-
-        removeElement(&( Γ[v] ), &( nCandidates[v] ), wIndex);
-        removeTargetElement(Γ[w], &( nCandidates[w] ), v);
-        
-        if (BFSSearch(Kn, v, w)) {
-            removeEdge(Kn, min(v, w), max(v, w));
+    while (edges > m) {
+        u32 v = R[generate_random_u32_in_range(0, nRemovable - 1)];
+        u32 i = generate_random_u32_in_range(0, K.nUntried[v] - 1);
+        u32 w = K.adj[(u64)v * n + i];
+        markTried(&K, v, w);
+        markTried(&K, w, v);
+
+        if (!K.inTree[(u64)v * n + w]) {
+            deleteNeighbour(&K, v, w);
+            deleteNeighbour(&K, w, v);
+            edges--;
+        } else if (removeTreeEdge(&K, v, w)) {
+            edges--;
         }
-        if (degree(v, Kn) == 1 || nCandidates[v] == 0) {
-            removeElement(&R, &nRemovable, vIndex);
+        u32 ends[2] = {v, w};
+        for (u32 e = 0; e < 2; e++) {
+            u32 x = ends[e];
+            if (rPos[x] != UINT32_MAX &&
+                (K.degrees[x] == 1 || K.nUntried[x] == 0)) {
+                u32 last = R[--nRemovable];
+                R[rPos[x]] = last;
+                rPos[last] = rPos[x];
+                rPos[x] = UINT32_MAX;
+            }
         }
-        if (degree(w, Kn) == 1 || nCandidates[w] == 0) {
-            removeTargetElement(R, &nRemovable, w);
+    }
+
+    Graph *G = initGraph(n, (u32)edges, STD_FLAG);
+    u32 k = 0;
+    for (u32 v = 0; v < n; v++) {
+        for (u32 j = 0; j < K.degrees[v]; j++) {
+            u32 w = K.adj[(u64)v * n + j];
+            if (v < w) {
+                setEdge(G, k++, v, w, NULL, NULL);
+            }
         }
     }
-    free(nCandidates);
+    formatEdges(G);
+
+    for (u32 v = 0; v < n; v++) {
+        free(K.treeAdj[v]);
+    }
+    free(K.treeAdj);
+    free(K.adj);
+    free(K.pos);
+    free(K.inTree);
+    free(K.degrees);
+    free(K.nUntried);
+    free(K.treeDegrees);
+    free(K.marks);
+    free(K.queues[0]);
+    free(K.queues[1]);
     free(R);
-    for (u32 i = 0; i < numberOfVertices(Kn); i++) {
-        free(Γ[i]);
+    free(rPos);
+    return G;
+}
+
+/**
+ * @brief Helper function. Orders u64 values increasingly.
+ */
+static int compareU64(const void *a, const void *b) {
+    u64 x = *(const u64 *)a;
+    u64 y = *(const u64 *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Helper function. Builds a weighted graph from an array of edges
+ * encoded as (x << 32 | y) with x < y, dropping duplicates. Weights are drawn
+ * uniformly from [1, maxWeight].
+ */
+static Graph *weightedGraphFromKeys(u32 n, u64 *keys, u32 nKeys, u32 maxWeight) {
+    qsort(keys, nKeys, sizeof(u64), compareU64);
+    u32 m = 0;
+    for (u32 i = 0; i < nKeys; i++) {
+        if (i == 0 || keys[i] != keys[i - 1]) {
+            keys[m++] = keys[i];
+        }
+    }
+    Graph *G = initGraph(n, m, W_FLAG);
+    for (u32 i = 0; i < m; i++) {
+        u32 w = generate_random_u32_in_range(1, maxWeight);
+        setEdge(G, i, (u32)(keys[i] >> 32), (u32)keys[i], &w, NULL);
+    }
+    formatEdges(G);
+    return G;
+}
+
+/**
+ * @brief Generates a Graph500-style Kronecker (R-MAT) weighted graph.
+ *
+ * Each of the edgeFactor * 2^scale candidate edges picks its endpoints by
+ * recursively descending into one quadrant of the adjacency matrix with
+ * probabilities (0.57, 0.19, 0.19, 0.05). Vertex labels are then permuted,
+ * and self loops and duplicated edges are dropped. The result is a sparse,
+ * low-diameter graph with a skewed degree distribution.
+ *
+ * @param scale Logarithm (base 2) of the number of vertices.
+ * @param edgeFactor Average number of candidate edges per vertex.
+ * @param maxWeight Weights are drawn uniformly from [1, maxWeight].
+ * @return Pointer to the generated graph.
+ */
+Graph *genKronecker(u32 scale, u32 edgeFactor, u32 maxWeight) {
+    assert(scale > 0 && scale < 32);
+    u32 n = 1u << scale;
+    u32 candidates = edgeFactor * n;
+    u64 *keys = (u64 *)malloc(candidates * sizeof(u64));
+    u32 *permutation = genArray(n);
+    if (keys == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    for (u32 i = 0; i < n; i++) {
+        permutation[i] = i;
+    }
+    for (u32 i = n - 1; i > 0; i--) {
+        swap_u32_pointers(&permutation[i],
+                          &permutation[generate_random_u32_in_range(0, i)]);
+    }
+
+    u32 nKeys = 0;
+    for (u32 k = 0; k < candidates; k++) {
+        u32 x = 0, y = 0;
+        for (u32 bit = 0; bit < scale; bit++) {
+            u32 r = generate_random_u32_in_range(0, 99);
+            // Quadrants: A = 57%, B = 19%, C = 19%, D = 5%.
+            u32 xBit = r >= 76;
+            u32 yBit = (r >= 57 && r < 76) || r >= 95;
+            x = (x << 1) | xBit;
+            y = (y << 1) | yBit;
+        }
+        x = permutation[x];
+        y = permutation[y];
+        if (x == y) {
+            continue;
+        }
+        keys[nKeys++] = ((u64)min(x, y) << 32) | max(x, y);
     }
-    free(Γ);
-    formatEdges(Kn);
-    return Kn;
+    Graph *G = weightedGraphFromKeys(n, keys, nKeys, maxWeight);
+    free(keys);
+    free(permutation);
+    return G;
+}
+
+/**
+ * @brief Generates a rows x cols grid with random weights, a stand-in for
+ * road networks: bounded degree and large diameter.
+ *
+ * Vertex (i, j) is labelled i * cols + j and is adjacent to the vertices
+ * above, below, left and right of it.
+ *
+ * @param maxWeight Weights are drawn uniformly from [1, maxWeight].
+ * @return Pointer to the generated graph.
+ */
+Graph *genGrid(u32 rows, u32 cols, u32 maxWeight) {
+    assert(rows > 0 && cols > 0);
+    u32 n = rows * cols;
+    u32 m = rows * (cols - 1) + cols * (rows - 1);
+    u64 *keys = (u64 *)malloc(max(m, 1) * sizeof(u64));
+    if (keys == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    u32 nKeys = 0;
+    for (u32 i = 0; i < rows; i++) {
+        for (u32 j = 0; j < cols; j++) {
+            u32 v = i * cols + j;
+            if (j + 1 < cols) {
+                keys[nKeys++] = ((u64)v << 32) | (v + 1);
+            }
+            if (i + 1 < rows) {
+                keys[nKeys++] = ((u64)v << 32) | (v + cols);
+            }
+        }
+    }
+    Graph *G = weightedGraphFromKeys(n, keys, nKeys, maxWeight);
+    free(keys);
+    return G;
 }
@@ -42,3 +42,5 @@ Graph *genCGraphUnbound(u32 n);
 Graph *genFromKn(u32 n, u32 m);
 u32** genGammas(Graph *G);
 Graph *randomTree(u32 n);
+Graph *genKronecker(u32 scale, u32 edgeFactor, u32 maxWeight);
+Graph *genGrid(u32 rows, u32 cols, u32 maxWeight);
@@ -44,6 +44,7 @@ typedef unsigned int g_flag;
 #define NETFLOW_FLAG (( W_FLAG | D_FLAG ) | CAP_FLAG) // 1110
 
 typedef uint32_t u32;
+typedef uint64_t u64;
 typedef u32 color;
 
 typedef struct {
@@ -47,84 +47,93 @@
 // Network search
 //
 
-InsertionArray *flowBFS(Graph *G, u32 s, u32 target) {
+bool workspaceFlowBFS(Graph *G, u32 s, u32 target, SearchWorkspace *W) {
   assert(s != target);
   assert(G->_g_flag == NETFLOW_FLAG);
-
-  u32 n = numberOfVertices(G);
-  u32 *visited = genArray(n);
-  u32 treeVertexCount = 1; // root included necessarily
-  InsertionArray *insertionArray = createInsertionArray(n);
-
-  struct Queue *Q = createQueue();
-  enQueue(Q, s);
-  bool found = 0;
-
-  while (Q->front != NULL && !found) {
-
-    u32 v = pop(Q);
+  assert(W != NULL && W->n >= numberOfVertices(G));
+
+  resetWorkspace(W);
+  u32 epoch = W->epoch;
+  u32 head = 0, tail = 0;
+  W->stamp[s] = epoch;
+  W->parents[s] = s;
+  W->parentEdges[s] = NO_PARENT;
+  W->frontier[tail++] = s;
+
+  while (head < tail) {
+    u32 v = W->frontier[head++];
     u32 d = degree(v, G);
 
     for (u32 i = 0; i < d; i++) {
       u32 iNeighbour = neighbour(i, v, G);
-      if (getRemainingCapacity(v, iNeighbour, G) == 0)
+      if (W->stamp[iNeighbour] == epoch)
         continue;
-      if (visited[iNeighbour] != 0 || iNeighbour == s) {
+      if (getRemainingCapacity(v, iNeighbour, G) == 0)
         continue;
-      }
-      if (iNeighbour == target) {
-
-        insArrayStore(target, v, insertionArray);
-        found = true;
-        break;
-      }
-      visited[iNeighbour] = 1;
-      enQueue(Q, iNeighbour);
-      insArrayStore(iNeighbour, v, insertionArray);
+      W->stamp[iNeighbour] = epoch;
+      W->parents[iNeighbour] = v;
+      W->parentEdges[iNeighbour] = firstNeighbourIndex(G, v) + i;
+      if (iNeighbour == target)
+        return true;
+      W->frontier[tail++] = iNeighbour;
     }
   }
-
-  dumpQueue(Q);
-  free(visited);
-  if (!found)
-    return NULL;
-  return insertionArray;
+  return false;
 }
 
-void flowDFSRecursive(u32 v, InsertionArray *track, u32 root, u32 t, bool *flag,
-                      Graph *G) {
-  assert(G->_g_flag == NETFLOW_FLAG);
-  for (u32 i = 0; i < degree(v, G); i++) {
-    if (*flag)
-      return;
-    u32 iNeighbour = neighbour(i, v, G);
-    if (getRemainingCapacity(v, iNeighbour, G) == 0)
-      continue;
-    // insArrayGet(index, insArray) is not -1 only if the index has been
-    // previously set, i.e. the vertex has been traversed already
-    if (insArrayGet(iNeighbour, track) != -1)
-      continue;
-
-    insArrayStore(iNeighbour, v, track);
-    if (iNeighbour == t) {
-      *flag = true;
-      return;
-    }
-    flowDFSRecursive(iNeighbour, track, iNeighbour, t, flag, G);
+InsertionArray *flowBFS(Graph *G, u32 s, u32 target) {
+  u32 n = numberOfVertices(G);
+  SearchWorkspace *W = createSearchWorkspace(n);
+  if (!workspaceFlowBFS(G, s, target, W)) {
+    dumpSearchWorkspace(W);
+    return NULL;
   }
+  InsertionArray *insertionArray = createInsertionArray(n);
+  for (u32 v = target; v != s; v = W->parents[v])
+    insArrayStore(v, W->parents[v], insertionArray);
+  dumpSearchWorkspace(W);
+  return insertionArray;
 }
 
 InsertionArray *flowDFS(Graph *G, u32 s, u32 target) {
   assert(G->_g_flag == NETFLOW_FLAG);
 
-  bool *flag = (bool *)malloc(sizeof(bool));
-  *flag = false;
   u32 n = numberOfVertices(G);
   InsertionArray *insertionArray = createInsertionArray(n);
+  // insArrayGet(index, insArray) is not -1 only if the index has been
+  // previously set, i.e. the vertex has been traversed already
   insArrayStore(s, n + 1, insertionArray);
-  flowDFSRecursive(s, insertionArray, s, target, flag, G);
-  if (insArrayGet(target, insertionArray) == -1)
+  DFSFrame *stack = (DFSFrame *)malloc((n + 1) * sizeof(DFSFrame));
+  if (stack == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 top = 0;
+  stack[top++] = (DFSFrame){s, firstNeighbourIndex(G, s)};
+  bool found = false;
+
+  while (top > 0 && !found) {
+    DFSFrame *frame = &stack[top - 1];
+    u32 v = frame->vertex;
+    u32 last = firstNeighbourIndex(G, v) + degree(v, G);
+    if (frame->next == last) {
+      top--;
+      continue;
+    }
+    u32 w = (G->_edges)[frame->next++].y;
+    if (insArrayGet(w, insertionArray) != -1)
+      continue;
+    if (getRemainingCapacity(v, w, G) == 0)
+      continue;
+    insArrayStore(w, v, insertionArray);
+    found = w == target;
+    stack[top++] = (DFSFrame){w, firstNeighbourIndex(G, w)};
+  }
+  free(stack);
+  if (!found) {
+    dumpInsertionArray(insertionArray);
     return NULL;
+  }
   return (insertionArray);
 }
 
@@ -30,6 +30,7 @@
 
 #include "api.h"
 #include "insertionArray.h"
+#include "workspace.h"
 
 typedef InsertionArray *(*SearchFunction)(Graph *G, u32 s, u32 target);
 
@@ -51,24 +52,17 @@ typedef InsertionArray *(*SearchFunction)(Graph *G, u32 s, u32 target);
 InsertionArray *flowBFS(Graph *G, u32 s, u32 target);
 
 /**
- * @brief Recursively performs depth-first search (DFS) on a flow network graph
- * to find a path from the source to the target.
+ * @brief Performs the same search as flowBFS in a reusable workspace,
+ * without allocating.
  *
- * @param v The current vertex being visited.
- * @param track Pointer to an InsertionArray that tracks the path from source to
- * target.
- * @param root The starting vertex for the DFS search.
- * @param t The target vertex to be reached.
- * @param flag Pointer to a boolean that signals whether the target has been
- * found.
  * @param G Pointer to the flow network graph.
- *
- * This recursive function navigates through each neighbor of the current
- * vertex, verifying available capacity on each edge, and stores the path in an
- * InsertionArray if a path to the target exists.
+ * @param s The source vertex.
+ * @param target The target vertex.
+ * @param W Workspace for graphs of at least n vertices.
+ * @return true if an augmenting path exists. It is then found by following
+ * W->parents from `target` back to `s`.
  */
-void flowDFSRecursive(u32 v, InsertionArray *track, u32 root, u32 t, bool *flag,
-                      Graph *G);
+bool workspaceFlowBFS(Graph *G, u32 s, u32 target, SearchWorkspace *W);
 
 /**
  * @brief Initiates a depth-first search (DFS) on a flow network graph from a
@@ -80,10 +74,11 @@ void flowDFSRecursive(u32 v, InsertionArray *track, u32 root, u32 t, bool *flag,
  * @return Pointer to an InsertionArray containing the path from source to
  * target if found, or NULL if no path exists.
  *
- * This function calls the recursive flowDFSRecursive function to perform DFS
- * and track the path from the source vertex to the target vertex. If a path is
- * found, it is stored in an InsertionArray and returned. Otherwise, it returns
- * NULL.
+ * The search keeps an explicit stack of (vertex, next edge) frames instead of
+ * recursing, so long paths cannot overflow the C stack. It only follows edges
+ * with remaining capacity and tracks the path from the source vertex to the
+ * target vertex. If a path is found, it is stored in an InsertionArray and
+ * returned. Otherwise, it returns NULL.
  */
 InsertionArray *flowDFS(Graph *G, u32 s, u32 target);
 
@@ -32,6 +32,7 @@
  */
 
 #include "heap.h"
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -172,3 +173,148 @@ void printHeap(Heap *heap) {
   }
   printf("\n");
 }
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Indexed heap ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Creates an empty indexed heap for labels in [0, capacity).
+ *
+ * The heap is HEAP_ARITY-ary: shallower than a binary heap, which makes
+ * the frequent `decreaseKey` cheaper at a small cost for `indexedExtractMin`.
+ *
+ * @return A pointer to the allocated heap.
+ */
+IndexedHeap *createIndexedHeap(u32 capacity) {
+  IndexedHeap *heap = (IndexedHeap *)malloc(sizeof(IndexedHeap));
+  if (heap == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  heap->array = (HeapNode *)malloc(capacity * sizeof(HeapNode));
+  heap->position = (u32 *)malloc(capacity * sizeof(u32));
+  if (capacity > 0 && (heap->array == NULL || heap->position == NULL)) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  for (u32 i = 0; i < capacity; i++)
+    heap->position[i] = HEAP_ABSENT;
+  heap->capacity = capacity;
+  heap->size = 0;
+  return heap;
+}
+
+/**
+ * @brief Frees the memory allocated for an indexed heap.
+ */
+void dumpIndexedHeap(IndexedHeap *heap) {
+  free(heap->array);
+  free(heap->position);
+  free(heap);
+}
+
+/**
+ * @brief Returns `true` iff a node with the given label is in the heap.
+ */
+bool heapContains(IndexedHeap *heap, u32 label) {
+  return (heap->position[label] != HEAP_ABSENT);
+}
+
+/**
+ * @brief Helper function. Places `node` at index `i`, updating its position.
+ */
+static void placeNode(IndexedHeap *heap, u32 i, HeapNode node) {
+  heap->array[i] = node;
+  heap->position[node.label] = i;
+}
+
+/**
+ * @brief Helper function. Moves the node at index `i` up until its parent is
+ * not greater than it. Nodes are shifted rather than swapped.
+ */
+static void siftUp(IndexedHeap *heap, u32 i) {
+  HeapNode node = heap->array[i];
+  while (i != 0) {
+    u32 parent = (i - 1) / HEAP_ARITY;
+    if (heap->array[parent].value <= node.value)
+      break;
+    placeNode(heap, i, heap->array[parent]);
+    i = parent;
+  }
+  placeNode(heap, i, node);
+}
+
+/**
+ * @brief Helper function. Moves the node at index `i` down until none of its
+ * children is smaller than it.
+ */
+static void siftDown(IndexedHeap *heap, u32 i) {
+  HeapNode node = heap->array[i];
+  while (true) {
+    u32 first = HEAP_ARITY * i + 1;
+    if (first >= heap->size)
+      break;
+    u32 last = first + HEAP_ARITY < heap->size ? first + HEAP_ARITY : heap->size;
+    u32 smallest = first;
+    for (u32 c = first + 1; c < last; c++) {
+      if (heap->array[c].value < heap->array[smallest].value)
+        smallest = c;
+    }
+    if (heap->array[smallest].value >= node.value)
+      break;
+    placeNode(heap, i, heap->array[smallest]);
+    i = smallest;
+  }
+  placeNode(heap, i, node);
+}
+
+/**
+ * @brief Inserts a node with a label not yet in the heap.
+ */
+void indexedInsert(IndexedHeap *heap, u32 label, u32 value) {
+  assert(label < heap->capacity);
+  assert(!heapContains(heap, label));
+  u32 i = heap->size++;
+  placeNode(heap, i, (HeapNode){label, value});
+  siftUp(heap, i);
+}
+
+/**
+ * @brief Lowers the value of the node with the given label to `value`.
+ *
+ * @pre The label is in the heap and `value` is not greater than its current
+ * value.
+ */
+void decreaseKey(IndexedHeap *heap, u32 label, u32 value) {
+  assert(heapContains(heap, label));
+  u32 i = heap->position[label];
+  assert(value <= heap->array[i].value);
+  heap->array[i].value = value;
+  siftUp(heap, i);
+}
+
+/**
+ * @brief Removes and returns the node of minimum value.
+ *
+ * @pre The heap is not empty.
+ */
+HeapNode indexedExtractMin(IndexedHeap *heap) {
+  assert(heap->size > 0);
+  HeapNode minNode = heap->array[0];
+  heap->position[minNode.label] = HEAP_ABSENT;
+  heap->size--;
+  if (heap->size > 0) {
+    placeNode(heap, 0, heap->array[heap->size]);
+    siftDown(heap, 0);
+  }
+  return minNode;
+}
+
+/**
+ * @brief Removes all nodes from the heap in O(size) time, so that it can be
+ * reused without reallocating it.
+ */
+void clearIndexedHeap(IndexedHeap *heap) {
+  for (u32 i = 0; i < heap->size; i++)
+    heap->position[heap->array[i].label] = HEAP_ABSENT;
+  heap->size = 0;
+}
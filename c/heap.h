@@ -23,7 +23,11 @@
 *software.
  */
 
+#ifndef HEAP_H
+#define HEAP_H
+
 #include "graphStruct.h"
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -38,6 +42,18 @@ typedef struct {
   u32 size;
 } Heap;
 
+// An indexed min heap holds at most one node per label in [0, capacity) and
+// keeps the position of each label, so that its value can be decreased.
+typedef struct {
+  HeapNode *array;
+  u32 *position; // position[label] in array, or HEAP_ABSENT
+  u32 capacity;
+  u32 size;
+} IndexedHeap;
+
+#define HEAP_ABSENT 0xFFFFFFFF
+#define HEAP_ARITY 4
+
 Heap *createHeap(u32 capacity);
 void swap(HeapNode *a, HeapNode *b);
 void heapify(Heap *heap, u32 i);
@@ -45,3 +61,13 @@ void insert(Heap *heap, u32 label, u32 value);
 HeapNode extractMin(Heap *heap);
 void printHeap(Heap *heap);
 void dumpHeap(Heap *heap);
+
+IndexedHeap *createIndexedHeap(u32 capacity);
+void dumpIndexedHeap(IndexedHeap *heap);
+bool heapContains(IndexedHeap *heap, u32 label);
+void indexedInsert(IndexedHeap *heap, u32 label, u32 value);
+void decreaseKey(IndexedHeap *heap, u32 label, u32 value);
+HeapNode indexedExtractMin(IndexedHeap *heap);
+void clearIndexedHeap(IndexedHeap *heap);
+
+#endif
@@ -0,0 +1,490 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file kruskal.c
+ * @brief Kruskal's algorithm: edges are scanned by increasing weight and
+ * kept when they join two different trees of the forest built so far.
+ *
+ * Edges are sorted with an LSD radix sort on the 32 bits of their weight,
+ * one byte per pass, in parallel when a pool is given. Passes in which all
+ * edges share the same byte are skipped, so small weights cost one or two
+ * passes.
+ */
+
+#include "kruskal.h"
+#include "api.h"
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+typedef struct {
+  KeyedEdge *edges;
+  KeyedEdge *buffer;
+  u32 k;
+  u32 *counts; // RADIX_BUCKETS counters per thread
+  bool skip;   // whether every key has the same digit in this pass
+  ThreadPool *pool;
+} SortContext;
+
+/**
+ * @brief Task. Sorts a block of the keys per thread through every pass:
+ * each thread counts the digits of its block, thread 0 turns the counts
+ * into offsets (bucket-major, then by thread, which keeps the sort
+ * stable), and each thread scatters its block.
+ */
+static void radixTask(u32 thread, u32 nThreads, void *ctx) {
+  SortContext *C = (SortContext *)ctx;
+  u32 lo = (u64)C->k * thread / nThreads;
+  u32 hi = (u64)C->k * (thread + 1) / nThreads;
+  u32 *counts = C->counts + thread * RADIX_BUCKETS;
+  KeyedEdge *src = C->edges, *dst = C->buffer;
+
+  for (u32 shift = 32; shift < 64; shift += RADIX_BITS) {
+    memset(counts, 0, RADIX_BUCKETS * sizeof(u32));
+    for (u32 i = lo; i < hi; i++)
+      counts[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++;
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+
+    if (thread == 0) {
+      u32 running = 0;
+      C->skip = false;
+      for (u32 b = 0; b < RADIX_BUCKETS; b++) {
+        u32 start = running;
+        for (u32 t = 0; t < nThreads; t++) {
+          u32 c = C->counts[t * RADIX_BUCKETS + b];
+          C->counts[t * RADIX_BUCKETS + b] = running;
+          running += c;
+        }
+        if (running - start == C->k)
+          C->skip = true;
+      }
+    }
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+
+    if (!C->skip) {
+      for (u32 i = lo; i < hi; i++)
+        dst[counts[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+      KeyedEdge *t = src;
+      src = dst;
+      dst = t;
+    }
+    if (C->pool != NULL)
+      poolBarrier(C->pool);
+  }
+  if (thread == 0)
+    C->buffer = src;
+}
+
+/**
+ * @brief Helper function. Sorts k edges by weight, stably.
+ *
+ * @return Either `edges` or `buffer`, whichever holds the sorted edges.
+ */
+static KeyedEdge *radixSort(KeyedEdge *edges, KeyedEdge *buffer, u32 k,
+                            ThreadPool *pool) {
+  if (k < KRUSKAL_PARALLEL_SORT)
+    pool = NULL;
+  u32 nThreads = poolSize(pool);
+  SortContext C = {edges, buffer, k, NULL, false, pool};
+  C.counts = genArray(nThreads * RADIX_BUCKETS);
+  if (pool == NULL)
+    radixTask(0, 1, &C);
+  else
+    poolRun(pool, radixTask, &C);
+  free(C.counts);
+  // C.buffer now points to the sorted array.
+  return C.buffer;
+}
+
+/**
+ * @brief Allocates `edges` and `buffer`, with room for every edge of the
+ * undirected graph `G`, and fills `edges` with its edges in the order of
+ * G->_edges. Self-loops are left out.
+ *
+ * @return The number of edges written.
+ */
+u32 keyedEdges(Graph *G, KeyedEdge **edges, KeyedEdge **buffer) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(!(G->_g_flag & D_FLAG));
+  assert(isFormatted(G));
+  u32 entries = 2 * numberOfEdges(G);
+  *edges = (KeyedEdge *)malloc((entries / 2 + 1) * sizeof(KeyedEdge));
+  *buffer = (KeyedEdge *)malloc((entries / 2 + 1) * sizeof(KeyedEdge));
+  if (*edges == NULL || *buffer == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 count = 0;
+  for (u32 i = 0; i < entries; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x < e.y)
+      (*edges)[count++] = (KeyedEdge){(u64)*(e.w) << 32 | i, e.x, e.y};
+  }
+  return count;
+}
+
+/**
+ * @brief Sorts the edges of the undirected graph `G` by weight, ties broken
+ * by position. Self-loops are left out.
+ *
+ * @param[out] k Receives the number of edges sorted.
+ * @return An array of k edges, to be freed by the caller.
+ */
+KeyedEdge *sortEdgesByWeight(Graph *G, u32 *k, ThreadPool *pool) {
+  assert(k != NULL);
+  KeyedEdge *edges, *buffer;
+  *k = keyedEdges(G, &edges, &buffer);
+  KeyedEdge *sorted = radixSort(edges, buffer, *k, pool);
+  free(sorted == edges ? buffer : edges);
+  return sorted;
+}
+
+/**
+ * @brief Computes a minimum spanning forest of `G` with Kruskal's
+ * algorithm, in O(m α(n)) time after an O(m) radix sort. The scan stops as
+ * soon as n - 1 edges are kept.
+ *
+ * @param[out] chosen Receives the indices in G->_edges of the edges of the
+ * forest; it must have room for n - 1 of them.
+ * @param[out] totalWeight If not NULL, receives the weight of the forest.
+ * @return The number of edges of the forest.
+ */
+u32 kruskalEdges(Graph *G, u32 *chosen, u64 *totalWeight, ThreadPool *pool) {
+  assert(chosen != NULL || numberOfVertices(G) <= 1);
+  u32 n = numberOfVertices(G);
+  u32 k;
+  KeyedEdge *sorted = sortEdgesByWeight(G, &k, pool);
+  UnionFind *U = createUnionFind(n);
+
+  u32 count = 0;
+  u64 total = 0;
+  for (u32 i = 0; i < k && count + 1 < n; i++) {
+    if (unionSets(U, sorted[i].x, sorted[i].y)) {
+      chosen[count++] = (u32)sorted[i].key;
+      total += sorted[i].key >> 32;
+    }
+  }
+
+  if (totalWeight != NULL)
+    *totalWeight = total;
+  dumpUnionFind(U);
+  free(sorted);
+  return count;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Filter-Kruskal ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef struct {
+  Graph *G;
+  UnionFind *U;
+  u32 *chosen;
+  u32 count;
+  ThreadPool *pool;
+} FilterContext;
+
+typedef struct {
+  UnionFind *U;
+  KeyedEdge *src;
+  KeyedEdge *dst;
+  u32 k;
+  u64 pivot;
+  bool filter; // whether to drop the edges inside a tree
+  u32 *counts; // per thread, edges at most and above the pivot
+  u32 low;     // how many edges are at most the pivot
+  u32 high;    // how many are above it
+  ThreadPool *pool;
+} SplitContext;
+
+/**
+ * @brief Helper function. Whether `e` joins two trees of the forest built
+ * so far.
+ */
+static bool isCrossing(UnionFind *U, KeyedEdge *e) {
+  return concurrentFindSet(U, e->x) != concurrentFindSet(U, e->y);
+}
+
+/**
+ * @brief Task. Splits the edges around the pivot, dropping those inside a
+ * tree if asked to, each thread handling one block: blocks are counted first, so
+ * that every thread then writes at its own offsets.
+ */
+static void splitTask(u32 thread, u32 nThreads, void *ctx) {
+  SplitContext *C = (SplitContext *)ctx;
+  u32 lo = (u64)C->k * thread / nThreads;
+  u32 hi = (u64)C->k * (thread + 1) / nThreads;
+  u32 low = 0, high = 0;
+  for (u32 i = lo; i < hi; i++) {
+    if (!C->filter || isCrossing(C->U, &C->src[i])) {
+      if (C->src[i].key <= C->pivot)
+        low++;
+      else
+        high++;
+    }
+  }
+  C->counts[2 * thread] = low;
+  C->counts[2 * thread + 1] = high;
+  if (C->pool != NULL)
+    poolBarrier(C->pool);
+
+  if (thread == 0) {
+    u32 totalLow = 0, totalHigh = 0;
+    for (u32 t = 0; t < nThreads; t++) {
+      totalLow += C->counts[2 * t];
+      totalHigh += C->counts[2 * t + 1];
+    }
+    u32 runningLow = 0, runningHigh = totalLow;
+    for (u32 t = 0; t < nThreads; t++) {
+      u32 c = C->counts[2 * t];
+      C->counts[2 * t] = runningLow;
+      runningLow += c;
+      c = C->counts[2 * t + 1];
+      C->counts[2 * t + 1] = runningHigh;
+      runningHigh += c;
+    }
+    C->low = totalLow;
+    C->high = totalHigh;
+  }
+  if (C->pool != NULL)
+    poolBarrier(C->pool);
+
+  // No tree has changed, so the same edges are found crossing.
+  u32 nextLow = C->counts[2 * thread];
+  u32 nextHigh = C->counts[2 * thread + 1];
+  for (u32 i = lo; i < hi; i++) {
+    if (!C->filter || isCrossing(C->U, &C->src[i])) {
+      if (C->src[i].key <= C->pivot)
+        C->dst[nextLow++] = C->src[i];
+      else
+        C->dst[nextHigh++] = C->src[i];
+    }
+  }
+}
+
+/**
+ * @brief Helper function. Writes to `dst` the edges of `src`, first those
+ * with key at most `pivot` and then the rest. With `filter`, the edges
+ * inside a tree of the forest are dropped.
+ *
+ * @param[out] high Receives how many edges are above the pivot.
+ * @return How many edges are at most the pivot.
+ */
+static u32 splitEdges(FilterContext *F, KeyedEdge *src, KeyedEdge *dst, u32 k,
+                      u64 pivot, bool filter, u32 *high) {
+  ThreadPool *pool = k < KRUSKAL_PARALLEL_SORT ? NULL : F->pool;
+  SplitContext C = {F->U, src, dst, k, pivot, filter, NULL, 0, 0, pool};
+  C.counts = genArray(2 * poolSize(pool));
+  if (pool == NULL)
+    splitTask(0, 1, &C);
+  else
+    poolRun(pool, splitTask, &C);
+  free(C.counts);
+  *high = C.high;
+  return C.low;
+}
+
+static int compareKeys(const void *a, const void *b) {
+  u64 x = *(const u64 *)a, y = *(const u64 *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Helper function. The median key of FILTER_KRUSKAL_SAMPLE evenly
+ * spaced edges.
+ */
+static u64 samplePivot(KeyedEdge *edges, u32 k) {
+  u64 sample[FILTER_KRUSKAL_SAMPLE];
+  for (u32 i = 0; i < FILTER_KRUSKAL_SAMPLE; i++)
+    sample[i] = edges[(u64)k * (2 * i + 1) / (2 * FILTER_KRUSKAL_SAMPLE)].key;
+  qsort(sample, FILTER_KRUSKAL_SAMPLE, sizeof(u64), compareKeys);
+  return sample[FILTER_KRUSKAL_SAMPLE / 2];
+}
+
+/**
+ * @brief Helper function. Plain Kruskal on k edges, with `scratch` as the
+ * radix sort buffer.
+ */
+static void kruskalBase(FilterContext *F, KeyedEdge *edges,
+                        KeyedEdge *scratch, u32 k) {
+  KeyedEdge *sorted = radixSort(edges, scratch, k, F->pool);
+  u32 n = numberOfVertices(F->G);
+  for (u32 i = 0; i < k && F->count + 1 < n; i++) {
+    if (unionSets(F->U, sorted[i].x, sorted[i].y))
+      F->chosen[F->count++] = (u32)sorted[i].key;
+  }
+}
+
+/**
+ * @brief Helper function. Filter-Kruskal on the k edges of `edges`: those
+ * at most a sampled pivot are handled first, and the heavier ones are only
+ * looked at once those have been, after dropping the ones that now lie
+ * inside a tree. `scratch` holds k more edges, and both arrays are
+ * overwritten.
+ */
+static void filterKruskalRec(FilterContext *F, KeyedEdge *edges,
+                             KeyedEdge *scratch, u32 k) {
+  u32 n = numberOfVertices(F->G);
+  if (F->count + 1 >= n || k == 0)
+    return;
+  if (k <= n || k < 4 * FILTER_KRUSKAL_SAMPLE) {
+    kruskalBase(F, edges, scratch, k);
+    return;
+  }
+  u32 high;
+  u32 low =
+      splitEdges(F, edges, scratch, k, samplePivot(edges, k), false, &high);
+  filterKruskalRec(F, scratch, edges, low);
+  if (high == 0)
+    return;
+  u32 none;
+  u32 kept =
+      splitEdges(F, scratch + low, edges + low, high, UINT64_MAX, true, &none);
+  filterKruskalRec(F, edges + low, scratch + low, kept);
+}
+
+/**
+ * @brief Computes a minimum spanning forest of `G` with filter-Kruskal:
+ * recursive partitioning around sampled pivots, as in quicksort, in which
+ * the heavy half is filtered against the forest of the light half before
+ * its turn comes. Edges that cannot be in the forest are thus never sorted.
+ * Partitioning, filtering and sorting run on the threads of `pool` (NULL
+ * runs on the calling thread) for large enough sets of edges.
+ *
+ * @param[out] chosen Receives the indices in G->_edges of the edges of the
+ * forest; it must have room for n - 1 of them.
+ * @param[out] totalWeight If not NULL, receives the weight of the forest.
+ * @return The number of edges of the forest.
+ */
+u32 filterKruskalEdges(Graph *G, u32 *chosen, u64 *totalWeight,
+                       ThreadPool *pool) {
+  assert(chosen != NULL || numberOfVertices(G) <= 1);
+  KeyedEdge *edges, *scratch;
+  u32 k = keyedEdges(G, &edges, &scratch);
+  FilterContext F = {G, createUnionFind(numberOfVertices(G)), chosen, 0,
+                     pool};
+  filterKruskalRec(&F, edges, scratch, k);
+
+  if (totalWeight != NULL) {
+    *totalWeight = 0;
+    for (u32 i = 0; i < F.count; i++)
+      *totalWeight += *(G->_edges)[chosen[i]].w;
+  }
+  dumpUnionFind(F.U);
+  free(edges);
+  free(scratch);
+  return F.count;
+}
+
+/**
+ * @brief As kruskal, with filterKruskalEdges.
+ */
+Graph *filterKruskal(Graph *G, ThreadPool *pool) {
+  u32 n = numberOfVertices(G);
+  u32 *chosen = genArray(n);
+  u32 k = filterKruskalEdges(G, chosen, NULL, pool);
+  Graph *F = forestFromEdges(G, chosen, k);
+  free(chosen);
+  return F;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Forests ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Helper function. The ends of the j-th entry of the forest: entry
+ * j < k is the edge chosen[j] and entry k + j its reverse.
+ */
+static Edge forestEntry(Graph *G, u32 *chosen, u32 k, u32 j) {
+  Edge e = (G->_edges)[chosen[j < k ? j : j - k]];
+  return j < k ? e : (Edge){e.y, e.x, e.w, NULL};
+}
+
+/**
+ * @brief Builds the weighted graph on the n vertices of `G` whose edges are
+ * G->_edges[chosen[0]], ..., G->_edges[chosen[k - 1]], in O(n + k) time.
+ * Entries are bucketed by their second end and then, stably, by their
+ * first, which leaves every neighbour list sorted.
+ *
+ * @return A graph with W_FLAG, to be freed with dumpGraph.
+ */
+Graph *forestFromEdges(Graph *G, u32 *chosen, u32 k) {
+  assert(G != NULL && (k == 0 || chosen != NULL));
+  u32 n = numberOfVertices(G);
+  u32 *first = genArray(n + 1);
+  for (u32 j = 0; j < 2 * k; j++)
+    first[forestEntry(G, chosen, k, j).y + 1]++;
+  for (u32 v = 0; v < n; v++)
+    first[v + 1] += first[v];
+  u32 *byY = genArray(2 * k + 1);
+  for (u32 j = 0; j < 2 * k; j++)
+    byY[first[forestEntry(G, chosen, k, j).y]++] = j;
+
+  Graph *F = initGraph(n, k, W_FLAG);
+  for (u32 j = 0; j < 2 * k; j++)
+    F->_degrees[forestEntry(G, chosen, k, j).x]++;
+  for (u32 v = 1; v < n; v++)
+    F->_firstneighbour[v] = F->_firstneighbour[v - 1] + F->_degrees[v - 1];
+  memcpy(first, F->_firstneighbour, n * sizeof(u32));
+  for (u32 i = 0; i < 2 * k; i++) {
+    Edge e = forestEntry(G, chosen, k, byY[i]);
+    u32 *w = (u32 *)malloc(sizeof(u32));
+    if (w == NULL) {
+      printf("Error: malloc failed\n");
+      exit(1);
+    }
+    *w = *(e.w);
+    F->_edges[first[e.x]++] = (Edge){e.x, e.y, w, NULL};
+  }
+  recomputeΔ(F);
+  free(first);
+  free(byY);
+  return F;
+}
+
+/**
+ * @brief Computes a minimum spanning tree of `G`, or a minimum spanning
+ * forest if `G` is disconnected, with Kruskal's algorithm. The edge sort
+ * runs on the threads of `pool` (NULL runs on the calling thread).
+ *
+ * @return A weighted graph on the n vertices of `G`, to be freed with
+ * dumpGraph.
+ */
+Graph *kruskal(Graph *G, ThreadPool *pool) {
+  u32 n = numberOfVertices(G);
+  u32 *chosen = genArray(n);
+  u32 k = kruskalEdges(G, chosen, NULL, pool);
+  Graph *F = forestFromEdges(G, chosen, k);
+  free(chosen);
+  return F;
+}
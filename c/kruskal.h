@@ -0,0 +1,63 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file kruskal.h
+ * @brief Kruskal's minimum spanning forest algorithm, with edges radix
+ * sorted by weight, and its filter-Kruskal variant.
+ */
+
+#ifndef KRUSKAL_H
+#define KRUSKAL_H
+
+#include "graphStruct.h"
+#include "threadpool.h"
+
+// Below this many edges the radix sort runs on the calling thread even if a
+// pool is given.
+#define KRUSKAL_PARALLEL_SORT (1 << 16)
+
+// An edge {x, y} of weight w, where x < y, whose entry (x, y) is at index i
+// in G->_edges. Ordering edges by key orders them by weight, ties broken by
+// position.
+typedef struct {
+  u64 key; // w << 32 | i
+  u32 x;
+  u32 y;
+} KeyedEdge;
+
+// Filter-Kruskal picks its pivots as the median of this many sampled edges.
+#define FILTER_KRUSKAL_SAMPLE 63
+
+u32 keyedEdges(Graph *G, KeyedEdge **edges, KeyedEdge **buffer);
+KeyedEdge *sortEdgesByWeight(Graph *G, u32 *k, ThreadPool *pool);
+u32 kruskalEdges(Graph *G, u32 *chosen, u64 *totalWeight, ThreadPool *pool);
+Graph *kruskal(Graph *G, ThreadPool *pool);
+u32 filterKruskalEdges(Graph *G, u32 *chosen, u64 *totalWeight,
+                       ThreadPool *pool);
+Graph *filterKruskal(Graph *G, ThreadPool *pool);
+Graph *forestFromEdges(Graph *G, u32 *chosen, u32 k);
+
+#endif
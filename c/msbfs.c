@@ -0,0 +1,224 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file msbfs.c
+ * @brief Multi-source bit-parallel breadth-first search (Then et al.).
+ *
+ * Each source of a batch owns one bit, and every vertex holds three u64
+ * words: the sources that have already reached it (`seen`), those reaching
+ * it on the current level (`visit`), and those reaching it on the next
+ * (`next`). A level ORs the `visit` word of every vertex into the `next`
+ * word of its out-neighbours, then keeps in `next` only the bits not yet
+ * `seen`. The adjacency of a vertex is thus read once per level for the
+ * whole batch instead of once per source, and searches sharing a frontier
+ * share the work. Small frontiers list the vertices they reach, so that the
+ * many levels of a long, thin search do not each scan the whole graph.
+ */
+
+#include "msbfs.h"
+#include "api.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A level lists the vertices it reaches only if the frontier has fewer
+// than n / MSBFS_SPARSE_FACTOR edges; otherwise it scans every vertex.
+#define MSBFS_SPARSE_FACTOR 4
+
+typedef struct {
+  u64 *seen;
+  u64 *visit;
+  u64 *next;
+  u32 *frontier; // vertices whose `visit` word is not zero
+  u32 *touched;  // vertices whose `next` word is not zero
+} MSBFSState;
+
+static MSBFSState createState(u32 n) {
+  MSBFSState S = {(u64 *)malloc((n + 1) * sizeof(u64)),
+                  (u64 *)calloc(n + 1, sizeof(u64)),
+                  (u64 *)calloc(n + 1, sizeof(u64)), genArray(n + 1),
+                  genArray(n + 1)};
+  if (S.seen == NULL || S.visit == NULL || S.next == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  return S;
+}
+
+static void dumpState(MSBFSState *S) {
+  free(S->seen);
+  free(S->visit);
+  free(S->next);
+  free(S->frontier);
+  free(S->touched);
+}
+
+/**
+ * @brief Helper function. Searches from the `count` <= MSBFS_BATCH sources
+ * starting at sources[first]. The `visit` and `next` words of `S` must be
+ * cleared, and are left so.
+ */
+static void searchBatch(Graph *G, u32 *sources, u32 first, u32 count,
+                        MSBFSState *S, MSBFSVisitor visit, void *ctx) {
+  u32 n = numberOfVertices(G);
+  memset(S->seen, 0, n * sizeof(u64));
+  u32 size = 0;
+  for (u32 i = 0; i < count; i++) {
+    u32 s = sources[first + i];
+    assert(s < n);
+    if (S->visit[s] == 0)
+      S->frontier[size++] = s;
+    S->seen[s] |= 1ULL << i;
+    S->visit[s] |= 1ULL << i;
+  }
+  for (u32 k = 0; k < size; k++)
+    visit(S->frontier[k], 0, S->visit[S->frontier[k]], first, ctx);
+
+  u64 frontierEdges = 0;
+  for (u32 k = 0; k < size; k++)
+    frontierEdges += degree(S->frontier[k], G);
+
+  for (u32 level = 1; size > 0; level++) {
+    // Listing the touched vertices costs a test per edge, which only pays
+    // while the frontier reaches few vertices.
+    bool sparse = frontierEdges < n / MSBFS_SPARSE_FACTOR;
+    u32 touched = 0;
+    for (u32 k = 0; k < size; k++) {
+      u32 v = S->frontier[k];
+      u64 bits = S->visit[v];
+      S->visit[v] = 0;
+      u32 firstEdge = firstNeighbourIndex(G, v);
+      u32 lastEdge = firstEdge + degree(v, G);
+      for (u32 i = firstEdge; i < lastEdge; i++) {
+        u32 w = (G->_edges)[i].y;
+        if (sparse && S->next[w] == 0)
+          S->touched[touched++] = w;
+        S->next[w] |= bits;
+      }
+    }
+    size = 0;
+    frontierEdges = 0;
+    u32 end = sparse ? touched : n;
+    for (u32 k = 0; k < end; k++) {
+      u32 w = sparse ? S->touched[k] : k;
+      if (S->next[w] == 0)
+        continue;
+      u64 fresh = S->next[w] & ~S->seen[w];
+      S->next[w] = 0;
+      if (fresh == 0)
+        continue;
+      S->seen[w] |= fresh;
+      S->visit[w] = fresh;
+      S->frontier[size++] = w;
+      frontierEdges += degree(w, G);
+      visit(w, level, fresh, first, ctx);
+    }
+  }
+}
+
+/**
+ * @brief Runs a BFS from each of the k `sources`, following out-edges in
+ * digraphs, MSBFS_BATCH sources per sweep of the graph. Instead of storing
+ * levels, reports every (vertex, level) pair reached to `visit`, which can
+ * accumulate distances, level counts or closeness sums as it needs.
+ */
+void msBFS(Graph *G, u32 *sources, u32 k, MSBFSVisitor visit, void *ctx) {
+  assert(G != NULL && visit != NULL);
+  assert(isFormatted(G));
+  assert(k == 0 || sources != NULL);
+  MSBFSState S = createState(numberOfVertices(G));
+  for (u32 first = 0; first < k; first += MSBFS_BATCH)
+    searchBatch(G, sources, first, min(MSBFS_BATCH, k - first), &S, visit,
+                ctx);
+  dumpState(&S);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Distances ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+typedef struct {
+  Graph *G;
+  u32 *sources;
+  u32 k;
+  u32 *out;
+  u32 cursor; // first source of the next batch to claim
+} DistanceContext;
+
+/**
+ * @brief Helper function. Writes `level` into the rows of the sources in
+ * `reached`.
+ */
+static void storeLevel(u32 v, u32 level, u64 reached, u32 first, void *ctx) {
+  DistanceContext *C = (DistanceContext *)ctx;
+  u64 n = numberOfVertices(C->G);
+  while (reached != 0) {
+    u32 i = __builtin_ctzll(reached);
+    reached &= reached - 1;
+    C->out[(first + i) * n + v] = level;
+  }
+}
+
+/**
+ * @brief Task. Claims batches of sources and searches from them.
+ */
+static void distanceTask(u32 thread, u32 nThreads, void *ctx) {
+  (void)thread;
+  (void)nThreads;
+  DistanceContext *C = (DistanceContext *)ctx;
+  MSBFSState S = createState(numberOfVertices(C->G));
+  while (true) {
+    u32 first = __atomic_fetch_add(&C->cursor, MSBFS_BATCH, __ATOMIC_RELAXED);
+    if (first >= C->k)
+      break;
+    searchBatch(C->G, C->sources, first, min(MSBFS_BATCH, C->k - first), &S,
+                storeLevel, C);
+  }
+  dumpState(&S);
+}
+
+/**
+ * @brief Computes the hop distances from each of the k `sources` to every
+ * vertex with msBFS. Batches of sources are shared among the threads of
+ * `pool` (NULL runs on the calling thread).
+ *
+ * @param[out] out A k x n row-major matrix: out[i * n + v] is the number of
+ * edges on a shortest path from sources[i] to v, or INT_MAX.
+ */
+void msBFSDistances(Graph *G, u32 *sources, u32 k, u32 *out,
+                    ThreadPool *pool) {
+  assert(G != NULL && out != NULL);
+  assert(k == 0 || sources != NULL);
+  u64 cells = (u64)k * numberOfVertices(G);
+  for (u64 c = 0; c < cells; c++)
+    out[c] = INT_MAX;
+  DistanceContext C = {G, sources, k, out, 0};
+  if (pool == NULL)
+    distanceTask(0, 1, &C);
+  else
+    poolRun(pool, distanceTask, &C);
+}
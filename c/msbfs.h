@@ -0,0 +1,50 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file msbfs.h
+ * @brief Multi-source bit-parallel breadth-first search (MS-BFS), which runs
+ * the searches from up to 64 sources in one sweep of the graph.
+ */
+
+#ifndef MSBFS_H
+#define MSBFS_H
+
+#include "graphStruct.h"
+#include "threadpool.h"
+
+// Sources are searched in batches of this many, one bit of a u64 each.
+#define MSBFS_BATCH 64
+
+// Called once for every vertex `v` and `level` on which some sources of a
+// batch first reach `v`: bit i of `reached` stands for sources[first + i].
+typedef void (*MSBFSVisitor)(u32 v, u32 level, u64 reached, u32 first,
+                             void *ctx);
+
+void msBFS(Graph *G, u32 *sources, u32 k, MSBFSVisitor visit, void *ctx);
+void msBFSDistances(Graph *G, u32 *sources, u32 k, u32 *out,
+                    ThreadPool *pool);
+
+#endif
@@ -23,63 +23,134 @@
  * software.
  */
 
-
-
-
-
-
 /**
  * @file prim.c
  * @brief An implementation of Prim's algorithm for generating a spanning tree
  * of a weighted graph which minimizes the sum of the weights of the used edges.
  */
 
-#include "api.h"
+#include "prim.h"
 #include "heap.h"
+#include "search.h"
 #include "utils.h"
+#include "workspace.h"
 #include <assert.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// helper function
-void addEdgesToHeap(u32 root, Heap *heap, bool *inMST, Graph *G) {
-
-  u32 rootIndex = firstNeighbourIndex(G, root);
-
-  for (u32 i = 0; i < degree(root, G); i++) {
-    u32 w = neighbour(i, root, G);
-    insert(heap, rootIndex + i, *getEdge(root, w, G).w);
+/**
+ * @brief Helper function. Grows a minimum spanning tree of the component of
+ * `root`. Each vertex not yet in a tree sits at most once in the heap, keyed
+ * by the lightest edge joining it to the tree, so the heap never holds more
+ * than n entries.
+ *
+ * @return The weight of the tree.
+ */
+static u64 growTree(Graph *G, u32 root, IndexedHeap *heap, bool *inTree,
+                    u32 *keys, u32 *parents, u32 *parentEdges) {
+  u64 total = 0;
+  keys[root] = 0;
+  parents[root] = root;
+  parentEdges[root] = NO_PARENT;
+  indexedInsert(heap, root, 0);
+
+  while (heap->size > 0) {
+    HeapNode node = indexedExtractMin(heap);
+    u32 u = node.label;
+    inTree[u] = true;
+    total += node.value;
+
+    u32 first = firstNeighbourIndex(G, u);
+    u32 last = first + degree(u, G);
+    for (u32 i = first; i < last; i++) {
+      Edge e = (G->_edges)[i];
+      u32 w = *(e.w);
+      if (inTree[e.y] || w >= keys[e.y])
+        continue;
+      bool queued = keys[e.y] != INT_MAX;
+      keys[e.y] = w;
+      parents[e.y] = u;
+      parentEdges[e.y] = i;
+      if (queued)
+        decreaseKey(heap, e.y, w);
+      else
+        indexedInsert(heap, e.y, w);
+    }
   }
+  return total;
 }
 
-Graph *prim(Graph *G, u32 s) {
-
-  bool *inMST = (bool *)calloc(G->n, sizeof(bool));
+/**
+ * @brief Computes a minimum spanning forest of `G` with Prim's algorithm,
+ * in O(m log n) time. The tree of `s` is grown first; every other component
+ * then gets a tree rooted at its least vertex.
+ *
+ * @param[out] parents Receives the parent of each vertex in the forest;
+ * roots are their own parent.
+ * @param[out] parentEdges If not NULL, receives for each vertex the index in
+ * G->_edges of the edge from its parent, or NO_PARENT for roots.
+ * @return The total weight of the forest.
+ */
+u64 primWithParents(Graph *G, u32 s, u32 *parents, u32 *parentEdges) {
+  assert(G != NULL);
+  assert(G->_g_flag & W_FLAG);
+  assert(!(G->_g_flag & D_FLAG));
+  assert(isFormatted(G));
+  assert(parents != NULL);
   u32 n = numberOfVertices(G);
-  Graph *MST = initGraph(n, 0, W_FLAG);
-  inMST[s] = 1;
-
-  Heap *heap = createHeap(numberOfEdges(G));
-  addEdgesToHeap(s, heap, inMST, G);
-  inMST[s] = 1;
-
-  while (numberOfEdges(MST) < n - 1) {
+  assert(s < n);
+
+  u32 *keys = genArray(n);
+  for (u32 v = 0; v < n; v++)
+    keys[v] = INT_MAX;
+  bool *inTree = (bool *)calloc(n, sizeof(bool));
+  if (inTree == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 *edges = parentEdges != NULL ? parentEdges : genArray(n);
+  IndexedHeap *heap = createIndexedHeap(n);
 
-    HeapNode node = extractMin(heap);
-    Edge edgeToAdd = getIthEdge(node.label, G);
+  u64 total = growTree(G, s, heap, inTree, keys, parents, edges);
+  for (u32 v = 0; v < n; v++) {
+    if (!inTree[v])
+      total += growTree(G, v, heap, inTree, keys, parents, edges);
+  }
 
-    u32 newVertex = edgeToAdd.y;
-    if (inMST[newVertex])
-      continue;
+  if (parentEdges == NULL)
+    free(edges);
+  free(keys);
+  free(inTree);
+  dumpIndexedHeap(heap);
+  return total;
+}
 
-    addEdge(MST, edgeToAdd.x, edgeToAdd.y, edgeToAdd.w, NULL);
-    inMST[newVertex] = 1;
-    addEdgesToHeap(newVertex, heap, inMST, G);
+/**
+ * @brief Computes a minimum spanning tree of `G`, or a minimum spanning
+ * forest if `G` is disconnected.
+ *
+ * The chosen edges are kept as a parent array and the tree is built from
+ * it once, in O(n) time, with weightedTreeFromParents.
+ *
+ * @return A weighted graph on the n vertices of `G`, to be freed with
+ * dumpGraph.
+ */
+Graph *prim(Graph *G, u32 s) {
+  u32 n = numberOfVertices(G);
+  u32 *parents = genArray(n);
+  u32 *parentEdges = genArray(n);
+  primWithParents(G, s, parents, parentEdges);
+
+  u32 *weights = genArray(n);
+  for (u32 v = 0; v < n; v++) {
+    if (parentEdges[v] != NO_PARENT)
+      weights[v] = *(G->_edges)[parentEdges[v]].w;
   }
-
-  free(inMST);
-  dumpHeap(heap);
+  Graph *MST = weightedTreeFromParents(parents, weights, n);
+  free(parents);
+  free(parentEdges);
+  free(weights);
   return (MST);
 }
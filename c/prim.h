@@ -32,3 +32,4 @@
 #include "api.h"
 
 Graph *prim(Graph *G, u32 start);
+u64 primWithParents(Graph *G, u32 s, u32 *parents, u32 *parentEdges);
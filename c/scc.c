@@ -0,0 +1,553 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file scc.c
+ * @brief Strongly connected components of digraphs.
+ *
+ * The sequential algorithm is Pearce's space-efficient variant of Tarjan's:
+ * a single array rindex serves as DFS index, low-link and, once a vertex is
+ * done, component number, so the search needs the DFS stack, the stack of
+ * open vertices and one bit per vertex beyond the labels. The DFS stack is
+ * explicit, so long paths do not overflow the call stack.
+ *
+ * The parallel algorithm (in the spirit of Slota, Rajamanickam and
+ * Madduri's Multistep) first trims vertices with no live in- or
+ * out-neighbour, which are components of their own. A forward and a
+ * backward BFS from a pivot of large degree then peel off the component of
+ * the pivot, usually the giant one. The rest is coloured: the largest vertex
+ * that reaches each vertex is propagated along out-edges until stable, and
+ * each vertex that keeps its own colour collects its component with a
+ * backward search restricted to its colour. Colouring repeats until no
+ * vertex is left.
+ */
+
+#include "scc.h"
+#include "api.h"
+#include "components.h"
+#include "diapi.h"
+#include "search.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Labels the strongly connected components of the digraph `G` with
+ * Pearce's algorithm, in O(n + m).
+ *
+ * @param[out] labels If not NULL, receives the component of each vertex, in
+ * [0, count). Components are numbered in reverse topological order: an edge
+ * from u to v in another component has labels[u] > labels[v].
+ * @return The number of components, count.
+ */
+u32 stronglyConnectedComponents(Graph *G, u32 *labels) {
+  assert(G != NULL && isFormatted(G));
+  assert(G->_g_flag & D_FLAG);
+  u32 n = numberOfVertices(G);
+  u32 *rindex = labels == NULL ? genArray(n) : labels;
+  memset(rindex, 0, n * sizeof(u32));
+  u64 *root = (u64 *)calloc(n / 64 + 1, sizeof(u64));
+  DFSFrame *stack = (DFSFrame *)malloc((n + 1) * sizeof(DFSFrame));
+  u32 *open = genArray(n + 1); // visited vertices not yet in a component
+  if (root == NULL || stack == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+
+  // Open vertices have rindex in [1, index); finished ones get c, counting
+  // down from n - 1, which keeps them above every open vertex.
+  u32 index = 1, c = n - 1, openSize = 0;
+  for (u32 r = 0; r < n; r++) {
+    if (rindex[r] != 0)
+      continue;
+    u32 top = 0;
+    rindex[r] = index++;
+    root[r >> 6] |= 1ULL << (r & 63);
+    stack[top++] = (DFSFrame){r, firstNeighbourIndex(G, r)};
+    while (top > 0) {
+      DFSFrame *f = &stack[top - 1];
+      u32 v = f->vertex;
+      if (f->next < firstNeighbourIndex(G, v) + degree(v, G)) {
+        u32 w = (G->_edges)[f->next].y;
+        if (rindex[w] == 0) {
+          rindex[w] = index++;
+          root[w >> 6] |= 1ULL << (w & 63);
+          stack[top++] = (DFSFrame){w, firstNeighbourIndex(G, w)};
+          continue; // f->next advances once w is done
+        }
+        if (rindex[w] < rindex[v]) {
+          rindex[v] = rindex[w];
+          root[v >> 6] &= ~(1ULL << (v & 63));
+        }
+        f->next++;
+        continue;
+      }
+
+      top--;
+      if (root[v >> 6] >> (v & 63) & 1) {
+        index--;
+        while (openSize > 0 && rindex[v] <= rindex[open[openSize - 1]]) {
+          rindex[open[--openSize]] = c;
+          index--;
+        }
+        rindex[v] = c--;
+      } else {
+        open[openSize++] = v;
+      }
+      if (top > 0) {
+        DFSFrame *parent = &stack[top - 1];
+        u32 p = parent->vertex;
+        if (rindex[v] < rindex[p]) {
+          rindex[p] = rindex[v];
+          root[p >> 6] &= ~(1ULL << (p & 63));
+        }
+        parent->next++;
+      }
+    }
+  }
+
+  u32 count = n - 1 - c;
+  for (u32 v = 0; labels != NULL && v < n; v++)
+    labels[v] = n - 1 - labels[v];
+  if (labels == NULL)
+    free(rindex);
+  free(root);
+  free(stack);
+  free(open);
+  return count;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Parallel ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Number of vertices a thread claims at a time from a shared cursor.
+#define SCC_CHUNK 256
+
+// marks[v] while a forward-backward search runs.
+#define SCC_FORWARD 1
+#define SCC_BOTH 2
+
+typedef struct {
+  Graph *G;
+  ReverseIndex *R;
+  ThreadPool *pool;
+  u32 n;
+  u32 *component; // representative of the component of v, or NO_COMPONENT
+  u32 *colors;
+  u32 *marks;
+  u32 *frontier;
+  u32 *next;
+  u32 size;
+  u32 nextSize;
+  u32 cursor;
+  u32 pivot;
+  u32 live;    // vertices not yet in a component, counted after each step
+  bool changed;
+} SCCContext;
+
+static void sccBarrier(SCCContext *C) {
+  if (C->pool != NULL)
+    poolBarrier(C->pool);
+}
+
+static bool isLive(SCCContext *C, u32 v) {
+  return __atomic_load_n(&C->component[v], __ATOMIC_RELAXED) == NO_COMPONENT;
+}
+
+static void setComponent(SCCContext *C, u32 v, u32 representative) {
+  __atomic_store_n(&C->component[v], representative, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Helper function. Whether every thread saw a change in the step
+ * that just ended; resets the flag for the next step.
+ */
+static bool agreeChanged(SCCContext *C, u32 thread) {
+  sccBarrier(C);
+  bool changed = __atomic_load_n(&C->changed, __ATOMIC_RELAXED);
+  sccBarrier(C);
+  if (thread == 0)
+    C->changed = false;
+  sccBarrier(C);
+  return changed;
+}
+
+/**
+ * @brief Helper function. Whether `v` has a live neighbour other than
+ * itself along its out-edges, or its in-edges if `in`.
+ */
+static bool hasLiveNeighbour(SCCContext *C, u32 v, bool in) {
+  Graph *G = C->G;
+  if (in) {
+    for (u32 k = C->R->first[v]; k < C->R->first[v + 1]; k++) {
+      u32 u = (G->_edges)[C->R->edges[k]].x;
+      if (u != v && isLive(C, u))
+        return true;
+    }
+    return false;
+  }
+  u32 first = firstNeighbourIndex(G, v);
+  for (u32 i = first; i < first + degree(v, G); i++) {
+    u32 w = (G->_edges)[i].y;
+    if (w != v && isLive(C, w))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Helper function. Makes every live vertex of [lo, hi) with no live
+ * in- or out-neighbour a component of its own, for up to SCC_TRIM_ROUNDS
+ * rounds or until nothing changes.
+ */
+static void trim(SCCContext *C, u32 thread, u32 lo, u32 hi) {
+  for (u32 round = 0; round < SCC_TRIM_ROUNDS; round++) {
+    for (u32 v = lo; v < hi; v++) {
+      if (isLive(C, v) &&
+          (!hasLiveNeighbour(C, v, false) || !hasLiveNeighbour(C, v, true))) {
+        setComponent(C, v, v);
+        __atomic_store_n(&C->changed, true, __ATOMIC_RELAXED);
+      }
+    }
+    if (!agreeChanged(C, thread))
+      return;
+  }
+}
+
+/**
+ * @brief Helper function. Moves the mark of each live out-neighbour of `v`,
+ * or in-neighbour if `backward`, from `from` to `to` and appends it to
+ * C->next.
+ */
+static void expand(SCCContext *C, u32 v, bool backward, u32 from, u32 to) {
+  Graph *G = C->G;
+  u32 first = backward ? C->R->first[v] : firstNeighbourIndex(G, v);
+  u32 last = backward ? C->R->first[v + 1] : first + degree(v, G);
+  for (u32 i = first; i < last; i++) {
+    u32 w = backward ? (G->_edges)[C->R->edges[i]].x : (G->_edges)[i].y;
+    u32 expected = from;
+    if (!isLive(C, w) ||
+        __atomic_load_n(&C->marks[w], __ATOMIC_RELAXED) != from ||
+        !__atomic_compare_exchange_n(&C->marks[w], &expected, to, false,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      continue;
+    C->next[__atomic_fetch_add(&C->nextSize, 1, __ATOMIC_RELAXED)] = w;
+  }
+}
+
+/**
+ * @brief Helper function. Swaps the frontiers after a level.
+ */
+static void nextLevel(SCCContext *C) {
+  u32 *t = C->frontier;
+  C->frontier = C->next;
+  C->next = t;
+  C->size = C->nextSize;
+  C->nextSize = 0;
+  C->cursor = 0;
+}
+
+/**
+ * @brief Helper function. A level-synchronous BFS from C->pivot through
+ * live vertices, along out-edges or, if `backward`, in-edges. It moves the
+ * mark of each vertex it reaches from `from` to `to`. Frontiers smaller
+ * than SCC_CHUNK are expanded by thread 0 alone, so long thin components
+ * do not pay for barriers at every level.
+ */
+static void sweep(SCCContext *C, u32 thread, bool backward, u32 from,
+                  u32 to) {
+  if (thread == 0) {
+    C->marks[C->pivot] = to;
+    C->frontier[0] = C->pivot;
+    C->size = 1;
+    C->nextSize = 0;
+    C->cursor = 0;
+  }
+  sccBarrier(C);
+  while (true) {
+    u32 size = C->size;
+    sccBarrier(C); // thread 0 may change C->size from here on
+    if (size == 0)
+      return;
+    if (size < SCC_CHUNK) {
+      while (thread == 0 && C->size > 0 && C->size < SCC_CHUNK) {
+        for (u32 k = 0; k < C->size; k++)
+          expand(C, C->frontier[k], backward, from, to);
+        nextLevel(C);
+      }
+      sccBarrier(C);
+      continue;
+    }
+    while (true) {
+      u32 start = __atomic_fetch_add(&C->cursor, SCC_CHUNK, __ATOMIC_RELAXED);
+      if (start >= size)
+        break;
+      u32 end = min(start + SCC_CHUNK, size);
+      for (u32 k = start; k < end; k++)
+        expand(C, C->frontier[k], backward, from, to);
+    }
+    sccBarrier(C);
+    if (thread == 0)
+      nextLevel(C);
+    sccBarrier(C);
+  }
+}
+
+/**
+ * @brief Helper function. Collects the live vertices of colour `r` that
+ * reach `r` into the component of `r`, with a BFS along in-edges that uses
+ * `queue`, grown as needed.
+ */
+static void collectColour(SCCContext *C, u32 r, u32 **queue, u32 *capacity) {
+  Graph *G = C->G;
+  u32 head = 0, tail = 0;
+  setComponent(C, r, r);
+  (*queue)[tail++] = r;
+  while (head < tail) {
+    u32 v = (*queue)[head++];
+    for (u32 k = C->R->first[v]; k < C->R->first[v + 1]; k++) {
+      u32 u = (G->_edges)[C->R->edges[k]].x;
+      if (C->colors[u] != r || !isLive(C, u))
+        continue;
+      setComponent(C, u, r);
+      if (tail == *capacity) {
+        *capacity *= 2;
+        *queue = (u32 *)realloc(*queue, *capacity * sizeof(u32));
+        if (*queue == NULL) {
+          printf("Error: realloc failed\n");
+          exit(1);
+        }
+      }
+      (*queue)[tail++] = u;
+    }
+  }
+}
+
+/**
+ * @brief Task. Trims, peels the component of a pivot of large degree, then
+ * colours until every vertex is in a component.
+ */
+static void sccTask(u32 thread, u32 nThreads, void *ctx) {
+  SCCContext *C = (SCCContext *)ctx;
+  Graph *G = C->G;
+  u32 n = C->n;
+  u32 lo = (u64)n * thread / nThreads;
+  u32 hi = (u64)n * (thread + 1) / nThreads;
+
+  trim(C, thread, lo, hi);
+  if (thread == 0) {
+    u64 best = 0;
+    C->pivot = NO_COMPONENT;
+    for (u32 v = 0; v < n; v++) {
+      u64 score = (u64)(degree(v, G) + 1) * (C->R->first[v + 1] -
+                                             C->R->first[v] + 1);
+      if (isLive(C, v) && (C->pivot == NO_COMPONENT || score > best)) {
+        best = score;
+        C->pivot = v;
+      }
+    }
+  }
+  sccBarrier(C);
+  if (C->pivot != NO_COMPONENT) {
+    sweep(C, thread, false, 0, SCC_FORWARD);
+    sweep(C, thread, true, SCC_FORWARD, SCC_BOTH);
+    for (u32 v = lo; v < hi; v++) {
+      if (C->marks[v] == SCC_BOTH)
+        setComponent(C, v, C->pivot);
+    }
+    sccBarrier(C);
+  }
+
+  u32 capacity = 64;
+  u32 *queue = genArray(capacity);
+  while (true) {
+    trim(C, thread, lo, hi);
+    u32 live = 0;
+    for (u32 v = lo; v < hi; v++) {
+      C->colors[v] = v;
+      live += isLive(C, v);
+    }
+    __atomic_fetch_add(&C->live, live, __ATOMIC_RELAXED);
+    sccBarrier(C);
+    live = C->live;
+    sccBarrier(C);
+    if (thread == 0) {
+      C->live = 0;
+      C->cursor = 0;
+    }
+    if (live == 0)
+      break;
+
+    // Propagate the largest colour along out-edges until it is stable.
+    do {
+      for (u32 v = lo; v < hi; v++) {
+        if (!isLive(C, v))
+          continue;
+        u32 colour = __atomic_load_n(&C->colors[v], __ATOMIC_RELAXED);
+        u32 first = firstNeighbourIndex(G, v);
+        for (u32 i = first; i < first + degree(v, G); i++) {
+          u32 w = (G->_edges)[i].y;
+          if (!isLive(C, w))
+            continue;
+          u32 current = __atomic_load_n(&C->colors[w], __ATOMIC_RELAXED);
+          while (colour > current) {
+            if (__atomic_compare_exchange_n(&C->colors[w], &current, colour,
+                                            true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+              __atomic_store_n(&C->changed, true, __ATOMIC_RELAXED);
+              break;
+            }
+          }
+        }
+      }
+    } while (agreeChanged(C, thread));
+
+    // Colour classes are disjoint, so their searches never meet.
+    while (true) {
+      u32 start = __atomic_fetch_add(&C->cursor, SCC_CHUNK, __ATOMIC_RELAXED);
+      if (start >= n)
+        break;
+      u32 end = min(start + SCC_CHUNK, n);
+      for (u32 r = start; r < end; r++) {
+        if (C->colors[r] == r && isLive(C, r))
+          collectColour(C, r, &queue, &capacity);
+      }
+    }
+    sccBarrier(C);
+  }
+  free(queue);
+}
+
+/**
+ * @brief As stronglyConnectedComponents, on the threads of `pool` (NULL
+ * runs on the calling thread).
+ *
+ * @param[out] labels If not NULL, receives the component of each vertex, in
+ * [0, count), numbered in the order of their smallest vertex.
+ * @return The number of components, count.
+ */
+u32 parallelStronglyConnectedComponents(Graph *G, u32 *labels,
+                                        ThreadPool *pool) {
+  assert(G != NULL && isFormatted(G));
+  assert(G->_g_flag & D_FLAG);
+  u32 n = numberOfVertices(G);
+  SCCContext C = {G, buildReverseIndex(G), pool, n, genArray(n + 1),
+                  genArray(n + 1), genArray(n + 1), genArray(n + 1),
+                  genArray(n + 1), 0, 0, 0, 0, 0, false};
+  for (u32 v = 0; v < n; v++)
+    C.component[v] = NO_COMPONENT;
+  if (pool == NULL)
+    sccTask(0, 1, &C);
+  else
+    poolRun(pool, sccTask, &C);
+
+  // Relabel by smallest vertex; colors is free to map representatives.
+  u32 count = 0;
+  for (u32 v = 0; v < n; v++)
+    C.colors[v] = NO_COMPONENT;
+  for (u32 v = 0; v < n; v++) {
+    u32 r = C.component[v];
+    if (C.colors[r] == NO_COMPONENT)
+      C.colors[r] = count++;
+    if (labels != NULL)
+      labels[v] = C.colors[r];
+  }
+
+  dumpReverseIndex(C.R);
+  free(C.component);
+  free(C.colors);
+  free(C.marks);
+  free(C.frontier);
+  free(C.next);
+  return count;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Condensation ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Builds the condensation of `G`: the digraph with a vertex per
+ * component of `labels` and an arc from a to b iff some edge of `G` goes
+ * from component a to component b != a. For strongly connected components
+ * it is acyclic. Arcs are bucketed by head and then, stably, by tail, which
+ * sorts them and leaves duplicates adjacent, so this takes O(n + m) time.
+ *
+ * @return An unweighted digraph on `count` vertices, to be freed with
+ * dumpGraph.
+ */
+Graph *condensation(Graph *G, u32 *labels, u32 count) {
+  assert(G != NULL && isFormatted(G));
+  assert(G->_g_flag & D_FLAG);
+  assert(labels != NULL || numberOfVertices(G) == 0);
+  u32 m = G->_edgeArraySize;
+  u32 *first = genArray(count + 1);
+  u32 *byHead = genArray(m + 1);
+  u32 *sorted = genArray(m + 1);
+
+  for (u32 i = 0; i < m; i++)
+    first[labels[(G->_edges)[i].y] + 1]++;
+  for (u32 c = 0; c < count; c++)
+    first[c + 1] += first[c];
+  for (u32 i = 0; i < m; i++)
+    byHead[first[labels[(G->_edges)[i].y]]++] = i;
+
+  memset(first, 0, (count + 1) * sizeof(u32));
+  for (u32 i = 0; i < m; i++)
+    first[labels[(G->_edges)[i].x] + 1]++;
+  for (u32 c = 0; c < count; c++)
+    first[c + 1] += first[c];
+  for (u32 k = 0; k < m; k++) {
+    u32 i = byHead[k];
+    sorted[first[labels[(G->_edges)[i].x]]++] = i;
+  }
+
+  // Keep the first of each run of equal arcs, and no loops.
+  u32 arcs = 0;
+  u32 lastTail = NO_COMPONENT, lastHead = NO_COMPONENT;
+  for (u32 k = 0; k < m; k++) {
+    Edge e = (G->_edges)[sorted[k]];
+    u32 a = labels[e.x], b = labels[e.y];
+    if (a == b || (a == lastTail && b == lastHead))
+      continue;
+    lastTail = a;
+    lastHead = b;
+    byHead[arcs++] = a;
+    sorted[arcs - 1] = b;
+  }
+
+  Graph *D = initGraph(count, arcs, D_FLAG);
+  for (u32 k = 0; k < arcs; k++) {
+    D->_edges[k] = (Edge){byHead[k], sorted[k], NULL, NULL};
+    D->_outdegrees[byHead[k]]++;
+    D->_indegrees[sorted[k]]++;
+  }
+  for (u32 c = 1; c < count; c++)
+    D->_firstneighbour[c] = D->_firstneighbour[c - 1] + D->_outdegrees[c - 1];
+  recomputeΔ(D);
+  free(first);
+  free(byHead);
+  free(sorted);
+  return D;
+}
@@ -0,0 +1,48 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file scc.h
+ * @brief Strongly connected components of digraphs, sequentially with
+ * Pearce's algorithm and in parallel by trimming, forward-backward search
+ * and colouring, and the condensation DAG they induce.
+ */
+
+#ifndef SCC_H
+#define SCC_H
+
+#include "graphStruct.h"
+#include "threadpool.h"
+
+// The parallel algorithm trims vertices with no live in- or out-neighbour
+// for at most this many rounds before each search.
+#define SCC_TRIM_ROUNDS 8
+
+u32 stronglyConnectedComponents(Graph *G, u32 *labels);
+u32 parallelStronglyConnectedComponents(Graph *G, u32 *labels,
+                                        ThreadPool *pool);
+Graph *condensation(Graph *G, u32 *labels, u32 count);
+
+#endif
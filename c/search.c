@@ -36,9 +36,11 @@
 
 #include "search.h"
 #include "api.h"
-#include "queue.h"
+#include "bfs.h"
+#include "components.h"
 #include "utils.h"
 #include <assert.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -74,91 +76,297 @@ Graph *_TreeFromInsertionArray(InsertionArray *insertionArray,
   return (B);
 }
 
+/**
+ * @brief Helper function. Allocates the weight of the tree edge joining `v`
+ * to its parent, or returns NULL for unweighted trees.
+ */
+static u32 *treeWeight(u32 *weights, u32 v) {
+  if (weights == NULL)
+    return NULL;
+  u32 *w = (u32 *)malloc(sizeof(u32));
+  if (w == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  *w = weights[v];
+  return w;
+}
+
+/**
+ * @brief Builds the tree of a parent array as a graph on the same n
+ * vertices, in O(n) time and without sorting.
+ *
+ * Vertex v is joined to parents[v], unless parents[v] is v or NO_PARENT.
+ * Children are first bucketed by parent; then, for y = 0, ..., n - 1, the
+ * edge entries (x, y) are appended to the neighbour list of x, which
+ * leaves every list sorted.
+ *
+ * @return A tree (or forest) with STD_FLAG, to be freed with dumpGraph.
+ */
+Graph *treeFromParents(u32 *parents, u32 n) {
+  return weightedTreeFromParents(parents, NULL, n);
+}
+
+/**
+ * @brief As treeFromParents, but if `weights` is not NULL the tree has
+ * W_FLAG and the edge joining v to parents[v] has weight weights[v].
+ */
+Graph *weightedTreeFromParents(u32 *parents, u32 *weights, u32 n) {
+  assert(parents != NULL);
+  // children[childFirst[x]], ..., children[childFirst[x + 1] - 1] are the
+  // children of x, in increasing order.
+  u32 *childFirst = genArray(n + 1);
+  u32 m = 0;
+  for (u32 v = 0; v < n; v++) {
+    if (parents[v] == NO_PARENT || parents[v] == v)
+      continue;
+    assert(parents[v] < n);
+    childFirst[parents[v] + 1]++;
+    m++;
+  }
+  for (u32 x = 0; x < n; x++)
+    childFirst[x + 1] += childFirst[x];
+  u32 *children = genArray(m + 1);
+  u32 *next = genArray(n + 1);
+  memcpy(next, childFirst, n * sizeof(u32));
+  for (u32 v = 0; v < n; v++) {
+    if (parents[v] != NO_PARENT && parents[v] != v)
+      children[next[parents[v]]++] = v;
+  }
+
+  Graph *T = initGraph(n, m, weights != NULL ? W_FLAG : STD_FLAG);
+  for (u32 x = 0; x < n; x++) {
+    bool hasParent = parents[x] != NO_PARENT && parents[x] != x;
+    T->_degrees[x] = hasParent + childFirst[x + 1] - childFirst[x];
+    if (x > 0)
+      T->_firstneighbour[x] = T->_firstneighbour[x - 1] + T->_degrees[x - 1];
+  }
+  memcpy(next, T->_firstneighbour, n * sizeof(u32));
+  for (u32 y = 0; y < n; y++) {
+    u32 x = parents[y];
+    if (x != NO_PARENT && x != y)
+      T->_edges[next[x]++] = (Edge){x, y, treeWeight(weights, y), NULL};
+    for (u32 k = childFirst[y]; k < childFirst[y + 1]; k++) {
+      x = children[k];
+      T->_edges[next[x]++] = (Edge){x, y, treeWeight(weights, x), NULL};
+    }
+  }
+  recomputeΔ(T);
+  free(childFirst);
+  free(children);
+  free(next);
+  return T;
+}
+
 /**
  * @brief Builds a Breadth-First Search (BFS) tree from a given graph.
  *
- * Performs a BFS traversal on graph `G`, starting from vertex `s`, and
- * constructs a BFS tree.
+ * Performs a BFS traversal on graph `G`, starting from vertex `s`, with
+ * BFSLevels and constructs a BFS tree with treeFromParents. The tree has the n vertices
+ * of `G`; those not reached from `s` are isolated.
  *
  * @param[in] G Pointer to the original graph.
  * @param[in] s Starting vertex for the BFS traversal.
  * @return A pointer to the Graph structure representing the BFS tree.
  */
 Graph *BFS(Graph *G, u32 s) {
-
   u32 n = numberOfVertices(G);
-  // An array s.t. insertionArray[i] = (k+1) iff vertex i was enqueued
-  // by vertex k.
-  InsertionArray *insertionArray = createInsertionArray(n);
-  u32 treeVertexCount = 1; // root included necessarily
-
-  struct Queue *Q = createQueue();
-  enQueue(Q, s);
-
-  while (Q->front != NULL) {
-
-    u32 v = pop(Q);
-    u32 d = degree(v, G);
+  u32 *parents = genArray(n);
+  BFSLevels(G, s, NULL, parents);
+  Graph *B = treeFromParents(parents, n);
+  free(parents);
+  return (B);
+}
 
-    for (u32 i = 0; i < d; i++) {
-      u32 iNeighbour = neighbour(i, v, G);
-      if (insArrayGet(iNeighbour, insertionArray) != -1 || iNeighbour == s)
-        continue;
-      insArrayStore(iNeighbour, v, insertionArray);
-      treeVertexCount++;
-      enQueue(Q, iNeighbour);
+/**
+ * @brief Helper function. Runs a DFS from `root`, which must be
+ * undiscovered, with an explicit stack of (vertex, next edge) frames, so
+ * the depth is bounded by memory rather than by the C stack.
+ */
+static void DFSFrom(Graph *G, u32 root, DFSOrder *O, DFSFrame *stack) {
+  u32 top = 0;
+  O->discovery[root] = O->clock++;
+  O->parents[root] = root;
+  O->preorder[O->count++] = root;
+  stack[top++] = (DFSFrame){root, firstNeighbourIndex(G, root)};
+
+  while (top > 0) {
+    DFSFrame *frame = &stack[top - 1];
+    u32 v = frame->vertex;
+    u32 last = firstNeighbourIndex(G, v) + degree(v, G);
+    while (frame->next < last &&
+           O->discovery[(G->_edges)[frame->next].y] != NO_PARENT)
+      frame->next++;
+    if (frame->next == last) {
+      O->finish[v] = O->clock++;
+      O->postorder[O->finished++] = v;
+      top--;
+      continue;
     }
+    u32 w = (G->_edges)[frame->next++].y;
+    O->discovery[w] = O->clock++;
+    O->parents[w] = v;
+    O->preorder[O->count++] = w;
+    stack[top++] = (DFSFrame){w, firstNeighbourIndex(G, w)};
   }
-  dumpQueue(Q);
-  Graph *B = _TreeFromInsertionArray(insertionArray, n, treeVertexCount);
-  free(insertionArray);
-  return (B);
 }
 
 /**
- * @brief Recursive helper function for Depth-First Search (DFS).
+ * @brief Runs a depth-first search from `s`, visiting neighbours in the
+ * order of their lists, in O(n + m) time and without recursion.
  *
- * Traverses a graph recursively from a starting vertex `v`, updating the
- * `track` array to record parent vertices and counting the number of nodes in
- * the DFS tree. Useful for managing multiple connected components.
+ * Discovery and finish times come from one clock, so that v is a
+ * descendant of u iff discovery[u] <= discovery[v] < finish[v] <=
+ * finish[u]. With `allComponents`, the search restarts from every vertex
+ * still undiscovered, in increasing order, after finishing with `s`; in a
+ * digraph, edges are followed forwards only.
  *
- * @param[in] v Current vertex in the traversal.
- * @param[out] track Array tracking the parent of each vertex.
- * @param[in] root Initial root vertex of the DFS traversal.
- * @param[in] G Pointer to the graph being traversed.
- * @return Number of vertices in the DFS tree.
+ * @return The traversal, to be freed with dumpDFSOrder. Undiscovered
+ * vertices have NO_PARENT as discovery time, finish time and parent; roots
+ * are their own parent.
  */
-u32 DFSRecursive(u32 v, InsertionArray *track, u32 root, Graph *G) {
-  u32 n = 1;
-  for (u32 i = 0; i < degree(v, G); i++) {
-    u32 iNeighbour = neighbour(i, v, G);
-    if (iNeighbour == root || insArrayGet(iNeighbour, track) != -1) {
-      continue;
-    }
-    insArrayStore(iNeighbour, v, track);
-    n += DFSRecursive(iNeighbour, track, root, G);
+DFSOrder *depthFirstOrder(Graph *G, u32 s, bool allComponents) {
+  assert(G != NULL);
+  assert(isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(s < n);
+  DFSOrder *O = (DFSOrder *)malloc(sizeof(DFSOrder));
+  DFSFrame *stack = (DFSFrame *)malloc((n + 1) * sizeof(DFSFrame));
+  if (O == NULL || stack == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
   }
-  return n;
+  O->n = n;
+  O->count = 0;
+  O->finished = 0;
+  O->clock = 0;
+  O->discovery = genArray(n);
+  O->finish = genArray(n);
+  O->parents = genArray(n);
+  O->preorder = genArray(n);
+  O->postorder = genArray(n);
+  for (u32 v = 0; v < n; v++)
+    O->discovery[v] = O->finish[v] = O->parents[v] = NO_PARENT;
+
+  DFSFrom(G, s, O, stack);
+  for (u32 v = 0; allComponents && v < n; v++) {
+    if (O->discovery[v] == NO_PARENT)
+      DFSFrom(G, v, O, stack);
+  }
+  free(stack);
+  return O;
+}
+
+void dumpDFSOrder(DFSOrder *O) {
+  if (O == NULL)
+    return;
+  free(O->discovery);
+  free(O->finish);
+  free(O->parents);
+  free(O->preorder);
+  free(O->postorder);
+  free(O);
 }
 
 /**
  * @brief Builds a Depth-First Search (DFS) tree from a given graph.
  *
- * Uses a recursive DFS approach to traverse graph `G` from vertex `s` and
- * construct a DFS tree.
+ * Runs depthFirstOrder on graph `G` from vertex `s` and builds the tree of
+ * its parents with treeFromParents. The tree has the n vertices of `G`;
+ * those not reached from `s` are isolated.
  *
  * @param[in] G Pointer to the original graph.
  * @param[in] s Starting vertex for the DFS traversal.
  * @return A pointer to the Graph structure representing the DFS tree.
  */
 Graph *DFS(Graph *G, u32 s) {
+  DFSOrder *O = depthFirstOrder(G, s, false);
+  Graph *D = treeFromParents(O->parents, O->n);
+  dumpDFSOrder(O);
+  return (D);
+}
+
+/**
+ * @brief Helper function. Runs a BFS from `s` in the workspace W, recording
+ * hop distances, parents and parent edges, until the queue empties or `target` is reached
+ * (pass n for no target).
+ *
+ * @return The number of vertices reached.
+ */
+static u32 workspaceBFS(Graph *G, u32 s, u32 target, SearchWorkspace *W) {
+  assert(G != NULL);
+  assert(W != NULL && W->n >= numberOfVertices(G));
+  resetWorkspace(W);
+  u32 epoch = W->epoch;
+  u32 head = 0, tail = 0;
+  W->stamp[s] = epoch;
+  W->distances[s] = 0;
+  W->parents[s] = s;
+  W->parentEdges[s] = NO_PARENT;
+  W->frontier[tail++] = s;
+
+  while (head < tail) {
+    u32 v = W->frontier[head++];
+    u32 first = firstNeighbourIndex(G, v);
+    u32 last = first + degree(v, G);
+    for (u32 i = first; i < last; i++) {
+      u32 w = (G->_edges)[i].y;
+      if (W->stamp[w] == epoch)
+        continue;
+      W->stamp[w] = epoch;
+      W->distances[w] = W->distances[v] + 1;
+      W->parents[w] = v;
+      W->parentEdges[w] = i;
+      W->frontier[tail++] = w;
+      if (w == target)
+        return tail;
+    }
+  }
+  return tail;
+}
 
+/**
+ * @brief Runs a BFS from `s` and returns its tree.
+ *
+ * @param[out] parents If not NULL, receives for each vertex its parent in
+ * the BFS tree; `s` is its own parent and unreached vertices get NO_PARENT.
+ * See extractPath and treeFromParents.
+ * @param[out] parentEdges If not NULL, receives for each vertex the index in
+ * G->_edges of the edge from its parent, or NO_PARENT for `s` and unreached
+ * vertices.
+ * @return An array D of n integers such that D[i] is the number of edges
+ * on a shortest path from `s` to `i`, or INT_MAX if `i` is unreachable.
+ */
+u32 *BFSWithParents(Graph *G, u32 s, u32 *parents, u32 *parentEdges) {
   u32 n = numberOfVertices(G);
-  InsertionArray *insertionArray = createInsertionArray(n);
-  u32 treeVertexCount = DFSRecursive(s, insertionArray, s, G);
-  Graph *D = _TreeFromInsertionArray(insertionArray, n, treeVertexCount);
-  free(insertionArray);
-  return (D);
+  SearchWorkspace *W = createSearchWorkspace(n);
+  workspaceBFS(G, s, n, W);
+  u32 *distances = W->distances;
+  for (u32 i = 0; i < n; i++) {
+    bool reached = W->stamp[i] == W->epoch;
+    if (!reached)
+      distances[i] = INT_MAX;
+    if (parents != NULL)
+      parents[i] = reached ? W->parents[i] : NO_PARENT;
+    if (parentEdges != NULL)
+      parentEdges[i] = reached ? W->parentEdges[i] : NO_PARENT;
+  }
+  W->distances = NULL;
+  dumpSearchWorkspace(W);
+  return distances;
+}
+
+/**
+ * @brief Searches for a target vertex in a graph using Breadth-First Search
+ * (BFS), in the workspace W. Afterwards W->parents leads from `target` back
+ * to `s` if it was found.
+ *
+ * @return `true` if the target vertex is found, `false` otherwise.
+ */
+bool workspaceBFSSearch(Graph *G, u32 s, u32 target, SearchWorkspace *W) {
+  assert(s != target);
+  workspaceBFS(G, s, target, W);
+  return workspaceReached(W, target);
 }
 
 /**
@@ -166,7 +374,8 @@ Graph *DFS(Graph *G, u32 s) {
  * (BFS).
  *
  * Performs a BFS search on graph `G` starting from vertex `s` to find the
- * `target` vertex.
+ * `target` vertex. See workspaceBFSSearch to run many searches without
+ * allocating.
  *
  * @param[in] G Pointer to the graph.
  * @param[in] s Starting vertex for the search.
@@ -174,79 +383,162 @@ Graph *DFS(Graph *G, u32 s) {
  * @return `true` if the target vertex is found, `false` otherwise.
  */
 bool BFSSearch(Graph *G, u32 s, u32 target) {
-  assert(s != target);
-
-  u32 n = numberOfVertices(G);
-  u32 *visited = genArray(n);
-
-  struct Queue *Q = createQueue();
-  enQueue(Q, s);
-
-  while (Q->front != NULL) {
-
-    u32 v = pop(Q);
-    u32 d = degree(v, G);
+  SearchWorkspace *W = createSearchWorkspace(numberOfVertices(G));
+  bool found = G->_g_flag & D_FLAG
+                   ? workspaceBFSSearch(G, s, target, W)
+                   : bidirectionalSearch(G, s, target, NULL, W, NULL);
+  dumpSearchWorkspace(W);
+  return found;
+}
 
-    for (u32 i = 0; i < d; i++) {
-      u32 iNeighbour = neighbour(i, v, G);
-      // If this vertex was visited already or is the root, continue
-      if (visited[iNeighbour] != 0 || iNeighbour == s) {
-        continue;
-      }
-      //            // If it is the target we are pivoting on the root
-      //            if (iNeighbour == target && v == s){
-      //                continue;
-      //            }
-      if (iNeighbour == target) {
-        dumpQueue(Q);
-        free(visited);
+/**
+ * @brief Helper function. Expands one level of a side of a bidirectional
+ * search: the vertices frontier[*head], frontier[*head + step], ... up to
+ * (excluding) *tail, along out-edges, or along in-edges if `backward`.
+ * Newly reached vertices get stamp `mine` and are appended at *tail; the
+ * indices move by `step`, which is -1 for the queue growing down from the
+ * end of W->frontier.
+ *
+ * @return `true` if a vertex stamped `theirs` was reached.
+ */
+static bool expandLevel(Graph *G, ReverseIndex *R, SearchWorkspace *W,
+                        bool backward, u32 mine, u32 theirs, u32 *head,
+                        u32 *tail, int step) {
+  u32 end = *tail;
+  while (*head != end) {
+    u32 v = W->frontier[*head];
+    *head += step;
+    u32 first, last;
+    if (backward && R != NULL) {
+      first = R->first[v];
+      last = R->first[v + 1];
+    } else {
+      first = firstNeighbourIndex(G, v);
+      last = first + degree(v, G);
+    }
+    for (u32 i = first; i < last; i++) {
+      u32 w = backward && R != NULL ? (G->_edges)[R->edges[i]].x
+                                    : (G->_edges)[i].y;
+      if (W->stamp[w] == theirs)
         return true;
-      }
-      visited[iNeighbour] = 1;
-      enQueue(Q, iNeighbour);
+      if (W->stamp[w] == mine)
+        continue;
+      W->stamp[w] = mine;
+      W->frontier[*tail] = w;
+      *tail += step;
     }
   }
-  dumpQueue(Q);
-  free(visited);
   return false;
 }
 
 /**
- * @brief Checks if a graph is connected.
+ * @brief Tells whether `t` is reachable from `s`, with a BFS forward from
+ * `s` and one backward from `t`, in the workspace W.
  *
- * Determines if the graph `G` is fully connected by performing a BFS traversal
- * from vertex 0 and counting reachable nodes.
+ * Each step expands a whole level of the side whose frontier is smaller,
+ * and the search stops as soon as the sides touch. On graphs that expand
+ * quickly, each side only grows to about the square root of what a
+ * one-sided search explores. The two sides are told apart by two
+ * consecutive epochs of W, and their queues share W->frontier, one filling
+ * it from each end.
  *
- * @param[in] G Pointer to the graph.
- * @return `true` if the graph is connected, `false` otherwise.
+ * @param R In-edges of G, for the backward search on digraphs. May be NULL,
+ * in which case they are built (in O(n + m)) for digraphs; pass them when
+ * running many queries. Ignored for undirected graphs.
+ * @param[out] explored If not NULL, receives the number of vertices reached
+ * by both sides together.
  */
-bool isConnected(Graph *G) {
-
+bool bidirectionalSearch(Graph *G, u32 s, u32 t, ReverseIndex *R,
+                         SearchWorkspace *W, u32 *explored) {
+  assert(G != NULL && isFormatted(G));
   u32 n = numberOfVertices(G);
-  u32 *insertionArray = genArray(n);
-  u32 treeVertexCount = 1; // root included necessarily
-
-  struct Queue *Q = createQueue();
-  enQueue(Q, 0);
-
-  while (Q->front != NULL) {
+  assert(W != NULL && W->n >= n);
+  assert(s < n && t < n);
+  ReverseIndex *own = NULL;
+  if (!(G->_g_flag & D_FLAG))
+    R = NULL;
+  else if (R == NULL)
+    R = own = buildReverseIndex(G);
+
+  resetWorkspace(W);
+  u32 forward = W->epoch;
+  resetWorkspace(W);
+  u32 backward = W->epoch;
+  W->stamp[s] = forward;
+  bool found = s == t;
+  u32 fHead = 0, fTail = 0, bHead = W->n - 1, bTail = W->n - 1;
+  W->frontier[fTail++] = s;
+  if (!found) {
+    W->stamp[t] = backward;
+    W->frontier[bTail--] = t;
+  }
+  while (!found && fHead != fTail && bHead != bTail) {
+    if (fTail - fHead <= bHead - bTail)
+      found = expandLevel(G, R, W, false, forward, backward, &fHead, &fTail,
+                          1);
+    else
+      found = expandLevel(G, R, W, true, backward, forward, &bHead, &bTail,
+                          -1);
+  }
 
-    u32 v = pop(Q);
-    u32 d = degree(v, G);
+  if (explored != NULL)
+    *explored = fTail + (W->n - 1 - bTail);
+  dumpReverseIndex(own);
+  return found;
+}
 
-    for (u32 i = 0; i < d; i++) {
-      u32 iNeighbour = neighbour(i, v, G);
-      if (insertionArray[iNeighbour] != 0 || iNeighbour == 0) {
-        continue;
+/**
+ * @brief Checks if a graph is connected, by counting the vertices a BFS
+ * from vertex 0 reaches, in the workspace W. As for isConnected, a digraph
+ * is connected if it is weakly connected: the BFS also follows the in-edges
+ * in `R`, which is built if NULL.
+ */
+bool workspaceIsConnected(Graph *G, ReverseIndex *R, SearchWorkspace *W) {
+  assert(G != NULL && isFormatted(G));
+  u32 n = numberOfVertices(G);
+  assert(W != NULL && W->n >= n);
+  if (n == 0)
+    return true;
+  if (!(G->_g_flag & D_FLAG))
+    return workspaceBFS(G, 0, n, W) == n;
+  ReverseIndex *own = R == NULL ? buildReverseIndex(G) : NULL;
+  if (R == NULL)
+    R = own;
+
+  resetWorkspace(W);
+  u32 epoch = W->epoch;
+  u32 head = 0, tail = 0;
+  W->stamp[0] = epoch;
+  W->frontier[tail++] = 0;
+  while (head < tail) {
+    u32 v = W->frontier[head++];
+    u32 first = firstNeighbourIndex(G, v);
+    for (u32 i = first; i < first + degree(v, G); i++) {
+      u32 w = (G->_edges)[i].y;
+      if (W->stamp[w] != epoch) {
+        W->stamp[w] = epoch;
+        W->frontier[tail++] = w;
+      }
+    }
+    for (u32 k = R->first[v]; k < R->first[v + 1]; k++) {
+      u32 u = (G->_edges)[R->edges[k]].x;
+      if (W->stamp[u] != epoch) {
+        W->stamp[u] = epoch;
+        W->frontier[tail++] = u;
       }
-      insertionArray[iNeighbour] = v + 1;
-      treeVertexCount++;
-      enQueue(Q, iNeighbour);
     }
   }
-  dumpQueue(Q);
-
-  free(insertionArray);
-
-  return (n == treeVertexCount);
+  dumpReverseIndex(own);
+  return tail == n;
 }
+
+/**
+ * @brief Checks if a graph is connected.
+ *
+ * Determines if the graph `G` has a single connected component, with
+ * connectedComponents. A digraph is connected if it is weakly connected.
+ *
+ * @param[in] G Pointer to the graph.
+ * @return `true` if the graph is connected, `false` otherwise.
+ */
+bool isConnected(Graph *G) { return connectedComponents(G, NULL) <= 1; }
@@ -28,13 +28,46 @@
 
 
 
+#include "diapi.h"
 #include "graphStruct.h"
 #include "insertionArray.h"
+#include "workspace.h"
+
+// A depth-first traversal: discovery[v] and finish[v] are the times v was
+// entered and left, and preorder and postorder list the `count` vertices
+// reached in the order they were entered and left.
+typedef struct {
+  u32 n;
+  u32 count;
+  u32 finished;
+  u32 clock;
+  u32 *discovery;
+  u32 *finish;
+  u32 *parents;
+  u32 *preorder;
+  u32 *postorder;
+} DFSOrder;
+
+// A vertex on the DFS stack, with the index in G->_edges of the next edge
+// to look at.
+typedef struct {
+  u32 vertex;
+  u32 next;
+} DFSFrame;
 
 Graph *BFS(Graph *G, u32 s);
+u32 *BFSWithParents(Graph *G, u32 s, u32 *parents, u32 *parentEdges);
 Graph *DFS(Graph *G, u32 s);
+DFSOrder *depthFirstOrder(Graph *G, u32 s, bool allComponents);
+void dumpDFSOrder(DFSOrder *O);
 bool BFSSearch(Graph *G, u32 s, u32 target);
+bool workspaceBFSSearch(Graph *G, u32 s, u32 target, SearchWorkspace *W);
+bool bidirectionalSearch(Graph *G, u32 s, u32 t, ReverseIndex *R,
+                         SearchWorkspace *W, u32 *explored);
 u32 *DFSSearch(Graph *G, u32 s, u32 target);
 bool isConnected(Graph *G);
+bool workspaceIsConnected(Graph *G, ReverseIndex *R, SearchWorkspace *W);
+Graph *treeFromParents(u32 *parents, u32 n);
+Graph *weightedTreeFromParents(u32 *parents, u32 *weights, u32 n);
 Graph *_TreeFromInsertionArray(InsertionArray *insertionArray,
                                u32 insertionArrayLength, u32 n);
@@ -156,6 +156,65 @@ void testRemoveEdge() {
   printf("testRemoveEdge passed.\n");
 }
 
+/**
+ * @brief Tests that removing an edge incident to the vertex of maximum degree
+ * lowers Δ.
+ */
+void testRemoveEdgeUpdatesΔ() {
+  Graph *G = initGraph(4, 3, STD_FLAG);
+  setEdge(G, 0, 0, 1, NULL, NULL);
+  setEdge(G, 1, 0, 2, NULL, NULL);
+  setEdge(G, 2, 0, 3, NULL, NULL);
+  formatEdges(G);
+  assert(Δ(G) == 3);
+
+  removeEdge(G, 0, 3);
+  assert(Δ(G) == 2);
+
+  dumpGraph(G);
+  printf("testRemoveEdgeUpdatesΔ passed.\n");
+}
+
+/**
+ * @brief Tests batched insertion and deletion of edges in a weighted graph.
+ */
+void testApplyEdgeBatch() {
+  Graph *G = initGraph(5, 4, W_FLAG);
+  u32 w[4] = {10, 20, 30, 40};
+  setEdge(G, 0, 0, 1, &w[0], NULL);
+  setEdge(G, 1, 0, 2, &w[1], NULL);
+  setEdge(G, 2, 0, 3, &w[2], NULL);
+  setEdge(G, 3, 2, 3, &w[3], NULL);
+  formatEdges(G);
+  assert(Δ(G) == 3);
+
+  u32 w1 = 5, w2 = 7;
+  Edge inserts[2] = {{4, 1, &w1, NULL}, {3, 4, &w2, NULL}};
+  Edge deletes[2] = {{0, 2, NULL, NULL}, {3, 0, NULL, NULL}};
+  applyEdgeBatch(G, inserts, 2, deletes, 2);
+
+  assert(numberOfEdges(G) == 4);
+  assert(isNeighbour(0, 1, G) && isNeighbour(2, 3, G));
+  assert(isNeighbour(1, 4, G) && isNeighbour(4, 1, G));
+  assert(isNeighbour(3, 4, G) && isNeighbour(4, 3, G));
+  assert(!isNeighbour(0, 2, G) && !isNeighbour(2, 0, G));
+  assert(!isNeighbour(0, 3, G) && !isNeighbour(3, 0, G));
+  assert(degree(0, G) == 1 && degree(4, G) == 2 && degree(3, G) == 2);
+  assert(Δ(G) == 2);
+
+  // Edges are still sorted and weights travel with them.
+  for (u32 i = 1; i < 2 * numberOfEdges(G); i++) {
+    assert(compareEdges(&(G->_edges)[i - 1], &(G->_edges)[i]) < 0);
+  }
+  assert(getEdgeWeight(0, 1, G) == 10);
+  assert(getEdgeWeight(1, 4, G) == 5);
+  assert(getEdgeWeight(3, 4, G) == 7);
+  assert(getEdgeWeight(2, 3, G) == 40);
+
+  dumpGraph(G);
+  printf("testApplyEdgeBatch passed.\n");
+}
+
 /**
  * @brief Tests neighbor functionality to ensure `isNeighbour` detects
  * connectivity correctly.
@@ -213,6 +272,65 @@ void testCompareEdges() {
   printf("testCompareEdges passed.\n");
 }
 
+/**
+ * @brief Writes the graph with edges {i, i + 1} and {i, i + 2} on `n`
+ * vertices to `fname` in the format readGraph expects. Edge {x, y} gets
+ * weight x + y + 1 when `weighted` is set.
+ */
+void writeBandGraph(char *fname, u32 n, bool weighted) {
+  FILE *f = fopen(fname, "w");
+  assert(f != NULL);
+  fprintf(f, "c generated by test_api\n");
+  fprintf(f, "p edge %u %u %s\n", n, 2 * n - 3,
+          weighted ? "W_FLAG" : "STD_FLAG");
+  for (u32 d = 1; d <= 2; d++) {
+    for (u32 x = 0; x + d < n; x++) {
+      if (weighted)
+        fprintf(f, "e %u %u %u\n", x, x + d, x + (x + d) + 1);
+      else
+        fprintf(f, "e %u %u\n", x, x + d);
+    }
+  }
+  fclose(f);
+}
+
+/**
+ * @brief Tests readGraph on generated files, so it is checked even where the
+ * data files of test_readGraph are not available.
+ */
+void test_readGeneratedGraph() {
+  u32 n = 50;
+  writeBandGraph("generatedGraph.txt", n, false);
+  Graph *G = readGraph("generatedGraph.txt");
+  assert(G != NULL);
+  assert(G->_g_flag == STD_FLAG);
+  assert(numberOfVertices(G) == n);
+  assert(numberOfEdges(G) == 2 * n - 3);
+  assert(Δ(G) == 4);
+  for (u32 x = 0; x < n; x++) {
+    for (u32 y = 0; y < n; y++) {
+      u32 d = x < y ? y - x : x - y;
+      assert(isNeighbour(x, y, G) == (d == 1 || d == 2));
+    }
+  }
+  dumpGraph(G);
+
+  writeBandGraph("generatedGraph.txt", n, true);
+  Graph *W = readGraph("generatedGraph.txt");
+  assert(W != NULL);
+  assert(W->_g_flag == W_FLAG);
+  assert(numberOfEdges(W) == 2 * n - 3);
+  for (u32 d = 1; d <= 2; d++) {
+    for (u32 x = 0; x + d < n; x++) {
+      assert(*(getEdge(x, x + d, W).w) == x + (x + d) + 1);
+      assert(*(getEdge(x + d, x, W).w) == x + (x + d) + 1);
+    }
+  }
+  dumpGraph(W);
+  remove("generatedGraph.txt");
+  printf("test_readGeneratedGraph passed.\n");
+}
+
 /**
  * @brief Tests the initialization of graph from an input file and checks for
  * graph creation. Requires a valid input file in Penazzi format for full
@@ -250,14 +368,17 @@ void test_readGraph() {
  */
 int main() {
   testInitGraph();
-  test_readGraph();
+  test_readGeneratedGraph();
   testAddEdge();
   testRemoveEdge();
+  testRemoveEdgeUpdatesΔ();
+  testApplyEdgeBatch();
   testIsNeighbour();
   testEdgeIndex();
   testDegree();
   testColors();
   testCompareEdges();
+  test_readGraph();
   // Note: test_readGraph requires an actual file input for complete
   // verification.
   printf("All tests passed.\n");
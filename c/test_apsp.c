@@ -0,0 +1,127 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "apsp.h"
+#include "dijkstra.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Checks that rows of `matrix` are the distances from `sources`.
+ */
+static void checkRows(Graph *G, u32 *sources, u32 k, u32 *matrix) {
+  u32 n = numberOfVertices(G);
+  for (u32 i = 0; i < k; i++) {
+    u32 *expected = dijkstra(sources[i], G);
+    for (u32 v = 0; v < n; v++) {
+      assert(matrix[(u64)i * n + v] == expected[v]);
+    }
+    free(expected);
+  }
+}
+
+void testMultiSourceDijkstra() {
+  srand(31);
+  ThreadPool *pool = createThreadPool(3);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  for (u32 f = 0; f < 2; f++) {
+    u32 n = 150;
+    Graph *G = randomWeightedGraph(n, 2 * n, 100, flags[f]);
+    u32 k = 20;
+    u32 *sources = (u32 *)malloc(k * sizeof(u32));
+    for (u32 i = 0; i < k; i++)
+      sources[i] = rand() % n;
+    u32 *out = (u32 *)malloc(k * n * sizeof(u32));
+    multiSourceDijkstra(G, sources, k, out, NULL);
+    checkRows(G, sources, k, out);
+    multiSourceDijkstra(G, sources, k, out, pool);
+    checkRows(G, sources, k, out);
+    free(out);
+    free(sources);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("Multi-source Dijkstra test passed.\n");
+}
+
+void testFloydWarshall() {
+  srand(32);
+  ThreadPool *pool = createThreadPool(4);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  // Sizes below, at and across the tile size.
+  u32 sizes[4] = {1, 17, FW_BLOCK, 2 * FW_BLOCK + 9};
+  for (u32 f = 0; f < 2; f++) {
+    for (u32 s = 0; s < 4; s++) {
+      u32 n = sizes[s];
+      Graph *G = randomWeightedGraph(n, 3 * n, 1000, flags[f]);
+      u32 *sources = (u32 *)malloc(n * sizeof(u32));
+      for (u32 v = 0; v < n; v++)
+        sources[v] = v;
+      u32 *out = (u32 *)malloc(n * n * sizeof(u32));
+      floydWarshall(G, out, NULL);
+      checkRows(G, sources, n, out);
+      floydWarshall(G, out, pool);
+      checkRows(G, sources, n, out);
+      free(out);
+      free(sources);
+      dumpGraph(G);
+    }
+  }
+  dumpThreadPool(pool);
+  printf("Floyd-Warshall test passed.\n");
+}
+
+void testAllPairs() {
+  srand(33);
+  u32 n = 80;
+  Graph *sparse = randomWeightedGraph(n, 2 * n, 50, W_FLAG);
+  Graph *dense = randomWeightedGraph(n, n * n / 2, 50, W_FLAG | D_FLAG);
+  assert(!isDenseForAPSP(sparse));
+  assert(isDenseForAPSP(dense));
+  u32 *sources = (u32 *)malloc(n * sizeof(u32));
+  for (u32 v = 0; v < n; v++)
+    sources[v] = v;
+  u32 *D = allPairsShortestPaths(sparse, NULL);
+  checkRows(sparse, sources, n, D);
+  free(D);
+  D = allPairsShortestPaths(dense, NULL);
+  checkRows(dense, sources, n, D);
+  free(D);
+  free(sources);
+  dumpGraph(sparse);
+  dumpGraph(dense);
+  printf("All-pairs test passed.\n");
+}
+
+int main() {
+  testMultiSourceDijkstra();
+  testFloydWarshall();
+  testAllPairs();
+}
@@ -0,0 +1,186 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "astar.h"
+#include "dijkstra.h"
+#include "generator.h"
+#include "testgraphs.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 zeroHeuristic(u32 v, u32 t, void *ctx) {
+  (void)v;
+  (void)t;
+  (void)ctx;
+  return 0;
+}
+
+void testAStarWithoutHeuristic() {
+  srand(11);
+  for (u32 trial = 0; trial < 20; trial++) {
+    u32 n = 2 + rand() % 50;
+    Graph *G = randomWeightedGraph(n, 2 * n, 30, W_FLAG | D_FLAG);
+    u32 s = rand() % n;
+    u32 *expected = dijkstra(s, G);
+    for (u32 t = 0; t < n; t++) {
+      Path *P = aStar(G, s, t, zeroHeuristic, NULL);
+      assert(P->distance == expected[t]);
+      assert((P->length == 0) == (expected[t] == INT_MAX));
+      dumpPath(P);
+    }
+    free(expected);
+    dumpGraph(G);
+  }
+  printf("A* without heuristic test passed.\n");
+}
+
+void testALT() {
+  srand(12);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  for (u32 f = 0; f < 2; f++) {
+    for (u32 trial = 0; trial < 20; trial++) {
+      // Sparse enough to be disconnected now and then.
+      u32 n = 2 + rand() % 60;
+      Graph *G = randomWeightedGraph(n, n + n / 2, 40, flags[f]);
+      Landmarks *L = selectLandmarks(G, 4, NULL);
+      assert(L->k == (n < 4 ? n : 4));
+      ReverseIndex *R = (flags[f] & D_FLAG) ? buildReverseIndex(G) : NULL;
+      for (u32 t = 0; t < n; t++) {
+        // The bounds never overestimate.
+        u32 *toT = reverseDijkstra(t, G, R);
+        for (u32 v = 0; v < n; v++) {
+          u32 bound = altLowerBound(v, t, L);
+          assert(bound <= toT[v]);
+        }
+        free(toT);
+      }
+      u32 s = rand() % n;
+      u32 *expected = dijkstra(s, G);
+      for (u32 t = 0; t < n; t++) {
+        Path *P = altQuery(G, L, s, t);
+        assert(P->distance == expected[t]);
+        if (expected[t] != INT_MAX) {
+          assert(P->vertices[0] == s && P->vertices[P->length - 1] == t);
+        }
+        dumpPath(P);
+      }
+      free(expected);
+      dumpReverseIndex(R);
+      dumpLandmarks(L);
+      dumpGraph(G);
+    }
+  }
+  printf("ALT test passed.\n");
+}
+
+void testALTExploresLess() {
+  srand(13);
+  u32 side = 60;
+  Graph *G = genGrid(side, side, 10);
+  Landmarks *L = selectLandmarks(G, 8, NULL);
+  u32 s = 0, t = side * side - 1;
+  Path *D = shortestPath(G, s, t);
+  Path *A = altQuery(G, L, s, t);
+  assert(A->distance == D->distance);
+  assert(A->settled < D->settled);
+  dumpPath(D);
+  dumpPath(A);
+  dumpLandmarks(L);
+  dumpGraph(G);
+  printf("ALT exploration test passed.\n");
+}
+
+void testLandmarkFile() {
+  srand(14);
+  Graph *G = randomWeightedGraph(40, 80, 20, W_FLAG | D_FLAG);
+  Landmarks *L = selectLandmarks(G, 3, NULL);
+  writeLandmarks(L, "landmarks.bin");
+  Landmarks *M = readLandmarks(G, "landmarks.bin");
+  assert(M->n == L->n && M->k == L->k && M->directed == L->directed);
+  for (u32 i = 0; i < L->k; i++) {
+    assert(M->vertices[i] == L->vertices[i]);
+  }
+  for (u32 i = 0; i < L->k * L->n; i++) {
+    assert(M->from[i] == L->from[i] && M->to[i] == L->to[i]);
+  }
+  remove("landmarks.bin");
+  dumpLandmarks(L);
+  dumpLandmarks(M);
+  dumpGraph(G);
+  printf("Landmark file test passed.\n");
+}
+
+// Admissible but not consistent: the ALT bound on even vertices only.
+static u32 evenHeuristic(u32 v, u32 t, void *landmarks) {
+  return v % 2 == 0 ? altLowerBound(v, t, landmarks) : 0;
+}
+
+void testWorkspaceQueries() {
+  srand(15);
+  u32 n = 300;
+  Graph *G = randomWeightedGraph(n, 3 * n / 2, 50, W_FLAG | D_FLAG);
+  Landmarks *L = selectLandmarks(G, 4, NULL);
+  // One workspace, larger than needed, serves every query.
+  SearchWorkspace *W = createSearchWorkspace(2 * n);
+  for (u32 trial = 0; trial < 10; trial++) {
+    u32 s = rand() % n;
+    u32 *expected = dijkstra(s, G);
+    for (u32 t = 0; t < n; t++) {
+      Path *A = workspaceAltQuery(G, L, s, t, W);
+      assert(A->distance == expected[t]);
+      assert(workspaceDistance(W, t) == expected[t]);
+      if (expected[t] != INT_MAX) {
+        assert(isPathOf(A, G, s, t));
+        // The parent edges lead back to s along the path.
+        u32 v = t;
+        while (v != s) {
+          Edge e = (G->_edges)[W->parentEdges[v]];
+          assert(e.x == W->parents[v] && e.y == v);
+          v = W->parents[v];
+        }
+      }
+      Path *B = workspaceAStar(G, s, t, evenHeuristic, L, W);
+      assert(B->distance == expected[t]);
+      dumpPath(A);
+      dumpPath(B);
+    }
+    free(expected);
+  }
+  dumpSearchWorkspace(W);
+  dumpLandmarks(L);
+  dumpGraph(G);
+  printf("A* workspace test passed.\n");
+}
+
+int main() {
+  testAStarWithoutHeuristic();
+  testALT();
+  testALTExploresLess();
+  testLandmarkFile();
+  testWorkspaceQueries();
+}
@@ -0,0 +1,230 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "bfs.h"
+#include "diapi.h"
+#include "generator.h"
+#include "msbfs.h"
+#include "search.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Checks levels and parents from `s` against BFSWithParents: the
+ * levels must match, and each parent must be one level closer and joined
+ * by an edge.
+ */
+static void checkLevels(Graph *G, u32 s, u32 *levels, u32 *parents,
+                        u32 reached) {
+  u32 n = numberOfVertices(G);
+  u32 *expected = BFSWithParents(G, s, NULL, NULL);
+  u32 count = 0;
+  for (u32 v = 0; v < n; v++) {
+    assert(levels[v] == expected[v]);
+    if (levels[v] == INT_MAX) {
+      assert(parents[v] == NO_PARENT);
+      continue;
+    }
+    count++;
+    if (v == s) {
+      assert(parents[v] == s);
+      continue;
+    }
+    assert(levels[parents[v]] + 1 == levels[v]);
+    assert(isNeighbour(parents[v], v, G));
+  }
+  assert(count == reached);
+  free(expected);
+}
+
+void testBFSLevels() {
+  srand(43);
+  Graph *graphs[3] = {genKronecker(12, 8, 10),
+                      randomMultigraph(3000, 6000, 0, D_FLAG, true),
+                      genGrid(40, 60, 10)};
+  for (u32 g = 0; g < 3; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    u32 *levels = genArray(n);
+    u32 *parents = genArray(n);
+    for (u32 s = 0; s < n; s += n / 7) {
+      u32 reached = BFSLevels(G, s, levels, parents);
+      checkLevels(G, s, levels, parents, reached);
+    }
+    assert(BFSLevels(G, 0, NULL, NULL) ==
+           BFSLevels(G, 0, levels, parents));
+    free(levels);
+    free(parents);
+    dumpGraph(G);
+  }
+  printf("BFSLevels test passed.\n");
+}
+
+/**
+ * @brief Edges a top-down search from `s` examines: every out-edge of every
+ * reached vertex.
+ */
+static u64 topDownEdges(Graph *G, u32 *levels) {
+  u64 edges = 0;
+  for (u32 v = 0; v < numberOfVertices(G); v++) {
+    if (levels[v] != INT_MAX)
+      edges += degree(v, G);
+  }
+  return edges;
+}
+
+void testDirectionOptimizingBFS() {
+  srand(44);
+  Graph *graphs[4] = {genKronecker(14, 16, 10),
+                      randomMultigraph(4000, 40000, 0, D_FLAG, true),
+                      randomMultigraph(3000, 4000, 0, D_FLAG, true),
+                      genGrid(40, 60, 10)};
+  for (u32 g = 0; g < 4; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    ReverseIndex *R =
+        G->_g_flag & D_FLAG ? buildReverseIndex(G) : NULL;
+    u32 *levels = genArray(n);
+    u32 *parents = genArray(n);
+    for (u32 s = 0; s < n; s += n / 5) {
+      u64 examined;
+      u32 reached =
+          directionOptimizingBFS(G, s, R, levels, parents, &examined);
+      checkLevels(G, s, levels, parents, reached);
+      // Kronecker graphs have one large component of low diameter, which
+      // is where bottom-up steps pay off; a grid should stay top-down.
+      if (g == 0 && reached > n / 2)
+        assert(examined * 10 < topDownEdges(G, levels));
+      if (g == 3)
+        assert(examined == topDownEdges(G, levels));
+    }
+    assert(directionOptimizingBFS(G, 0, NULL, NULL, NULL, NULL) ==
+           BFSLevels(G, 0, NULL, NULL));
+    free(levels);
+    free(parents);
+    dumpReverseIndex(R);
+    dumpGraph(G);
+  }
+  printf("directionOptimizingBFS test passed.\n");
+}
+
+void testParallelBFS() {
+  srand(45);
+  Graph *graphs[3] = {genKronecker(13, 16, 10),
+                      randomMultigraph(5000, 20000, 0, D_FLAG, true),
+                      genGrid(50, 80, 10)};
+  ThreadPool *pool = createThreadPool(4);
+  for (u32 g = 0; g < 3; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    u32 *levels = genArray(n);
+    u32 *parents = genArray(n);
+    for (u32 s = 0; s < n; s += n / 5) {
+      u32 reached = parallelBFS(G, s, levels, parents, pool);
+      checkLevels(G, s, levels, parents, reached);
+      reached = parallelBFS(G, s, levels, parents, NULL);
+      checkLevels(G, s, levels, parents, reached);
+    }
+    assert(parallelBFS(G, 0, NULL, NULL, pool) == BFSLevels(G, 0, NULL, NULL));
+    free(levels);
+    free(parents);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("parallelBFS test passed.\n");
+}
+
+typedef struct {
+  u32 n;
+  u32 *levelCounts; // levelCounts[i * n + l]: vertices at level l of source i
+} CountContext;
+
+static void countLevel(u32 v, u32 level, u64 reached, u32 first, void *ctx) {
+  (void)v;
+  CountContext *C = (CountContext *)ctx;
+  for (u32 i = 0; i < 64; i++) {
+    if (reached >> i & 1)
+      C->levelCounts[(first + i) * C->n + level]++;
+  }
+}
+
+void testMSBFS() {
+  srand(46);
+  Graph *graphs[3] = {genKronecker(11, 8, 10),
+                      randomMultigraph(2000, 5000, 0, D_FLAG, true),
+                      genGrid(30, 40, 10)};
+  ThreadPool *pool = createThreadPool(3);
+  for (u32 g = 0; g < 3; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    u32 k = 150;
+    u32 *sources = genArray(k);
+    for (u32 i = 0; i < k; i++)
+      sources[i] = rand() % n;
+    sources[1] = sources[0]; // repeated sources share a vertex and a bit word
+
+    u32 *out = genArray(k * n);
+    msBFSDistances(G, sources, k, out, pool);
+    u32 *levels = genArray(n);
+    CountContext C = {n, genArray(k * n)};
+    msBFS(G, sources, k, countLevel, &C);
+    for (u32 i = 0; i < k; i++) {
+      BFSLevels(G, sources[i], levels, NULL);
+      assert(memcmp(&out[i * n], levels, n * sizeof(u32)) == 0);
+      for (u32 v = 0; v < n; v++) {
+        if (levels[v] != INT_MAX)
+          C.levelCounts[i * n + levels[v]]--;
+      }
+    }
+    for (u32 c = 0; c < k * n; c++)
+      assert(C.levelCounts[c] == 0);
+
+    msBFSDistances(G, sources, 0, levels, NULL);
+    msBFSDistances(G, sources, 1, levels, NULL);
+    assert(memcmp(out, levels, n * sizeof(u32)) == 0);
+    free(C.levelCounts);
+    free(levels);
+    free(out);
+    free(sources);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("msBFS test passed.\n");
+}
+
+int main() {
+  testBFSLevels();
+  testDirectionOptimizingBFS();
+  testParallelBFS();
+  testMSBFS();
+}
@@ -0,0 +1,214 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+#include "api.h"
+#include "bridges.h"
+#include "components.h"
+#include "generator.h"
+#include "testgraphs.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Builds the graph with the edges of `G` (as x < y entries) other
+ * than the edge with entry `skipEdge` and those touching `skipVertex`.
+ */
+static Graph *graphWithout(Graph *G, u32 skipEdge, u32 skipVertex) {
+  u32 n = numberOfVertices(G);
+  u32 *xs = genArray(G->_edgeArraySize), *ys = genArray(G->_edgeArraySize);
+  u32 m = 0;
+  Edge skipped = skipEdge == NO_PARENT ? (Edge){0, 0, NULL, NULL}
+                                       : (G->_edges)[skipEdge];
+  bool found = false;
+  for (u32 i = 0; i < G->_edgeArraySize; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x >= e.y || e.x == skipVertex || e.y == skipVertex)
+      continue;
+    if (!found && skipEdge != NO_PARENT &&
+        min(e.x, e.y) == min(skipped.x, skipped.y) &&
+        max(e.x, e.y) == max(skipped.x, skipped.y)) {
+      found = true;
+      continue;
+    }
+    xs[m] = e.x;
+    ys[m++] = e.y;
+  }
+  Graph *H = initGraph(n, m, STD_FLAG);
+  for (u32 i = 0; i < m; i++)
+    setEdge(H, i, xs[i], ys[i], NULL, NULL);
+  formatEdges(H);
+  free(xs);
+  free(ys);
+  return H;
+}
+
+/**
+ * @brief Checks every answer of the engine on `G` against removing each
+ * edge and each vertex and counting components.
+ */
+static void checkAgainstRemovals(Graph *G) {
+  u32 n = numberOfVertices(G);
+  u32 components = connectedComponents(G, NULL);
+  u32 *bridges = genArray(n);
+  u32 nBridges = findBridges(G, bridges);
+  bool *isBridgeEntry = (bool *)calloc(G->_edgeArraySize + 1, sizeof(bool));
+  for (u32 k = 0; k < nBridges; k++)
+    isBridgeEntry[bridges[k]] = true;
+  BridgeOracle *O = createBridgeOracle(G);
+  assert(O->nBridges == nBridges);
+
+  u32 found = 0;
+  for (u32 i = 0; i < G->_edgeArraySize; i++) {
+    Edge e = (G->_edges)[i];
+    if (e.x >= e.y)
+      continue;
+    Graph *H = graphWithout(G, i, NO_PARENT);
+    bool bridge = connectedComponents(H, NULL) > components;
+    assert(isBridge(O, e.x, e.y) == bridge);
+    assert(isBridge(O, e.y, e.x) == bridge);
+    u32 twin = edgeIndex(G, e.y, e.x);
+    found += isBridgeEntry[i] || isBridgeEntry[twin];
+    assert((isBridgeEntry[i] || isBridgeEntry[twin]) == bridge);
+    dumpGraph(H);
+  }
+  assert(found == nBridges);
+
+  // A vertex lies in as many biconnected components as there are pieces
+  // its removal leaves of its component.
+  bool *cut = (bool *)malloc(n * sizeof(bool));
+  u32 nCut = articulationPoints(G, cut);
+  u32 *edgeLabels = genArray(G->_edgeArraySize);
+  u32 nBCC = biconnectedComponents(G, edgeLabels);
+  u32 *seen = genArray(nBCC);
+  u32 *bccEdges = genArray(nBCC);
+  u32 counted = 0;
+  for (u32 v = 0; v < n; v++) {
+    Graph *H = graphWithout(G, NO_PARENT, v);
+    u32 pieces = connectedComponents(H, NULL) - components;
+    assert(cut[v] == (pieces > 1));
+    counted += cut[v];
+    u32 distinct = 0;
+    for (u32 i = firstNeighbourIndex(G, v);
+         i < firstNeighbourIndex(G, v) + degree(v, G); i++) {
+      u32 label = edgeLabels[i];
+      assert(label < nBCC);
+      assert(edgeLabels[edgeIndex(G, (G->_edges)[i].y, v)] == label ||
+             isNeighbour(v, (G->_edges)[i].y, G));
+      if (seen[label] != v + 1) {
+        seen[label] = v + 1;
+        distinct++;
+      }
+      bccEdges[label]++;
+    }
+    assert(distinct == pieces);
+    dumpGraph(H);
+  }
+  assert(counted == nCut);
+  for (u32 i = 0; i < G->_edgeArraySize; i++) {
+    Edge e = (G->_edges)[i];
+    bool bridge = isBridge(O, e.x, e.y);
+    assert(bridge == (bccEdges[edgeLabels[i]] == 2));
+  }
+
+  // 2-edge-connected components are the components without the bridges.
+  u32 *labels = genArray(n);
+  u32 count = twoEdgeConnectedComponents(G, labels);
+  assert(count == components + nBridges);
+  for (u32 i = 0; i < G->_edgeArraySize; i++) {
+    Edge e = (G->_edges)[i];
+    assert((labels[e.x] == labels[e.y]) == !isBridge(O, e.x, e.y));
+  }
+
+  free(labels);
+  free(seen);
+  free(bccEdges);
+  free(edgeLabels);
+  free(cut);
+  free(isBridgeEntry);
+  free(bridges);
+  dumpBridgeOracle(O);
+}
+
+void testBridges() {
+  srand(48);
+  for (u32 round = 0; round < 30; round++) {
+    Graph *G = randomMultigraph(40, 30 + round * 2, 0, STD_FLAG, false);
+    checkAgainstRemovals(G);
+    dumpGraph(G);
+  }
+  Graph *G = genGrid(6, 7, 10);
+  checkAgainstRemovals(G);
+  dumpGraph(G);
+  G = genKronecker(7, 2, 10);
+  checkAgainstRemovals(G);
+  dumpGraph(G);
+
+  // A doubled edge is no bridge; a self-loop changes nothing.
+  G = initGraph(3, 4, STD_FLAG);
+  setEdge(G, 0, 0, 1, NULL, NULL);
+  setEdge(G, 1, 0, 1, NULL, NULL);
+  setEdge(G, 2, 1, 2, NULL, NULL);
+  setEdge(G, 3, 2, 2, NULL, NULL);
+  formatEdges(G);
+  assert(findBridges(G, NULL) == 1);
+  assert(articulationPoints(G, NULL) == 1);
+  u32 edgeLabels[8];
+  assert(biconnectedComponents(G, edgeLabels) == 2);
+  assert(edgeLabels[edgeIndex(G, 2, 2)] == NO_COMPONENT);
+  assert(twoEdgeConnectedComponents(G, NULL) == 2);
+  dumpGraph(G);
+  printf("Bridges test passed.\n");
+}
+
+void testLongPath() {
+  u32 n = 1000000;
+  Graph *G = initGraph(n, n - 1, STD_FLAG);
+  for (u32 v = 0; v + 1 < n; v++)
+    setEdge(G, v, v, v + 1, NULL, NULL);
+  formatEdges(G);
+  assert(findBridges(G, NULL) == n - 1);
+  assert(articulationPoints(G, NULL) == n - 2);
+  assert(biconnectedComponents(G, NULL) == n - 1);
+  dumpGraph(G);
+  printf("Long path test passed.\n");
+}
+
+void testGenFromKn() {
+  srand(49);
+  u32 n = 150, m = 200;
+  Graph *G = genFromKn(n, m);
+  assert(numberOfVertices(G) == n && numberOfEdges(G) == m);
+  assert(connectedComponents(G, NULL) == 1);
+  dumpGraph(G);
+  printf("genFromKn test passed.\n");
+}
+
+int main() {
+  testBridges();
+  testLongPath();
+  testGenFromKn();
+}
@@ -0,0 +1,175 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "ch.h"
+#include "dijkstra.h"
+#include "generator.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Checks distances and unpacked paths of H against dijkstra, from
+ * every source of G.
+ */
+static void checkHierarchy(ContractionHierarchy *H, Graph *G) {
+  u32 n = numberOfVertices(G);
+  CHQuery *Q = createCHQuery(H);
+  for (u32 s = 0; s < n; s++) {
+    u32 *expected = dijkstra(s, G);
+    for (u32 t = 0; t < n; t++) {
+      assert(chDistance(Q, s, t) == expected[t]);
+      Path *P = chShortestPath(Q, s, t);
+      assert(P->distance == expected[t]);
+      if (expected[t] == INT_MAX)
+        assert(P->length == 0);
+      else
+        assert(isPathOf(P, G, s, t));
+      dumpPath(P);
+    }
+    free(expected);
+  }
+  dumpCHQuery(Q);
+}
+
+void testContractionHierarchy() {
+  srand(21);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  for (u32 f = 0; f < 2; f++) {
+    for (u32 trial = 0; trial < 20; trial++) {
+      u32 n = 2 + rand() % 50;
+      Graph *G = randomWeightedGraph(n, 2 * n, 20, flags[f]);
+      ContractionHierarchy *H = buildContractionHierarchy(G, NULL);
+      checkHierarchy(H, G);
+      dumpContractionHierarchy(H);
+      dumpGraph(G);
+    }
+  }
+  printf("Contraction hierarchy test passed.\n");
+}
+
+/**
+ * @brief Checks that H and K are the same hierarchy.
+ */
+static void checkSameHierarchy(ContractionHierarchy *H,
+                               ContractionHierarchy *K) {
+  u32 n = H->n;
+  assert(K->n == n);
+  assert(memcmp(H->rank, K->rank, n * sizeof(u32)) == 0);
+  assert(memcmp(H->upFirst, K->upFirst, (n + 1) * sizeof(u32)) == 0);
+  assert(memcmp(H->downFirst, K->downFirst, (n + 1) * sizeof(u32)) == 0);
+  assert(memcmp(H->up, K->up, H->upFirst[n] * sizeof(CHArc)) == 0);
+  assert(memcmp(H->down, K->down, H->downFirst[n] * sizeof(CHArc)) == 0);
+}
+
+void testParallelPreprocessing() {
+  srand(22);
+  Graph *graphs[3] = {genGrid(15, 15, 10),
+                      randomWeightedGraph(300, 900, 20, W_FLAG | D_FLAG),
+                      randomWeightedGraph(300, 700, 20, W_FLAG)};
+  ThreadPool *pool = createThreadPool(4);
+  for (u32 g = 0; g < 3; g++) {
+    ContractionHierarchy *H = buildContractionHierarchy(graphs[g], pool);
+    checkHierarchy(H, graphs[g]);
+    ContractionHierarchy *K = buildContractionHierarchy(graphs[g], NULL);
+    checkSameHierarchy(H, K);
+    dumpContractionHierarchy(H);
+    dumpContractionHierarchy(K);
+    dumpGraph(graphs[g]);
+  }
+  dumpThreadPool(pool);
+  printf("Parallel preprocessing test passed.\n");
+}
+
+void testQueriesExploreLittle() {
+  srand(23);
+  u32 side = 60;
+  Graph *G = genGrid(side, side, 10);
+  ContractionHierarchy *H = buildContractionHierarchy(G, NULL);
+  CHQuery *Q = createCHQuery(H);
+  u32 s = 0, t = side * side - 1;
+  Path *D = shortestPath(G, s, t);
+  assert(chDistance(Q, s, t) == D->distance);
+  assert(Q->settled < D->settled / 4);
+  dumpPath(D);
+  dumpCHQuery(Q);
+  dumpContractionHierarchy(H);
+  dumpGraph(G);
+  printf("Contraction hierarchy exploration test passed.\n");
+}
+
+void testQueriesReuseBuffers() {
+  srand(25);
+  u32 side = 60, n = side * side;
+  Graph *G = genGrid(side, side, 10);
+  ContractionHierarchy *H = buildContractionHierarchy(G, NULL);
+  CHQuery *Q = createCHQuery(H);
+  for (u32 k = 0; k < 1000; k++) {
+    u32 s = rand() % n, t = rand() % n;
+    Path *P = chShortestPath(Q, s, t);
+    assert(isPathOf(P, G, s, t));
+    // The returned path is sized to its length, so a reader past it trips
+    // the sanitizers.
+    assert(P->vertices[P->length - 1] == t);
+    dumpPath(P);
+  }
+  // A grid path has fewer than 2 * side vertices; the buffers are sized by
+  // the paths, not by the graph.
+  assert(Q->pathCapacity <= 4 * side && Q->stackCapacity <= 4 * side);
+  dumpCHQuery(Q);
+  dumpContractionHierarchy(H);
+  dumpGraph(G);
+  printf("Contraction hierarchy buffer reuse test passed.\n");
+}
+
+void testHierarchyFile() {
+  srand(24);
+  Graph *G = randomWeightedGraph(40, 100, 20, W_FLAG | D_FLAG);
+  ContractionHierarchy *H = buildContractionHierarchy(G, NULL);
+  writeContractionHierarchy(H, "hierarchy.bin");
+  ContractionHierarchy *R = readContractionHierarchy("hierarchy.bin");
+  remove("hierarchy.bin");
+  assert(R->n == H->n);
+  assert(R->upFirst[H->n] == H->upFirst[H->n]);
+  assert(R->downFirst[H->n] == H->downFirst[H->n]);
+  checkHierarchy(R, G);
+  dumpContractionHierarchy(H);
+  dumpContractionHierarchy(R);
+  dumpGraph(G);
+  printf("Contraction hierarchy file test passed.\n");
+}
+
+int main() {
+  testContractionHierarchy();
+  testParallelPreprocessing();
+  testQueriesExploreLittle();
+  testQueriesReuseBuffers();
+  testHierarchyFile();
+}
@@ -0,0 +1,146 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+#include "api.h"
+#include "components.h"
+#include "generator.h"
+#include "search.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Checks `labels` against a union-find over the edges: two vertices
+ * share a label iff they share a set, and labels grow with the smallest
+ * vertex of their component.
+ */
+static void checkLabels(Graph *G, u32 *labels, u32 count) {
+  u32 n = numberOfVertices(G);
+  UnionFind *U = createUnionFind(n);
+  for (u32 i = 0; i < G->_edgeArraySize; i++)
+    unionSets(U, (G->_edges)[i].x, (G->_edges)[i].y);
+  assert(U->sets == count);
+  u32 *smallest = genArray(count);
+  u32 next = 0;
+  for (u32 v = 0; v < n; v++) {
+    u32 root = findSet(U, v);
+    assert(labels[v] == labels[root]);
+    if (labels[v] == next)
+      smallest[next++] = v;
+    assert(labels[v] < next);
+    assert(sameSet(U, v, smallest[labels[v]]));
+  }
+  assert(next == count);
+  free(smallest);
+  dumpUnionFind(U);
+}
+
+void testConnectedComponents() {
+  srand(47);
+  Graph *graphs[6] = {genKronecker(12, 4, 10),
+                      randomMultigraph(3000, 1400, 0, STD_FLAG, true),
+                      randomMultigraph(3000, 2000, 0, D_FLAG, true),
+                      randomMultigraph(2000, 5000, 0, D_FLAG, true),
+                      genGrid(30, 40, 10),
+                      initGraph(100, 0, STD_FLAG)};
+  formatEdges(graphs[5]);
+  ThreadPool *pool = createThreadPool(4);
+  for (u32 g = 0; g < 6; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    u32 *labels = genArray(n);
+    u32 *parallel = genArray(n);
+    u32 count = connectedComponents(G, labels);
+    checkLabels(G, labels, count);
+    assert(parallelConnectedComponents(G, parallel, pool) == count);
+    assert(memcmp(labels, parallel, n * sizeof(u32)) == 0);
+    assert(parallelConnectedComponents(G, parallel, NULL) == count);
+    assert(memcmp(labels, parallel, n * sizeof(u32)) == 0);
+    assert(connectedComponents(G, NULL) == count);
+    assert(isConnected(G) == (count == 1));
+
+    u32 *sizes = componentSizes(labels, n, count);
+    u32 largest = 0, total = 0;
+    for (u32 c = 0; c < count; c++) {
+      total += sizes[c];
+      largest = max(largest, sizes[c]);
+    }
+    assert(total == n);
+    u32 *vertices = genArray(largest);
+    Graph *H = largestComponent(G, labels, count, vertices);
+    assert(numberOfVertices(H) == largest);
+    assert(connectedComponents(H, NULL) == 1);
+    u64 entries = 0;
+    for (u32 v = 0; v < largest; v++) {
+      assert(labels[vertices[v]] == labels[vertices[0]]);
+      assert(degree(v, H) == degree(vertices[v], G));
+      entries += degree(v, H);
+      if (v > 0)
+        assert(vertices[v - 1] < vertices[v]);
+    }
+    for (u32 i = 0; i < H->_edgeArraySize; i++) {
+      Edge e = (H->_edges)[i];
+      assert(isNeighbour(vertices[e.x], vertices[e.y], G));
+    }
+    free(vertices);
+    free(sizes);
+    dumpGraph(H);
+    free(labels);
+    free(parallel);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("connectedComponents test passed.\n");
+}
+
+void testWeightedSubgraph() {
+  // Two triangles, one with a self-loop; the weights must follow the edges.
+  Graph *G = initGraph(6, 7, W_FLAG);
+  u32 edges[7][3] = {{0, 2, 5}, {2, 4, 7}, {4, 0, 9}, {1, 3, 1},
+                     {3, 5, 2}, {5, 1, 3}, {3, 3, 4}};
+  for (u32 i = 0; i < 7; i++)
+    setEdge(G, i, edges[i][0], edges[i][1], &edges[i][2], NULL);
+  formatEdges(G);
+  u32 labels[6];
+  assert(connectedComponents(G, labels) == 2);
+  u32 vertices[3];
+  Graph *H = componentSubgraph(G, labels, 1, vertices);
+  assert(vertices[0] == 1 && vertices[1] == 3 && vertices[2] == 5);
+  assert(numberOfEdges(H) == 4);
+  assert(*getEdge(0, 1, H).w == 1 && *getEdge(1, 2, H).w == 2);
+  assert(*getEdge(2, 0, H).w == 3 && *getEdge(1, 1, H).w == 4);
+  dumpGraph(H);
+  dumpGraph(G);
+  printf("componentSubgraph test passed.\n");
+}
+
+int main() {
+  testConnectedComponents();
+  testWeightedSubgraph();
+}
@@ -0,0 +1,106 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "deltastepping.h"
+#include "dijkstra.h"
+#include "generator.h"
+#include "threadpool.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Checks that delta-stepping agrees with dijkstra from a few sources,
+ * for several bucket widths.
+ */
+static void checkAgainstDijkstra(Graph *G, ThreadPool *pool) {
+  u32 n = numberOfVertices(G);
+  u32 deltas[4] = {0, 1, 7, 1000};
+  for (u32 k = 0; k < 3; k++) {
+    u32 s = generate_random_u32_in_range(0, n - 1);
+    u32 *expected = dijkstra(s, G);
+    for (u32 d = 0; d < 4; d++) {
+      u32 *distances = deltaStepping(s, G, deltas[d], pool);
+      for (u32 i = 0; i < n; i++) {
+        assert(distances[i] == expected[i]);
+      }
+      free(distances);
+    }
+    free(expected);
+  }
+}
+
+void testDeltaSteppingSequential() {
+  srand(3);
+  Graph *G = genKronecker(9, 8, 100);
+  checkAgainstDijkstra(G, NULL);
+  dumpGraph(G);
+  Graph *grid = genGrid(20, 30, 50);
+  checkAgainstDijkstra(grid, NULL);
+  dumpGraph(grid);
+  printf("testDeltaSteppingSequential passed.\n");
+}
+
+void testDeltaSteppingParallel() {
+  srand(4);
+  Graph *G = genKronecker(10, 16, 255);
+  Graph *grid = genGrid(40, 40, 100);
+  u32 sizes[3] = {2, 4, 8};
+  for (u32 k = 0; k < 3; k++) {
+    ThreadPool *pool = createThreadPool(sizes[k]);
+    checkAgainstDijkstra(G, pool);
+    checkAgainstDijkstra(grid, pool);
+    dumpThreadPool(pool);
+  }
+  dumpGraph(G);
+  dumpGraph(grid);
+  printf("testDeltaSteppingParallel passed.\n");
+}
+
+void testDisconnected() {
+  u32 w = 4;
+  Graph *G = initGraph(5, 2, W_FLAG);
+  setEdge(G, 0, 0, 1, &w, NULL);
+  setEdge(G, 1, 3, 4, &w, NULL);
+  formatEdges(G);
+  ThreadPool *pool = createThreadPool(2);
+  u32 *distances = deltaStepping(0, G, 0, pool);
+  assert(distances[0] == 0 && distances[1] == 4);
+  assert(distances[2] == INT_MAX && distances[3] == INT_MAX);
+  free(distances);
+  dumpThreadPool(pool);
+  dumpGraph(G);
+  printf("testDisconnected passed.\n");
+}
+
+int main() {
+  testDeltaSteppingSequential();
+  testDeltaSteppingParallel();
+  testDisconnected();
+  printf("All tests passed.\n");
+  return 0;
+}
@@ -0,0 +1,165 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "dense.h"
+#include "dijkstra.h"
+#include "generator.h"
+#include "testgraphs.h"
+#include "utils.h"
+#include "workspace.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const DenseKernel kernels[3] = {DENSE_SCALAR, DENSE_AVX2,
+                                       DENSE_AVX512};
+static const char *kernelNames[4] = {"auto", "scalar", "AVX2", "AVX-512"};
+
+/**
+ * @brief Weight of a minimum spanning tree of the connected graph `G`,
+ * growing it by scanning every edge for the lightest one leaving the tree.
+ */
+static u64 naiveMSTWeight(Graph *G) {
+  u32 n = numberOfVertices(G);
+  bool *inTree = (bool *)calloc(n, sizeof(bool));
+  inTree[0] = true;
+  u64 total = 0;
+  for (u32 added = 1; added < n; added++) {
+    u32 best = INT_MAX, next = n;
+    for (u32 i = 0; i < 2 * numberOfEdges(G); i++) {
+      Edge e = (G->_edges)[i];
+      if (inTree[e.x] && !inTree[e.y] && *e.w < best) {
+        best = *e.w;
+        next = e.y;
+      }
+    }
+    assert(next < n);
+    inTree[next] = true;
+    total += best;
+  }
+  free(inTree);
+  return total;
+}
+
+void testDenseDijkstra() {
+  srand(37);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  for (u32 k = 0; k < 3; k++) {
+    DenseKernel kernel = selectDenseKernel(kernels[k]);
+    printf("Dense Dijkstra with the %s kernel.\n", kernelNames[kernel]);
+    for (u32 f = 0; f < 2; f++) {
+      u32 n = 100;
+      Graph *G = randomWeightedGraph(n, n * n / 3, 1000, flags[f]);
+      DenseGraph *D = denseFromGraph(G);
+      u32 *parents = genArray(n);
+      for (u32 s = 0; s < n; s += 9) {
+        u32 *expected = dijkstra(s, G);
+        u32 *distances = denseDijkstra(D, s, parents);
+        assert(parents[s] == s);
+        for (u32 v = 0; v < n; v++) {
+          assert(distances[v] == expected[v]);
+          if (v == s)
+            continue;
+          if (distances[v] == INT_MAX) {
+            assert(parents[v] == NO_PARENT);
+            continue;
+          }
+          u32 p = parents[v];
+          assert(distances[p] + D->weights[(u64)p * D->stride + v] ==
+                 distances[v]);
+        }
+        free(expected);
+        free(distances);
+      }
+      free(parents);
+      dumpDenseGraph(D);
+      dumpGraph(G);
+    }
+
+    // Unweighted graphs count hops.
+    Graph *K = genCompleteGraph(20);
+    DenseGraph *D = denseFromGraph(K);
+    u32 *distances = denseDijkstra(D, 3, NULL);
+    for (u32 v = 0; v < 20; v++) {
+      assert(distances[v] == (v == 3 ? 0 : 1));
+    }
+    free(distances);
+    dumpDenseGraph(D);
+    dumpGraph(K);
+  }
+  selectDenseKernel(DENSE_AUTO);
+  printf("Dense Dijkstra test passed.\n");
+}
+
+void testDensePrim() {
+  srand(41);
+  for (u32 k = 0; k < 3; k++) {
+    DenseKernel kernel = selectDenseKernel(kernels[k]);
+    printf("Dense Prim with the %s kernel.\n", kernelNames[kernel]);
+    u32 n = 120;
+    Graph *G = randomWeightedGraph(n, n * n / 3, 1000, W_FLAG);
+    u64 expected = naiveMSTWeight(G);
+
+    DenseGraph *D = denseFromGraph(G);
+    u64 total;
+    u32 *parents = densePrim(D, 0, &total);
+    assert(total == expected);
+    u64 sum = 0;
+    for (u32 v = 1; v < n; v++) {
+      assert(parents[v] != NO_PARENT);
+      sum += D->weights[(u64)parents[v] * D->stride + v];
+    }
+    assert(sum == expected);
+    free(parents);
+    dumpDenseGraph(D);
+    dumpGraph(G);
+
+    // A forest: only the component of the start vertex is spanned.
+    u32 weights[4] = {3, 1, 5, 2};
+    Graph *F = initGraph(5, 4, W_FLAG);
+    setEdge(F, 0, 0, 1, &weights[0], NULL);
+    setEdge(F, 1, 1, 2, &weights[1], NULL);
+    setEdge(F, 2, 0, 2, &weights[2], NULL);
+    setEdge(F, 3, 3, 4, &weights[3], NULL);
+    formatEdges(F);
+    D = denseFromGraph(F);
+    parents = densePrim(D, 0, &total);
+    assert(total == 4);
+    assert(parents[0] == 0 && parents[1] == 0 && parents[2] == 1);
+    assert(parents[3] == NO_PARENT && parents[4] == NO_PARENT);
+    free(parents);
+    dumpDenseGraph(D);
+    dumpGraph(F);
+  }
+  selectDenseKernel(DENSE_AUTO);
+  printf("Dense Prim test passed.\n");
+}
+
+int main() {
+  testDenseDijkstra();
+  testDensePrim();
+}
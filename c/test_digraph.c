@@ -100,6 +100,44 @@ void testAddEdge() {
   printf("testAddEdge passed.\n");
 }
 
+/**
+ * @brief Tests readGraph on a generated file with arcs x ~~> x + 1 and
+ * x ~~> x + 3, so it is checked even where graphs/simpleDigraph.txt is not
+ * available. Arcs are written out of order and must come back sorted.
+ */
+void testReadGeneratedGraph() {
+  u32 n = 40, m = 2 * n - 4;
+  FILE *f = fopen("generatedDigraph.txt", "w");
+  assert(f != NULL);
+  fprintf(f, "p edge %u %u D_FLAG\n", n, m);
+  for (u32 d = 1; d <= 3; d += 2)
+    for (u32 x = 0; x + d < n; x++)
+      fprintf(f, "e %u %u\n", x, x + d);
+  fclose(f);
+
+  Graph *G = readGraph("generatedDigraph.txt");
+  remove("generatedDigraph.txt");
+  assert(G != NULL);
+  assert(G->_g_flag == D_FLAG);
+  assert(G->n == n);
+  assert(G->m == m);
+  assert(G->_edgeArraySize == m);
+  u32 i = 0;
+  for (u32 x = 0; x < n; x++) {
+    for (u32 d = 1; d <= 3; d += 2) {
+      if (x + d >= n)
+        continue;
+      Edge e = getIthEdge(i++, G);
+      assert(e.x == x && e.y == x + d);
+    }
+  }
+  assert(i == m);
+  for (u32 y = 0; y < n; y++)
+    assert(inDegree(y, G) == (u32)((y >= 1) + (y >= 3)));
+  dumpGraph(G);
+  printf("testReadGeneratedGraph passed.\n");
+}
+
 void testReadGraph() {
 
   Graph *G = readGraph("graphs/simpleDigraph.txt");
@@ -129,6 +167,7 @@ void testReadGraph() {
 int main() {
   testInitGraph();
   testAddEdge();
+  testReadGeneratedGraph();
   testReadGraph();
   printf("All tests passed.\n");
   return 0;
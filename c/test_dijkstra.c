@@ -29,6 +29,8 @@
 
 
 #include "dijkstra.h"
+#include "generator.h"
+#include "testgraphs.h"
 #include "utils.h"
 #include <assert.h>
 #include <limits.h>
@@ -54,4 +56,179 @@ void test_denseGraph() {
   printf("Dense graph test passed.\n");
 }
 
-int main() { test_denseGraph(); }
+/**
+ * @brief Reference distances computed with Bellman-Ford.
+ */
+static u32 *bellmanFord(u32 s, Graph *G) {
+  u32 n = numberOfVertices(G);
+  u32 *d = genArray(n);
+  for (u32 i = 0; i < n; i++)
+    d[i] = INT_MAX;
+  d[s] = 0;
+  for (u32 round = 0; round < n; round++) {
+    for (u32 i = 0; i < G->_edgeArraySize; i++) {
+      Edge e = getIthEdge(i, G);
+      if (d[e.x] != INT_MAX && d[e.x] + *e.w < d[e.y])
+        d[e.y] = d[e.x] + *e.w;
+    }
+  }
+  return d;
+}
+
+void test_randomGraphs() {
+  srand(42);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  for (u32 f = 0; f < 2; f++) {
+    for (u32 trial = 0; trial < 40; trial++) {
+      u32 n = 2 + rand() % 60;
+      // Alternate small and large weights to exercise both integer engines.
+      u32 maxWeight = trial % 2 ? 100 : 100000;
+      Graph *G = randomWeightedGraph(n, 3 * n, maxWeight, flags[f]);
+      u32 s = rand() % n;
+      u32 *expected = bellmanFord(s, G);
+      u32 *(*engines[4])(u32, Graph *) = {dijkstra, radixDijkstra,
+                                          dialDijkstra, integerDijkstra};
+      for (u32 k = 0; k < 4; k++) {
+        u32 *distances = engines[k](s, G);
+        for (u32 i = 0; i < n; i++) {
+          assert(distances[i] == expected[i]);
+        }
+        free(distances);
+      }
+      free(expected);
+      dumpGraph(G);
+    }
+  }
+  printf("Random graph test passed.\n");
+}
+
+void test_pointToPoint() {
+  srand(7);
+  g_flag flags[2] = {W_FLAG, W_FLAG | D_FLAG};
+  for (u32 f = 0; f < 2; f++) {
+    for (u32 trial = 0; trial < 30; trial++) {
+      u32 n = 2 + rand() % 60;
+      Graph *G = randomWeightedGraph(n, 2 * n, 50, flags[f]);
+      ReverseIndex *R = (flags[f] & D_FLAG) ? buildReverseIndex(G) : NULL;
+      u32 s = rand() % n;
+      u32 *expected = dijkstra(s, G);
+      // Reused across the queries of this graph, and larger than it.
+      SearchWorkspace *F = createSearchWorkspace(n + 5);
+      SearchWorkspace *V = createSearchWorkspace(n + 5);
+      for (u32 t = 0; t < n; t++) {
+        Path *P = shortestPath(G, s, t);
+        Path *B = bidirectionalShortestPath(G, s, t, R);
+        Path *Q = workspaceBidirectionalShortestPath(G, s, t, R, F, V);
+        assert(P->distance == expected[t] && B->distance == expected[t]);
+        assert(Q->distance == expected[t] && Q->settled == B->settled);
+        if (expected[t] == INT_MAX) {
+          assert(P->length == 0 && B->length == 0 && Q->length == 0);
+        } else {
+          assert(isPathOf(P, G, s, t));
+          assert(isPathOf(B, G, s, t));
+          assert(isPathOf(Q, G, s, t));
+        }
+        dumpPath(P);
+        dumpPath(B);
+        dumpPath(Q);
+      }
+      free(expected);
+      dumpSearchWorkspace(F);
+      dumpSearchWorkspace(V);
+      dumpReverseIndex(R);
+      dumpGraph(G);
+    }
+  }
+  printf("Point-to-point test passed.\n");
+}
+
+void test_pointToPointExploresLess() {
+  srand(8);
+  u32 side = 60;
+  Graph *G = genGrid(side, side, 10);
+  u32 n = side * side;
+  // Two vertices close to each other in the middle of the grid.
+  u32 s = (side / 2) * side + side / 2;
+  u32 t = s + 3 * side + 3;
+  Path *P = shortestPath(G, s, t);
+  Path *B = bidirectionalShortestPath(G, s, t, NULL);
+  assert(P->distance == B->distance);
+  assert(P->settled < n / 4);
+  assert(B->settled < P->settled);
+  dumpPath(P);
+  dumpPath(B);
+  dumpGraph(G);
+  printf("Point-to-point exploration test passed.\n");
+}
+
+void test_workspace() {
+  srand(9);
+  u32 n = 80;
+  Graph *G = randomWeightedGraph(n, 2 * n, 50, W_FLAG | D_FLAG);
+  SearchWorkspace *W = createSearchWorkspace(n);
+  for (u32 s = 0; s < n; s++) {
+    u32 *expected = dijkstra(s, G);
+    workspaceDijkstra(s, G, W);
+    for (u32 v = 0; v < n; v++) {
+      assert(workspaceDistance(W, v) == expected[v]);
+      if (v != s && expected[v] != INT_MAX) {
+        // The parent is the previous vertex of a shortest path.
+        u32 p = W->parents[v];
+        Edge e = (G->_edges)[edgeIndex(G, p, v)];
+        assert(e.x == p && e.y == v);
+        assert(expected[p] + *e.w == expected[v]);
+      }
+    }
+    u32 t = rand() % n;
+    Path *P = workspaceShortestPath(G, s, t, W);
+    assert(P->distance == expected[t]);
+    dumpPath(P);
+    free(expected);
+  }
+  dumpSearchWorkspace(W);
+  dumpGraph(G);
+  printf("Workspace test passed.\n");
+}
+
+void test_shortestPathTree() {
+  srand(10);
+  u32 n = 60;
+  Graph *G = randomWeightedGraph(n, 2 * n, 50, W_FLAG | D_FLAG);
+  u32 *parents = genArray(n), *parentEdges = genArray(n);
+  u32 s = rand() % n;
+  u32 *distances = dijkstraWithParents(s, G, parents, parentEdges);
+  u32 *expected = dijkstra(s, G);
+  for (u32 t = 0; t < n; t++) {
+    assert(distances[t] == expected[t]);
+    Path *P = extractPath(parents, distances, s, t);
+    assert(P->distance == expected[t]);
+    if (expected[t] == INT_MAX) {
+      assert(parents[t] == NO_PARENT && P->length == 0);
+    } else {
+      // Walking the parent edges back from t adds up to its distance.
+      u32 total = 0;
+      for (u32 i = P->length - 1; i > 0; i--) {
+        Edge e = (G->_edges)[parentEdges[P->vertices[i]]];
+        assert(e.x == P->vertices[i - 1] && e.y == P->vertices[i]);
+        total += *e.w;
+      }
+      assert(total == expected[t]);
+    }
+    dumpPath(P);
+  }
+  free(distances);
+  free(expected);
+  free(parents);
+  free(parentEdges);
+  dumpGraph(G);
+  printf("Shortest path tree test passed.\n");
+}
+
+int main() {
+  test_randomGraphs();
+  test_pointToPoint();
+  test_pointToPointExploresLess();
+  test_workspace();
+  test_shortestPathTree();
+  test_denseGraph();
+}
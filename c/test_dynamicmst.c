@@ -0,0 +1,141 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "dynamicmst.h"
+#include "kruskal.h"
+#include "testgraphs.h"
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Checks D against a minimum spanning forest recomputed from its
+ * live edges.
+ */
+static void checkAgainstKruskal(DynamicMST *D) {
+  u32 live = 0;
+  for (u32 e = 0; e < D->m; e++)
+    live += D->alive[e] && D->ends[2 * e] != D->ends[2 * e + 1];
+  Graph *G = initGraph(D->n, live, W_FLAG);
+  UnionFind *U = createUnionFind(D->n);
+  u32 i = 0;
+  for (u32 e = 0; e < D->m; e++) {
+    if (!D->alive[e] || D->ends[2 * e] == D->ends[2 * e + 1])
+      continue;
+    setEdge(G, i++, D->ends[2 * e], D->ends[2 * e + 1], &D->weights[e], NULL);
+    unionSets(U, D->ends[2 * e], D->ends[2 * e + 1]);
+  }
+  formatEdges(G);
+
+  u32 *chosen = genArray(D->n);
+  u64 expected;
+  kruskalEdges(G, chosen, &expected, NULL);
+  assert(dynamicMSTWeight(D) == expected);
+  assert(D->forestEdges == D->n - U->sets);
+  for (u32 k = 0; k < 20; k++) {
+    u32 x = rand() % D->n, y = rand() % D->n;
+    assert(dynamicMSTConnected(D, x, y) == sameSet(U, x, y));
+  }
+  free(chosen);
+  dumpUnionFind(U);
+  dumpGraph(G);
+}
+
+void testDynamicMSTSmall() {
+  // A square 0-1-2-3 with the diagonal {0, 2}.
+  u32 ends[5][2] = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {2, 3}};
+  u32 weights[5] = {1, 5, 4, 2, 3};
+  Graph *G = initGraph(4, 5, W_FLAG);
+  for (u32 i = 0; i < 5; i++)
+    setEdge(G, i, ends[i][0], ends[i][1], &weights[i], NULL);
+  formatEdges(G);
+  DynamicMST *D = createDynamicMST(G);
+  // Edges are numbered as their entries: {0,1}, {0,2}, {0,3}, {1,2}, {2,3}.
+  assert(dynamicMSTWeight(D) == 6);
+  assert(D->inForest[0] && D->inForest[3] && D->inForest[4]);
+
+  // The diagonal becomes the lightest edge on its cycles.
+  dynamicMSTSetWeight(D, 1, 1);
+  assert(dynamicMSTWeight(D) == 5 && D->inForest[1] && !D->inForest[3]);
+  // A new edge lighter than {2, 3}.
+  u32 e = dynamicMSTInsert(D, 1, 3, 2);
+  assert(e == 5 && dynamicMSTWeight(D) == 4 && !D->inForest[4]);
+  // Making {0, 1} heavy lets {1, 2} back in.
+  dynamicMSTSetWeight(D, 0, 10);
+  assert(dynamicMSTWeight(D) == 5 && D->inForest[3] && !D->inForest[0]);
+  // Deleting {0, 2} leaves {0, 3} as the only link to 0.
+  dynamicMSTDelete(D, 1);
+  assert(dynamicMSTWeight(D) == 8 && D->inForest[2]);
+  dynamicMSTDelete(D, 2);
+  dynamicMSTDelete(D, 0);
+  assert(!dynamicMSTConnected(D, 0, 1) && dynamicMSTConnected(D, 1, 2));
+  assert(dynamicMSTWeight(D) == 4 && D->forestEdges == 2);
+
+  Graph *F = dynamicMSTForest(D);
+  assert(numberOfEdges(F) == 2 && isNeighbour(1, 2, F) &&
+         isNeighbour(1, 3, F));
+  dumpGraph(F);
+  dumpDynamicMST(D);
+  dumpGraph(G);
+  printf("Small dynamic MST test passed.\n");
+}
+
+void testDynamicMSTRandom() {
+  srand(41);
+  u32 n = 60;
+  Graph *G = randomMultigraph(n, 150, 50, W_FLAG, false);
+  DynamicMST *D = createDynamicMST(G);
+  checkAgainstKruskal(D);
+  for (u32 step = 0; step < 3000; step++) {
+    u32 op = rand() % 4;
+    u32 e = rand() % D->m;
+    if (op == 0) {
+      dynamicMSTInsert(D, rand() % n, rand() % n, 1 + rand() % 50);
+    } else if (D->alive[e] && op == 1) {
+      dynamicMSTDelete(D, e);
+    } else if (D->alive[e]) {
+      dynamicMSTSetWeight(D, e, 1 + rand() % 50);
+    }
+    checkAgainstKruskal(D);
+  }
+  Graph *F = dynamicMSTForest(D);
+  u64 total = 0;
+  for (u32 i = 0; i < 2 * numberOfEdges(F); i++)
+    total += *getIthEdge(i, F).w;
+  assert(total / 2 == dynamicMSTWeight(D));
+  assert(numberOfEdges(F) == D->forestEdges);
+  dumpGraph(F);
+  dumpDynamicMST(D);
+  dumpGraph(G);
+  printf("Random dynamic MST test passed.\n");
+}
+
+int main() {
+  testDynamicMSTSmall();
+  testDynamicMSTRandom();
+}
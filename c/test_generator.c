@@ -38,6 +38,7 @@
 #include "search.h"    // Assuming all dependencies are included in generator.c
 #include <assert.h>
 #include <stdio.h>
+#include <time.h>
 #include <stdlib.h>
 
 void test_genCompleteGraph() {
@@ -189,6 +190,31 @@ void test_genFromKn() {
   printf("genFromKn passed.\n");
 }
 
+void test_genFromKnScaling() {
+  printf("Testing genFromKn at scale...\n");
+
+  // A tree, a sparse graph and one with most of Kn left.
+  u32 n = 1000;
+  u32 ms[3] = {n - 1, 2 * n, n * (n - 1) / 2 - n};
+  for (u32 k = 0; k < 3; k++) {
+    clock_t start = clock();
+    Graph *G = genFromKn(n, ms[k]);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("n = %u, m = %u: %.3f s\n", n, ms[k], seconds);
+    // Near-linear in the n^2 pairs: well under a second when optimized.
+    assert(seconds < 10);
+    assert(numberOfVertices(G) == n);
+    assert(numberOfEdges(G) == ms[k]);
+    assert(isConnected(G));
+    dumpGraph(G);
+  }
+  Graph *G = genFromKn(2, 1);
+  assert(numberOfEdges(G) == 1 && isConnected(G));
+  dumpGraph(G);
+
+  printf("genFromKn at scale passed.\n");
+}
+
 int main() {
   test_genCompleteGraph();
   test_fromPruferSequence();
@@ -198,6 +224,7 @@ int main() {
   test_genCGraphUnbound();
   test_genFromRandomTree();
   test_genFromKn();
+  test_genFromKnScaling();
 
   printf("All tests passed!\n");
   return 0;
@@ -36,6 +36,154 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#define LAYERED_SOURCES 5
+#define LAYERED_SINKS 10
+
+/**
+ * @brief Builds a random network from 0 to t = n - 1 whose arcs all go from
+ * a lower to a higher label. 0 ~~> 1 ~~> t is the only path with two arcs;
+ * every other vertex hangs from one or two random lower vertices, and the
+ * last LAYERED_SINKS of them also feed t. Arcs into t have capacity 1 to
+ * 20 and every other arc has capacity 1000, more than the total flow, so
+ * the arcs into t are a minimum cut and even a greedy augmentation finds
+ * the maximum flow. Its value is stored in `maxFlow`.
+ */
+Graph *layeredNetwork(u32 n, u32 *maxFlow) {
+  assert(n > LAYERED_SOURCES + LAYERED_SINKS + 1);
+  u32 t = n - 1;
+  u32 capacity = 1000;
+  u32 x[3 * n], y[3 * n], c[3 * n], m = 0;
+  *maxFlow = 0;
+  for (u32 v = 1; v <= LAYERED_SOURCES; v++) {
+    x[m] = 0, y[m] = v, c[m++] = capacity;
+  }
+  for (u32 v = LAYERED_SOURCES + 1; v < t; v++) {
+    u32 u = 1 + rand() % (v - 1);
+    u32 w = 1 + rand() % (v - 1);
+    x[m] = u, y[m] = v, c[m++] = capacity;
+    if (w != u) {
+      x[m] = w, y[m] = v, c[m++] = capacity;
+    }
+  }
+  x[m] = 1, y[m] = t, c[m] = 1 + rand() % 20;
+  *maxFlow += c[m++];
+  for (u32 v = t - LAYERED_SINKS; v < t; v++) {
+    x[m] = v, y[m] = t, c[m] = 1 + rand() % 20;
+    *maxFlow += c[m++];
+  }
+
+  Graph *G = initGraph(n, m, NETFLOW_FLAG);
+  u32 zero = 0;
+  for (u32 i = 0; i < m; i++) {
+    setEdge(G, i, x[i], y[i], &zero, &c[i]);
+  }
+  formatEdges(G);
+  return G;
+}
+
+/**
+ * @brief Asserts that the flow stored in the weights of N respects the
+ * capacities and is conserved at every vertex other than s and t.
+ */
+void checkFlow(Graph *N, u32 s, u32 t, u32 value) {
+  u32 n = numberOfVertices(N);
+  long balance[n];
+  for (u32 v = 0; v < n; v++) {
+    balance[v] = 0;
+  }
+  for (u32 i = 0; i < N->_edgeArraySize; i++) {
+    Edge e = getIthEdge(i, N);
+    assert(*e.w <= *e.c);
+    balance[e.x] -= *e.w;
+    balance[e.y] += *e.w;
+  }
+  for (u32 v = 0; v < n; v++) {
+    if (v != s && v != t)
+      assert(balance[v] == 0);
+  }
+  assert(balance[s] == -(long)value && balance[t] == (long)value);
+}
+
+/**
+ * @brief Tests flowBFS and workspaceFlowBFS on generated networks: the path
+ * found is the shortest one, 0 ~~> 1 ~~> t, and greedyFlow with flowBFS
+ * reaches the maximum flow.
+ */
+void test_greedyflowBFS() {
+  srand(34);
+  SearchWorkspace *W = createSearchWorkspace(200);
+  for (u32 trial = 0; trial < 20; trial++) {
+    u32 n = 20 + rand() % 180, maxFlow;
+    u32 t = n - 1;
+    Graph *N = layeredNetwork(n, &maxFlow);
+
+    InsertionArray *path = flowBFS(N, 0, t);
+    assert(path != NULL);
+    assert(insArrayGet(t, path) == 1 && insArrayGet(1, path) == 0);
+    dumpInsertionArray(path);
+    assert(workspaceFlowBFS(N, 0, t, W));
+    assert(W->parents[t] == 1 && W->parents[1] == 0);
+
+    assert(greedyFlow(N, 0, t, flowBFS) == maxFlow);
+    checkFlow(N, 0, t, maxFlow);
+    assert(flowBFS(N, 0, t) == NULL);
+    assert(!workspaceFlowBFS(N, 0, t, W));
+    dumpGraph(N);
+  }
+  dumpSearchWorkspace(W);
+  printf("test_greedyflowBFS passed.\n");
+}
+
+/**
+ * @brief Asserts that `path` stores an s-t path of arcs with remaining
+ * capacity in N, as parents from t back to s.
+ */
+void checkAugmentingPath(Graph *N, u32 s, u32 t, InsertionArray *path) {
+  u32 steps = 0;
+  for (u32 v = t; v != s; v = insArrayGet(v, path)) {
+    u32 u = insArrayGet(v, path);
+    assert(isNeighbour(u, v, N) && getRemainingCapacity(u, v, N) > 0);
+    assert(++steps < numberOfVertices(N));
+  }
+}
+
+/**
+ * @brief Tests flowDFS on generated networks: every path it returns is an
+ * augmenting path, greedyFlow with flowDFS reaches the maximum flow, and a
+ * path through 200000 vertices does not overflow the stack.
+ */
+void test_greedyflowDFS() {
+  srand(42);
+  for (u32 trial = 0; trial < 20; trial++) {
+    u32 n = 20 + rand() % 180, maxFlow;
+    u32 t = n - 1;
+    Graph *N = layeredNetwork(n, &maxFlow);
+
+    InsertionArray *path = flowDFS(N, 0, t);
+    assert(path != NULL);
+    checkAugmentingPath(N, 0, t, path);
+    dumpInsertionArray(path);
+
+    assert(greedyFlow(N, 0, t, flowDFS) == maxFlow);
+    checkFlow(N, 0, t, maxFlow);
+    assert(flowDFS(N, 0, t) == NULL);
+    dumpGraph(N);
+  }
+
+  u32 n = 200000, zero = 0, capacity = 5;
+  Graph *L = initGraph(n, n - 1, NETFLOW_FLAG);
+  for (u32 v = 0; v + 1 < n; v++) {
+    setEdge(L, v, v, v + 1, &zero, &capacity);
+  }
+  formatEdges(L);
+  InsertionArray *path = flowDFS(L, 0, n - 1);
+  assert(path != NULL);
+  checkAugmentingPath(L, 0, n - 1, path);
+  dumpInsertionArray(path);
+  dumpGraph(L);
+  printf("test_greedyflowDFS passed.\n");
+}
+
 void test_greedyflow() {
 
   Graph *G = readGraph("graphs/network.txt");
@@ -53,4 +201,8 @@ void test_greedyflow() {
   printGraph(G);
 }
 
-int main() { test_greedyflow(); }
+int main() {
+  test_greedyflowBFS();
+  test_greedyflowDFS();
+  test_greedyflow();
+}
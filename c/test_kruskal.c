@@ -0,0 +1,214 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "boruvka.h"
+#include "kruskal.h"
+#include "prim.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Checks that `F` is a spanning forest of `G` with as many trees as
+ * `G` has components, and that its neighbour lists are sorted.
+ */
+static void checkForest(Graph *G, Graph *F) {
+  u32 n = numberOfVertices(G);
+  UnionFind *components = createUnionFind(n);
+  for (u32 i = 0; i < 2 * numberOfEdges(G); i++)
+    unionSets(components, getIthEdge(i, G).x, getIthEdge(i, G).y);
+  UnionFind *trees = createUnionFind(n);
+  for (u32 i = 0; i < 2 * numberOfEdges(F); i++) {
+    Edge e = getIthEdge(i, F);
+    assert(isNeighbour(e.x, e.y, G));
+    if (i > 0) {
+      Edge p = getIthEdge(i - 1, F);
+      assert(p.x < e.x || (p.x == e.x && p.y < e.y));
+    }
+    if (e.x < e.y)
+      assert(unionSets(trees, e.x, e.y));
+  }
+  assert(trees->sets == components->sets);
+  assert(numberOfEdges(F) == n - trees->sets);
+  dumpUnionFind(components);
+  dumpUnionFind(trees);
+}
+
+static u64 forestWeight(Graph *F) {
+  u64 total = 0;
+  for (u32 i = 0; i < 2 * numberOfEdges(F); i++)
+    total += *getIthEdge(i, F).w;
+  return total / 2;
+}
+
+void testUnionFind() {
+  UnionFind *U = createUnionFind(10);
+  assert(U->sets == 10);
+  assert(unionSets(U, 0, 1) && unionSets(U, 2, 3) && unionSets(U, 1, 3));
+  assert(!unionSets(U, 0, 2));
+  assert(sameSet(U, 0, 3) && !sameSet(U, 0, 4));
+  assert(U->sets == 7);
+  for (u32 x = 4; x < 9; x++)
+    unionSets(U, x, x + 1);
+  assert(U->sets == 2 && sameSet(U, 4, 9));
+  resetUnionFind(U);
+  assert(U->sets == 10 && !sameSet(U, 0, 1));
+  dumpUnionFind(U);
+  printf("Union-find test passed.\n");
+}
+
+void testSortEdgesByWeight() {
+  srand(39);
+  u32 maxWeights[2] = {7, 2000000000};
+  ThreadPool *pool = createThreadPool(3);
+  for (u32 r = 0; r < 2; r++) {
+    Graph *G = randomMultigraph(20000, 3 * KRUSKAL_PARALLEL_SORT / 2,
+                                maxWeights[r], W_FLAG, false);
+    u32 k, kParallel;
+    KeyedEdge *sorted = sortEdgesByWeight(G, &k, NULL);
+    KeyedEdge *parallel = sortEdgesByWeight(G, &kParallel, pool);
+    assert(k == numberOfEdges(G) && kParallel == k);
+    for (u32 i = 0; i < k; i++) {
+      Edge e = getIthEdge((u32)sorted[i].key, G);
+      assert(e.x == sorted[i].x && e.y == sorted[i].y);
+      assert(e.x < e.y && *e.w == sorted[i].key >> 32);
+      assert(i == 0 || sorted[i - 1].key < sorted[i].key);
+      assert(parallel[i].key == sorted[i].key);
+    }
+    free(sorted);
+    free(parallel);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("Edge sort test passed.\n");
+}
+
+void testKruskal() {
+  srand(40);
+  ThreadPool *pool = createThreadPool(2);
+  // From a forest of many small trees to a dense graph.
+  u32 sizes[4][2] = {{500, 200}, {500, 600}, {500, 5000}, {300, 30000}};
+  for (u32 r = 0; r < 4; r++) {
+    Graph *G = randomMultigraph(sizes[r][0], sizes[r][1], 100, W_FLAG, false);
+    u32 n = numberOfVertices(G);
+    u32 *parents = genArray(n);
+    u64 expected = primWithParents(G, 0, parents, NULL);
+
+    u32 *chosen = genArray(n);
+    u64 total;
+    u32 k = kruskalEdges(G, chosen, &total, NULL);
+    assert(total == expected);
+    Graph *F = kruskal(G, pool);
+    assert(numberOfEdges(F) == k);
+    assert(forestWeight(F) == expected);
+    checkForest(G, F);
+
+    dumpGraph(F);
+    free(chosen);
+    free(parents);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("Kruskal test passed.\n");
+}
+
+void testConcurrentUnionFind() {
+  UnionFind *U = createUnionFind(8);
+  assert(concurrentUnionSets(U, 5, 3) && concurrentUnionSets(U, 3, 7));
+  assert(!concurrentUnionSets(U, 7, 5));
+  // The root is the least index of the set.
+  assert(concurrentFindSet(U, 7) == 3 && concurrentFindSet(U, 5) == 3);
+  assert(U->sets == 6);
+  dumpUnionFind(U);
+  printf("Concurrent union-find test passed.\n");
+}
+
+typedef u32 (*ForestAlgorithm)(Graph *, u32 *, u64 *, ThreadPool *);
+
+/**
+ * @brief Checks `algorithm` against prim, sequentially and on a pool, on
+ * graphs from forests to dense ones, with few or many distinct weights and
+ * some large enough to be processed in parallel.
+ */
+static void checkForestAlgorithm(ForestAlgorithm algorithm,
+                                 Graph *(*build)(Graph *, ThreadPool *)) {
+  ThreadPool *pool = createThreadPool(3);
+  u32 sizes[5][3] = {{500, 200, 100},
+                     {500, 600, 3},
+                     {500, 5000, 100},
+                     {300, 30000, 1000000},
+                     {20000, 3 * KRUSKAL_PARALLEL_SORT, 1000}};
+  for (u32 r = 0; r < 5; r++) {
+    Graph *G = randomMultigraph(sizes[r][0], sizes[r][1], sizes[r][2],
+                                W_FLAG, false);
+    u32 n = numberOfVertices(G);
+    u32 *parents = genArray(n);
+    u64 expected = primWithParents(G, 0, parents, NULL);
+
+    u32 *chosen = genArray(n);
+    u64 total;
+    u32 k = algorithm(G, chosen, &total, NULL);
+    assert(total == expected);
+    assert(algorithm(G, chosen, &total, pool) == k);
+    assert(total == expected);
+
+    Graph *F = build(G, pool);
+    assert(numberOfEdges(F) == k && forestWeight(F) == expected);
+    checkForest(G, F);
+
+    dumpGraph(F);
+    free(chosen);
+    free(parents);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+}
+
+void testBoruvka() {
+  srand(41);
+  checkForestAlgorithm(boruvkaEdges, boruvka);
+  printf("Borůvka test passed.\n");
+}
+
+void testFilterKruskal() {
+  srand(42);
+  checkForestAlgorithm(filterKruskalEdges, filterKruskal);
+  printf("Filter-Kruskal test passed.\n");
+}
+
+int main() {
+  testUnionFind();
+  testConcurrentUnionFind();
+  testSortEdgesByWeight();
+  testKruskal();
+  testBoruvka();
+  testFilterKruskal();
+}
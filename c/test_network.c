@@ -119,6 +119,45 @@ void testAddEdge() {
   printf("testAddEdge passed.\n");
 }
 
+/**
+ * @brief Tests readGraph on a generated network with arcs x ~~> x + 1 and
+ * x ~~> x + 2, so weights and capacities are checked even where
+ * graphs/simpleNetwork.txt is not available.
+ */
+void testReadGeneratedGraph() {
+  u32 n = 40, m = 2 * n - 3;
+  FILE *f = fopen("generatedNetwork.txt", "w");
+  assert(f != NULL);
+  fprintf(f, "p edge %u %u NETFLOW_FLAG\n", n, m);
+  for (u32 d = 1; d <= 2; d++)
+    for (u32 x = 0; x + d < n; x++)
+      fprintf(f, "e %u %u %u %u\n", x, x + d, x + d, 3 * x + d);
+  fclose(f);
+
+  Graph *G = readGraph("generatedNetwork.txt");
+  remove("generatedNetwork.txt");
+  assert(G != NULL);
+  assert(G->_g_flag == NETFLOW_FLAG);
+  assert(G->n == n);
+  assert(G->m == m);
+  for (u32 d = 1; d <= 2; d++) {
+    for (u32 x = 0; x + d < n; x++) {
+      assert(getEdgeWeight(x, x + d, G) == x + d);
+      assert(getEdgeCapacity(x, x + d, G) == 3 * x + d);
+    }
+  }
+  u32 i = 0;
+  for (u32 x = 0; x < n; x++) {
+    for (u32 d = 1; d <= 2 && x + d < n; d++) {
+      Edge e = getIthEdge(i++, G);
+      assert(e.x == x && e.y == x + d);
+    }
+  }
+  assert(i == m);
+  dumpGraph(G);
+  printf("testReadGeneratedGraph passed.\n");
+}
+
 void testReadGraph() {
 
   Graph *G = readGraph("graphs/simpleNetwork.txt");
@@ -147,6 +186,7 @@ void testReadGraph() {
 int main() {
   testInitGraph();
   testAddEdge();
+  testReadGeneratedGraph();
   testReadGraph();
   printf("All tests passed.\n");
   return 0;
@@ -28,7 +28,10 @@
 
 
 
+#include "dense.h"
+#include "generator.h"
 #include "prim.h"
+#include "search.h"
 #include "utils.h"
 #include <assert.h>
 #include <limits.h>
@@ -56,7 +59,74 @@ void test_prim() {
   dumpGraph(P);
 }
 
+void test_primForest() {
+  // Two triangles, 0-1-2 and 3-4-5, and the isolated vertex 6.
+  u32 weights[6] = {5, 1, 2, 7, 3, 4};
+  u32 ends[6][2] = {{0, 1}, {1, 2}, {0, 2}, {3, 4}, {4, 5}, {3, 5}};
+  Graph *G = initGraph(7, 6, W_FLAG);
+  for (u32 i = 0; i < 6; i++) {
+    setEdge(G, i, ends[i][0], ends[i][1], &weights[i], NULL);
+  }
+  formatEdges(G);
+
+  u32 parents[7];
+  assert(primWithParents(G, 4, parents, NULL) == 10);
+  assert(parents[4] == 4 && parents[5] == 4 && parents[3] == 5);
+  assert(parents[0] == 0 && parents[2] == 0 && parents[1] == 2);
+  assert(parents[6] == 6);
+
+  Graph *F = prim(G, 4);
+  assert(numberOfVertices(F) == 7 && numberOfEdges(F) == 4);
+  assert(degree(6, F) == 0);
+  u32 total = 0;
+  for (u32 i = 0; i < 2 * numberOfEdges(F); i++) {
+    total += *getIthEdge(i, F).w;
+  }
+  assert(total == 20);
+  dumpGraph(F);
+  dumpGraph(G);
+}
+
+void test_primDense() {
+  // Many more edge entries than vertices: the heap holds vertices, not
+  // edges, so it cannot overflow.
+  srand(38);
+  Graph *G = genCompleteGraph(200);
+  u32 n = numberOfVertices(G);
+  u32 *weights = genArray(numberOfEdges(G));
+  for (u32 i = 0; i < numberOfEdges(G); i++) {
+    weights[i] = 1 + rand() % 1000;
+  }
+  Graph *W = initGraph(n, numberOfEdges(G), W_FLAG);
+  u32 k = 0;
+  for (u32 i = 0; i < 2 * numberOfEdges(G); i++) {
+    Edge e = getIthEdge(i, G);
+    if (e.x < e.y) {
+      setEdge(W, k, e.x, e.y, &weights[k], NULL);
+      k++;
+    }
+  }
+  formatEdges(W);
+
+  DenseGraph *D = denseFromGraph(W);
+  u64 expected;
+  free(densePrim(D, 0, &expected));
+  u32 *parents = genArray(n);
+  assert(primWithParents(W, 0, parents, NULL) == expected);
+
+  Graph *T = prim(W, 0);
+  assert(numberOfEdges(T) == n - 1 && isConnected(T));
+  dumpGraph(T);
+  free(parents);
+  dumpDenseGraph(D);
+  free(weights);
+  dumpGraph(W);
+  dumpGraph(G);
+}
+
 void run_all_tests() {
+  test_primForest();
+  test_primDense();
   test_prim();
   printf("All tests passed!\n");
 }
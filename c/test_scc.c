@@ -0,0 +1,205 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+#include "api.h"
+#include "scc.h"
+#include "testgraphs.h"
+#include "threadpool.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief A cycle through every vertex when `closed`, a path otherwise.
+ */
+static Graph *genRing(u32 n, bool closed) {
+  Graph *G = initGraph(n, closed ? n : n - 1, D_FLAG);
+  for (u32 v = 0; v + 1 < n; v++)
+    setEdge(G, v, v, v + 1, NULL, NULL);
+  if (closed)
+    setEdge(G, n - 1, n - 1, 0, NULL, NULL);
+  formatEdges(G);
+  return G;
+}
+
+/**
+ * @brief Renumbers `labels` in place by the smallest vertex of each
+ * component.
+ */
+static void canonical(u32 *labels, u32 n, u32 count) {
+  u32 *map = genArray(count);
+  memset(map, 0xFF, count * sizeof(u32));
+  u32 next = 0;
+  for (u32 v = 0; v < n; v++) {
+    if (map[labels[v]] == 0xFFFFFFFF)
+      map[labels[v]] = next++;
+    labels[v] = map[labels[v]];
+  }
+  assert(next == count);
+  free(map);
+}
+
+/**
+ * @brief Checks `labels` against mutual reachability, with a search from
+ * every vertex.
+ */
+static void checkBruteForce(Graph *G, u32 *labels) {
+  u32 n = numberOfVertices(G);
+  bool *reach = (bool *)calloc((size_t)n * n, sizeof(bool));
+  u32 *queue = genArray(n);
+  for (u32 s = 0; s < n; s++) {
+    bool *seen = reach + (size_t)s * n;
+    u32 head = 0, tail = 0;
+    seen[s] = true;
+    queue[tail++] = s;
+    while (head < tail) {
+      u32 v = queue[head++];
+      for (u32 j = 0; j < degree(v, G); j++) {
+        u32 w = neighbour(j, v, G);
+        if (!seen[w]) {
+          seen[w] = true;
+          queue[tail++] = w;
+        }
+      }
+    }
+  }
+  for (u32 u = 0; u < n; u++)
+    for (u32 v = 0; v < n; v++)
+      assert((labels[u] == labels[v]) ==
+             (reach[(size_t)u * n + v] && reach[(size_t)v * n + u]));
+  free(queue);
+  free(reach);
+}
+
+/**
+ * @brief Checks that the condensation of `G` has one arc per pair of
+ * components joined by an edge, in sorted rows, and no cycle.
+ */
+static void checkCondensation(Graph *G, u32 *labels, u32 count) {
+  Graph *D = condensation(G, labels, count);
+  assert(numberOfVertices(D) == count);
+  for (u32 a = 0; a < count; a++)
+    for (u32 j = 1; j < degree(a, D); j++)
+      assert(neighbour(j - 1, a, D) < neighbour(j, a, D));
+  for (u32 i = 0; i < G->_edgeArraySize; i++) {
+    u32 a = labels[(G->_edges)[i].x], b = labels[(G->_edges)[i].y];
+    assert(a == b || isNeighbour(a, b, D));
+  }
+  // Count the distinct pairs, grouping the edges by tail component.
+  u32 *stamp = genArray(count + 1);
+  u32 *byTail = genArray(count + 1);
+  for (u32 i = 0; i < G->_edgeArraySize; i++)
+    byTail[labels[(G->_edges)[i].x] + 1]++;
+  for (u32 a = 0; a < count; a++)
+    byTail[a + 1] += byTail[a];
+  u32 *order = genArray(G->_edgeArraySize + 1);
+  for (u32 i = 0; i < G->_edgeArraySize; i++)
+    order[byTail[labels[(G->_edges)[i].x]]++] = i;
+  u32 pairs = 0;
+  for (u32 k = 0; k < G->_edgeArraySize; k++) {
+    u32 a = labels[(G->_edges)[order[k]].x];
+    u32 b = labels[(G->_edges)[order[k]].y];
+    if (a != b && stamp[b] != a + 1) {
+      stamp[b] = a + 1;
+      pairs++;
+    }
+  }
+  assert(pairs == numberOfEdges(D));
+  free(stamp);
+  free(byTail);
+  free(order);
+  assert(stronglyConnectedComponents(D, NULL) == count);
+  dumpGraph(D);
+}
+
+void testStronglyConnectedComponents() {
+  srand(50);
+  Graph *graphs[7] = {randomMultigraph(200, 150, 0, D_FLAG, true),
+                      randomMultigraph(200, 260, 0, D_FLAG, true),
+                      randomMultigraph(300, 600, 0, D_FLAG, true),
+                      randomMultigraph(20000, 40000, 0, D_FLAG, true),
+                      genRing(1000000, true), genRing(1000000, false),
+                      initGraph(50, 0, D_FLAG)};
+  formatEdges(graphs[6]);
+  ThreadPool *pool = createThreadPool(4);
+  for (u32 g = 0; g < 7; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    u32 *labels = genArray(n);
+    u32 *parallel = genArray(n);
+    u32 count = stronglyConnectedComponents(G, labels);
+    assert(stronglyConnectedComponents(G, NULL) == count);
+    for (u32 i = 0; i < G->_edgeArraySize; i++)
+      assert(labels[(G->_edges)[i].x] >= labels[(G->_edges)[i].y]);
+    if (n <= 300)
+      checkBruteForce(G, labels);
+    checkCondensation(G, labels, count);
+
+    canonical(labels, n, count);
+    assert(parallelStronglyConnectedComponents(G, parallel, pool) == count);
+    assert(memcmp(labels, parallel, n * sizeof(u32)) == 0);
+    assert(parallelStronglyConnectedComponents(G, parallel, NULL) == count);
+    assert(memcmp(labels, parallel, n * sizeof(u32)) == 0);
+    checkCondensation(G, parallel, count);
+    if (g == 4)
+      assert(count == 1);
+    if (g == 5 || g == 6)
+      assert(count == n);
+    free(labels);
+    free(parallel);
+    dumpGraph(G);
+  }
+  dumpThreadPool(pool);
+  printf("stronglyConnectedComponents test passed.\n");
+}
+
+void testSelfLoops() {
+  // 0 -> 1 -> 2 -> 0 with doubled arcs, 3 and 4 with self-loops, 3 -> 4.
+  Graph *G = initGraph(5, 7, D_FLAG);
+  u32 edges[7][2] = {{0, 1}, {1, 2}, {2, 0}, {2, 0},
+                     {3, 3}, {3, 4}, {4, 4}};
+  for (u32 i = 0; i < 7; i++)
+    setEdge(G, i, edges[i][0], edges[i][1], NULL, NULL);
+  formatEdges(G);
+  u32 labels[5];
+  assert(stronglyConnectedComponents(G, labels) == 3);
+  assert(labels[0] == labels[1] && labels[1] == labels[2]);
+  assert(labels[3] > labels[4]);
+  checkBruteForce(G, labels);
+  assert(parallelStronglyConnectedComponents(G, labels, NULL) == 3);
+  assert(labels[0] == 0 && labels[2] == 0 && labels[3] == 1 &&
+         labels[4] == 2);
+  Graph *D = condensation(G, labels, 3);
+  assert(numberOfEdges(D) == 1 && isNeighbour(1, 2, D));
+  dumpGraph(D);
+  dumpGraph(G);
+  printf("self-loop test passed.\n");
+}
+
+int main() {
+  testStronglyConnectedComponents();
+  testSelfLoops();
+}
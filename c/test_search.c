@@ -29,12 +29,17 @@
 
 
 #include "api.h"
+#include "diapi.h"
+#include "dijkstra.h"
 #include "queue.h"
 #include "search.h"
+#include "testgraphs.h"
 #include "utils.h"
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 void testConstructTreeFromInsertionArray() {
   printf("Testing constructTreeFromInsertionArray.\n");
@@ -138,11 +143,205 @@ void testIsConnected() {
 
   assert(isConnected(disconnectedG) == false); // Graph is not connected
 
+  // Digraphs are connected if weakly connected: 1 -> 0 is, 0 -> 1, 2 not.
+  Graph *D = initGraph(2, 1, D_FLAG);
+  setEdge(D, 0, 1, 0, NULL, NULL);
+  formatEdges(D);
+  Graph *E = initGraph(3, 1, D_FLAG);
+  setEdge(E, 0, 0, 1, NULL, NULL);
+  formatEdges(E);
+  SearchWorkspace *W = createSearchWorkspace(4);
+  assert(isConnected(D) && workspaceIsConnected(D, NULL, W));
+  assert(!isConnected(E) && !workspaceIsConnected(E, NULL, W));
+  assert(workspaceIsConnected(G, NULL, W));
+  assert(!workspaceIsConnected(disconnectedG, NULL, W));
+
+  dumpSearchWorkspace(W);
+  dumpGraph(D);
+  dumpGraph(E);
   dumpGraph(G);
   dumpGraph(disconnectedG);
   printf("testIsConnected passed.\n");
 }
 
+// Test that one workspace serves many searches, including across the
+// wraparound of its epoch counter.
+void testSearchWorkspace() {
+  printf("Testing search workspaces.\n");
+  // Two paths, 0 - 1 - 2 - 3 and 4 - 5.
+  Graph *G = initGraph(6, 4, STD_FLAG);
+  setEdge(G, 0, 0, 1, NULL, NULL);
+  setEdge(G, 1, 1, 2, NULL, NULL);
+  setEdge(G, 2, 2, 3, NULL, NULL);
+  setEdge(G, 3, 4, 5, NULL, NULL);
+  formatEdges(G);
+
+  SearchWorkspace *W = createSearchWorkspace(6);
+  for (u32 round = 0; round < 3; round++) {
+    for (u32 s = 0; s < 6; s++) {
+      for (u32 t = 0; t < 6; t++) {
+        if (s == t)
+          continue;
+        bool sameSide = (s < 4) == (t < 4);
+        assert(workspaceBFSSearch(G, s, t, W) == sameSide);
+        assert(BFSSearch(G, s, t) == sameSide);
+      }
+    }
+    assert(workspaceIsConnected(G, NULL, W) == false);
+    // The next searches wrap the epoch around.
+    W->epoch = 0xFFFFFFFF - 1;
+  }
+
+  // Hop distances and parents of the last search.
+  assert(workspaceBFSSearch(G, 0, 3, W));
+  assert(workspaceDistance(W, 3) == 3);
+  assert(W->parents[3] == 2 && W->parents[2] == 1 && W->parents[1] == 0);
+  assert(!workspaceReached(W, 4));
+
+  dumpSearchWorkspace(W);
+  dumpGraph(G);
+  printf("testSearchWorkspace passed.\n");
+}
+
+// Test the parent arrays of BFSWithParents and the trees built from them.
+void testBFSWithParents() {
+  printf("Testing BFSWithParents and treeFromParents.\n");
+  // A 6-cycle 0 - 1 - 2 - 3 - 4 - 5 - 0 and an isolated vertex 6.
+  Graph *G = initGraph(7, 6, STD_FLAG);
+  for (u32 i = 0; i < 6; i++)
+    setEdge(G, i, i, (i + 1) % 6, NULL, NULL);
+  formatEdges(G);
+
+  u32 parents[7], parentEdges[7];
+  u32 *distances = BFSWithParents(G, 1, parents, parentEdges);
+  u32 expected[7] = {1, 0, 1, 2, 3, 2, INT_MAX};
+  for (u32 v = 0; v < 7; v++)
+    assert(distances[v] == expected[v]);
+  assert(parents[1] == 1 && parentEdges[1] == NO_PARENT);
+  assert(parents[6] == NO_PARENT && parentEdges[6] == NO_PARENT);
+  for (u32 v = 0; v < 6; v++) {
+    if (v == 1)
+      continue;
+    Edge e = G->_edges[parentEdges[v]];
+    assert(e.x == parents[v] && e.y == v);
+    assert(distances[parents[v]] + 1 == distances[v]);
+  }
+
+  Path *P = extractPath(parents, distances, 1, 4);
+  assert(P->length == 4 && P->distance == 3);
+  assert(P->vertices[0] == 1 && P->vertices[3] == 4);
+  dumpPath(P);
+  P = extractPath(parents, distances, 1, 6);
+  assert(P->length == 0 && P->distance == INT_MAX);
+  dumpPath(P);
+
+  // The tree has the 5 parent edges, sorted, and 6 stays isolated.
+  Graph *T = treeFromParents(parents, 7);
+  assert(numberOfVertices(T) == 7 && numberOfEdges(T) == 5);
+  for (u32 v = 0; v < 6; v++) {
+    if (v != 1)
+      assert(isNeighbour(v, parents[v], T) && isNeighbour(parents[v], v, T));
+  }
+  assert(degree(6, T) == 0);
+  for (u32 i = 1; i < 2 * numberOfEdges(T); i++)
+    assert(compareEdges(&T->_edges[i - 1], &T->_edges[i]) < 0);
+  assert(T->Δ == 2);
+
+  dumpGraph(T);
+  free(distances);
+  dumpGraph(G);
+  printf("testBFSWithParents passed.\n");
+}
+
+// Test depthFirstOrder: times, orders, restarts, and depth beyond what
+// recursion could handle.
+void testDepthFirstOrder() {
+  printf("Testing depthFirstOrder.\n");
+  // 0 - 1 - 2, 0 - 3, and the separate edge 4 - 5.
+  Graph *G = initGraph(6, 4, STD_FLAG);
+  setEdge(G, 0, 0, 1, NULL, NULL);
+  setEdge(G, 1, 1, 2, NULL, NULL);
+  setEdge(G, 2, 0, 3, NULL, NULL);
+  setEdge(G, 3, 4, 5, NULL, NULL);
+  formatEdges(G);
+
+  DFSOrder *O = depthFirstOrder(G, 0, false);
+  u32 preorder[4] = {0, 1, 2, 3}, postorder[4] = {2, 1, 3, 0};
+  u32 discovery[4] = {0, 1, 2, 5}, finish[4] = {7, 4, 3, 6};
+  assert(O->count == 4 && O->finished == 4);
+  for (u32 i = 0; i < 4; i++) {
+    assert(O->preorder[i] == preorder[i] && O->postorder[i] == postorder[i]);
+    assert(O->discovery[i] == discovery[i] && O->finish[i] == finish[i]);
+  }
+  assert(O->parents[0] == 0 && O->parents[2] == 1 && O->parents[3] == 0);
+  assert(O->discovery[4] == NO_PARENT && O->parents[5] == NO_PARENT);
+  dumpDFSOrder(O);
+
+  O = depthFirstOrder(G, 3, true);
+  assert(O->count == 6 && O->preorder[0] == 3 && O->preorder[4] == 4);
+  assert(O->parents[4] == 4 && O->parents[5] == 4 && O->finish[4] == 11);
+  dumpDFSOrder(O);
+  dumpGraph(G);
+
+  // A path of a million vertices.
+  u32 n = 1000000;
+  G = initGraph(n, n - 1, STD_FLAG);
+  for (u32 v = 0; v + 1 < n; v++)
+    setEdge(G, v, v, v + 1, NULL, NULL);
+  formatEdges(G);
+  O = depthFirstOrder(G, 0, false);
+  assert(O->count == n);
+  for (u32 v = 0; v < n; v++) {
+    assert(O->discovery[v] == v && O->finish[v] == 2 * n - 1 - v);
+    assert(O->parents[v] == (v == 0 ? 0 : v - 1));
+  }
+  dumpDFSOrder(O);
+  Graph *T = DFS(G, n - 1);
+  assert(numberOfEdges(T) == n - 1);
+  dumpGraph(T);
+  dumpGraph(G);
+  printf("testDepthFirstOrder passed.\n");
+}
+
+void testBidirectionalSearch() {
+  srand(49);
+  Graph *graphs[4] = {randomMultigraph(2000, 1500, 0, STD_FLAG, true),
+                      randomMultigraph(2000, 2500, 0, D_FLAG, true),
+                      randomMultigraph(100000, 400000, 0, STD_FLAG, true),
+                      randomMultigraph(100000, 400000, 0, D_FLAG, true)};
+  for (u32 g = 0; g < 4; g++) {
+    Graph *G = graphs[g];
+    u32 n = numberOfVertices(G);
+    ReverseIndex *R = G->_g_flag & D_FLAG ? buildReverseIndex(G) : NULL;
+    SearchWorkspace *W = createSearchWorkspace(n);
+    SearchWorkspace *V = createSearchWorkspace(n);
+    u64 exploredBoth = 0, exploredOne = 0;
+    for (u32 q = 0; q < 40; q++) {
+      u32 s = rand() % n, t = rand() % n;
+      u32 explored;
+      bool found = bidirectionalSearch(G, s, t, R, W, &explored);
+      bool expected = s == t || workspaceBFSSearch(G, s, t, V);
+      assert(found == expected);
+      assert(found == BFSSearch(G, s, t));
+      assert(explored <= n);
+      if (found && s != t) {
+        exploredBoth += explored;
+        for (u32 v = 0; v < n; v++)
+          exploredOne += workspaceReached(V, v);
+      }
+    }
+    assert(bidirectionalSearch(G, 0, 0, NULL, W, NULL));
+    // Random graphs above the giant-component threshold expand quickly.
+    if (n == 100000)
+      assert(exploredBoth * 20 < exploredOne);
+    dumpSearchWorkspace(W);
+    dumpSearchWorkspace(V);
+    dumpReverseIndex(R);
+    dumpGraph(G);
+  }
+  printf("testBidirectionalSearch passed.\n");
+}
+
 // Main function to run all test cases
 int main() {
   testConstructTreeFromInsertionArray();
@@ -150,6 +349,10 @@ int main() {
   testDFS();
   testBFSSearch();
   testIsConnected();
+  testSearchWorkspace();
+  testBFSWithParents();
+  testDepthFirstOrder();
+  testBidirectionalSearch();
 
   printf("All tests passed successfully.\n");
   return 0;
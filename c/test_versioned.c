@@ -0,0 +1,225 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+#include "api.h"
+#include "dijkstra.h"
+#include "versioned.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N_READERS 3
+#define N_WRITES 2000
+
+static Graph *pathGraph(u32 n) {
+  Graph *G = initGraph(n, n - 1, W_FLAG);
+  for (u32 i = 0; i + 1 < n; i++) {
+    u32 w = 1;
+    setEdge(G, i, i, i + 1, &w, NULL);
+  }
+  formatEdges(G);
+  return G;
+}
+
+// Pinned versions must not change while the writer publishes new ones.
+void testSnapshotIsolation() {
+  Graph *G = pathGraph(200);
+  VersionedGraph *V = createVersionedGraph(G, 2);
+  dumpGraph(G);
+
+  GraphVersion *old = pinVersion(V, 0);
+  assert(old->epoch == 1 && old->m == 199);
+
+  u32 w = 5;
+  versionedAddEdge(V, 0, 199, &w);
+  versionedRemoveEdge(V, 100, 101);
+  assert(publishVersion(V) == 2);
+
+  GraphVersion *new = pinVersion(V, 1);
+  assert(new->epoch == 2 && new->m == 199);
+  assert(versionIsNeighbour(0, 199, new) && versionIsNeighbour(199, 0, new));
+  assert(!versionIsNeighbour(100, 101, new));
+  assert(versionNeighbourWeight(1, 0, new) == 5);
+
+  // The old version is untouched, and blocks not written are shared.
+  assert(!versionIsNeighbour(0, 199, old));
+  assert(versionIsNeighbour(100, 101, old));
+  assert(old->blocks[2] == new->blocks[2]);
+  assert(old->blocks[0] != new->blocks[0]);
+
+  // Algorithms run on a materialised snapshot.
+  Graph *S = versionToGraph(new);
+  u32 *distances = dijkstra(0, S);
+  assert(distances[199] == 5 && distances[101] == 103 && distances[100] == 100);
+  free(distances);
+  dumpGraph(S);
+
+  unpinVersion(V, 0);
+  unpinVersion(V, 1);
+  dumpVersionedGraph(V);
+  printf("testSnapshotIsolation passed.\n");
+}
+
+// Blocks of old versions are freed only after their readers unpin them.
+void testReclamation() {
+  Graph *G = pathGraph(10);
+  VersionedGraph *V = createVersionedGraph(G, 1);
+  dumpGraph(G);
+
+  GraphVersion *pinned = pinVersion(V, 0);
+  u32 w = 3;
+  versionedAddEdge(V, 0, 9, &w);
+  publishVersion(V);
+  assert(V->nRetired == 2); // the old version and its only block
+  assert(versionDegree(0, pinned) == 1);
+
+  unpinVersion(V, 0);
+  versionedRemoveEdge(V, 0, 9);
+  publishVersion(V);
+  assert(V->nRetired == 0); // nobody can reach any old version
+
+  versionedAddEdge(V, 2, 7, &w); // left unpublished
+  dumpVersionedGraph(V);
+  printf("testReclamation passed.\n");
+}
+
+// Readers of one version share its materialised graph, which is freed with
+// the version.
+void testSharedGraph() {
+  Graph *G = pathGraph(100);
+  VersionedGraph *V = createVersionedGraph(G, 2);
+  dumpGraph(G);
+
+  GraphVersion *first = pinVersion(V, 0);
+  GraphVersion *same = pinVersion(V, 1);
+  assert(first == same);
+  Graph *S = versionGraph(first);
+  assert(versionGraph(same) == S);
+  unpinVersion(V, 1);
+
+  u32 w = 2;
+  versionedAddEdge(V, 0, 99, &w);
+  publishVersion(V);
+  GraphVersion *next = pinVersion(V, 1);
+  Graph *T = versionGraph(next);
+  assert(T != S && numberOfEdges(T) == 100);
+  u32 *distances = dijkstra(0, T);
+  assert(distances[99] == 2);
+  free(distances);
+
+  // The pinned version still sees its own graph.
+  assert(numberOfEdges(S) == 99);
+  distances = dijkstra(0, S);
+  assert(distances[99] == 99);
+  free(distances);
+
+  unpinVersion(V, 0);
+  unpinVersion(V, 1);
+  versionedRemoveEdge(V, 0, 99);
+  publishVersion(V);
+  assert(V->nRetired == 0);
+  dumpVersionedGraph(V);
+  printf("testSharedGraph passed.\n");
+}
+
+typedef struct {
+  VersionedGraph *V;
+  u32 reader;
+  bool *done;
+  u32 checks;
+} ReaderArgs;
+
+static void *readerLoop(void *arg) {
+  ReaderArgs *a = (ReaderArgs *)arg;
+  while (!__atomic_load_n(a->done, __ATOMIC_SEQ_CST)) {
+    GraphVersion *S = pinVersion(a->V, a->reader);
+    // Every version is a consistent graph: degrees add up to 2m and
+    // adjacency is symmetric.
+    u32 sum = 0;
+    for (u32 v = 0; v < S->n; v++) {
+      u32 d = versionDegree(v, S);
+      sum += d;
+      for (u32 j = 0; j < d; j++) {
+        u32 y = versionNeighbour(j, v, S);
+        assert(versionIsNeighbour(y, v, S));
+      }
+    }
+    assert(sum == 2 * S->m);
+    // Readers of the same version race to build its graph.
+    Graph *G = versionGraph(S);
+    assert(versionGraph(S) == G && numberOfEdges(G) == S->m);
+    unpinVersion(a->V, a->reader);
+    a->checks++;
+  }
+  return NULL;
+}
+
+void testConcurrentReaders() {
+  u32 n = 300;
+  Graph *G = pathGraph(n);
+  VersionedGraph *V = createVersionedGraph(G, N_READERS);
+  dumpGraph(G);
+
+  bool done = false;
+  pthread_t threads[N_READERS];
+  ReaderArgs args[N_READERS];
+  for (u32 r = 0; r < N_READERS; r++) {
+    args[r] = (ReaderArgs){V, r, &done, 0};
+    pthread_create(&threads[r], NULL, readerLoop, &args[r]);
+  }
+
+  srand(7);
+  u32 w = 1;
+  for (u32 i = 0; i < N_WRITES; i++) {
+    u32 x = rand() % n;
+    u32 y = rand() % n;
+    if (x == y)
+      continue;
+    pthread_mutex_lock(&V->writeLock);
+    bool present = versionIsNeighbour(x, y, V->current);
+    pthread_mutex_unlock(&V->writeLock);
+    if (present)
+      versionedRemoveEdge(V, x, y);
+    else
+      versionedAddEdge(V, x, y, &w);
+    publishVersion(V);
+  }
+  __atomic_store_n(&done, true, __ATOMIC_SEQ_CST);
+  for (u32 r = 0; r < N_READERS; r++) {
+    pthread_join(threads[r], NULL);
+  }
+  dumpVersionedGraph(V);
+  printf("testConcurrentReaders passed.\n");
+}
+
+int main() {
+  testSnapshotIsolation();
+  testReclamation();
+  testSharedGraph();
+  testConcurrentReaders();
+  printf("All tests passed.\n");
+  return 0;
+}
@@ -0,0 +1,100 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file testgraphs.c
+ * @brief Random graphs shared by the tests and benchmarks.
+ */
+
+#include "testgraphs.h"
+#include "api.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Generates a random graph (or digraph, with D_FLAG in `flag`) of n
+ * vertices with up to m edges, without loops or parallel edges: m vertex
+ * pairs are drawn uniformly and repeats are dropped.
+ *
+ * @param maxWeight With W_FLAG, weights are drawn uniformly from
+ * [1, maxWeight].
+ */
+Graph *randomWeightedGraph(u32 n, u32 m, u32 maxWeight, g_flag flag) {
+  assert(n > 0);
+  bool *used = (bool *)calloc((size_t)n * n, sizeof(bool));
+  Edge *edges = (Edge *)malloc(max(m, 1) * sizeof(Edge));
+  u32 *weights = genArray(max(m, 1));
+  if (used == NULL || edges == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  u32 count = 0;
+  for (u32 k = 0; k < m; k++) {
+    u32 x = generate_random_u32_in_range(0, n - 1);
+    u32 y = generate_random_u32_in_range(0, n - 1);
+    if (x == y || used[(size_t)x * n + y] || used[(size_t)y * n + x])
+      continue;
+    used[(size_t)x * n + y] = true;
+    weights[count] = generate_random_u32_in_range(1, maxWeight);
+    edges[count++] = (Edge){x, y, NULL, NULL};
+  }
+  Graph *G = initGraph(n, count, flag);
+  for (u32 i = 0; i < count; i++) {
+    setEdge(G, i, edges[i].x, edges[i].y, flag & W_FLAG ? &weights[i] : NULL,
+            NULL);
+  }
+  formatEdges(G);
+  free(used);
+  free(edges);
+  free(weights);
+  return G;
+}
+
+/**
+ * @brief Generates a random graph (or digraph, with D_FLAG in `flag`) of n
+ * vertices and exactly m edges with uniform endpoints, so parallel edges
+ * may occur.
+ *
+ * @param maxWeight With W_FLAG, weights are drawn uniformly from
+ * [1, maxWeight].
+ * @param loops Whether loops are kept; otherwise their head is redrawn.
+ */
+Graph *randomMultigraph(u32 n, u32 m, u32 maxWeight, g_flag flag,
+                        bool loops) {
+  assert(n > 0 && (loops || n > 1 || m == 0));
+  Graph *G = initGraph(n, m, flag);
+  for (u32 i = 0; i < m; i++) {
+    u32 x = generate_random_u32_in_range(0, n - 1);
+    u32 y = generate_random_u32_in_range(0, n - 1);
+    while (!loops && x == y)
+      y = generate_random_u32_in_range(0, n - 1);
+    u32 w = flag & W_FLAG ? generate_random_u32_in_range(1, maxWeight) : 0;
+    setEdge(G, i, x, y, flag & W_FLAG ? &w : NULL, NULL);
+  }
+  formatEdges(G);
+  return G;
+}
@@ -0,0 +1,182 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file threadpool.c
+ * @brief Fork-join thread pool. Workers sleep on a condition variable between
+ * tasks, so a pool can be created once and reused by many parallel calls.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "threadpool.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+  ThreadPool *pool;
+  u32 thread;
+} WorkerArgs;
+
+/**
+ * @brief Return the number of online processors.
+ */
+u32 numberOfCores() {
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  return cores > 0 ? (u32)cores : 1;
+}
+
+static void *workerLoop(void *arg) {
+  WorkerArgs *args = (WorkerArgs *)arg;
+  ThreadPool *pool = args->pool;
+  u32 thread = args->thread;
+  free(args);
+
+  u64 seen = 0;
+  pthread_mutex_lock(&pool->lock);
+  while (true) {
+    while (pool->generation == seen && !pool->stop)
+      pthread_cond_wait(&pool->start, &pool->lock);
+    if (pool->stop)
+      break;
+    seen = pool->generation;
+    PoolTask task = pool->task;
+    void *ctx = pool->ctx;
+    pthread_mutex_unlock(&pool->lock);
+
+    task(thread, pool->nThreads, ctx);
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0)
+      pthread_cond_signal(&pool->done);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/**
+ * @brief Creates a pool of `nThreads` threads, counting the caller. If
+ * `nThreads` is 0, one thread per core is used.
+ */
+ThreadPool *createThreadPool(u32 nThreads) {
+  if (nThreads == 0)
+    nThreads = numberOfCores();
+  ThreadPool *pool = (ThreadPool *)calloc(1, sizeof(ThreadPool));
+  if (pool == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  pool->nThreads = nThreads;
+  pool->threads = (pthread_t *)malloc(nThreads * sizeof(pthread_t));
+  if (pool->threads == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pthread_cond_init(&pool->barrierCond, NULL);
+
+  for (u32 t = 1; t < nThreads; t++) {
+    WorkerArgs *args = (WorkerArgs *)malloc(sizeof(WorkerArgs));
+    args->pool = pool;
+    args->thread = t;
+    if (pthread_create(&pool->threads[t], NULL, workerLoop, args) != 0) {
+      printf("Error: pthread_create failed\n");
+      exit(1);
+    }
+  }
+  return pool;
+}
+
+/**
+ * @brief Runs `task(thread, nThreads, ctx)` on every thread of the pool and
+ * waits until all of them return. The calling thread acts as thread 0.
+ */
+void poolRun(ThreadPool *pool, PoolTask task, void *ctx) {
+  if (pool->nThreads == 1) {
+    task(0, 1, ctx);
+    return;
+  }
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->ctx = ctx;
+  pool->pending = pool->nThreads - 1;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  task(0, pool->nThreads, ctx);
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->pending > 0)
+    pthread_cond_wait(&pool->done, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief Blocks until every thread of the pool reaches the barrier. Only to
+ * be called from within a task.
+ */
+void poolBarrier(ThreadPool *pool) {
+  if (pool->nThreads == 1)
+    return;
+  pthread_mutex_lock(&pool->lock);
+  u64 generation = pool->barrierGeneration;
+  if (++pool->barrierCount == pool->nThreads) {
+    pool->barrierCount = 0;
+    pool->barrierGeneration++;
+    pthread_cond_broadcast(&pool->barrierCond);
+  } else {
+    while (generation == pool->barrierGeneration)
+      pthread_cond_wait(&pool->barrierCond, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+u32 poolSize(ThreadPool *pool) { return pool == NULL ? 1 : pool->nThreads; }
+
+/**
+ * @brief Stops and joins the workers, and frees the pool.
+ */
+void dumpThreadPool(ThreadPool *pool) {
+  if (pool == NULL)
+    return;
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+  for (u32 t = 1; t < pool->nThreads; t++)
+    pthread_join(pool->threads[t], NULL);
+
+  pthread_cond_destroy(&pool->barrierCond);
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->start);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->threads);
+  free(pool);
+}
@@ -0,0 +1,65 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file threadpool.h
+ * @brief A fork-join pool of worker threads, shared by the parallel
+ * algorithms of the library.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "graphStruct.h"
+#include <pthread.h>
+
+// A task is run once by every thread of the pool; `thread` is in
+// [0, nThreads) and thread 0 is the caller of poolRun.
+typedef void (*PoolTask)(u32 thread, u32 nThreads, void *ctx);
+
+typedef struct {
+  pthread_t *threads;
+  u32 nThreads;
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  pthread_cond_t barrierCond;
+  u32 barrierCount;
+  u64 barrierGeneration;
+  PoolTask task;
+  void *ctx;
+  u64 generation;
+  u32 pending;
+  bool stop;
+} ThreadPool;
+
+u32 numberOfCores();
+ThreadPool *createThreadPool(u32 nThreads);
+void poolRun(ThreadPool *pool, PoolTask task, void *ctx);
+void poolBarrier(ThreadPool *pool);
+u32 poolSize(ThreadPool *pool);
+void dumpThreadPool(ThreadPool *pool);
+
+#endif
@@ -0,0 +1,158 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file unionfind.c
+ * @brief A disjoint-set forest with union by rank and path halving, which
+ * makes any sequence of operations run in near-constant amortized time
+ * each.
+ */
+
+#include "unionfind.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Creates n singleton sets {0}, ..., {n - 1}.
+ */
+UnionFind *createUnionFind(u32 n) {
+  UnionFind *U = (UnionFind *)malloc(sizeof(UnionFind));
+  if (U == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  U->n = n;
+  U->parent = genArray(n);
+  U->rank = genArray(n);
+  resetUnionFind(U);
+  return U;
+}
+
+/**
+ * @brief Splits U back into singletons, in O(n) time.
+ */
+void resetUnionFind(UnionFind *U) {
+  for (u32 x = 0; x < U->n; x++) {
+    U->parent[x] = x;
+    U->rank[x] = 0;
+  }
+  U->sets = U->n;
+}
+
+/**
+ * @brief Returns the representative of the set of `x`. Every vertex on the
+ * way up is pointed to its grandparent, which halves the path.
+ */
+u32 findSet(UnionFind *U, u32 x) {
+  assert(x < U->n);
+  u32 *parent = U->parent;
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]];
+    x = parent[x];
+  }
+  return x;
+}
+
+/**
+ * @brief Merges the sets of `x` and `y`, hanging the shallower tree below
+ * the root of the deeper one.
+ *
+ * @return true if they were different sets.
+ */
+bool unionSets(UnionFind *U, u32 x, u32 y) {
+  x = findSet(U, x);
+  y = findSet(U, y);
+  if (x == y)
+    return false;
+  if (U->rank[x] < U->rank[y]) {
+    u32 t = x;
+    x = y;
+    y = t;
+  }
+  U->parent[y] = x;
+  if (U->rank[x] == U->rank[y])
+    U->rank[x]++;
+  U->sets--;
+  return true;
+}
+
+bool sameSet(UnionFind *U, u32 x, u32 y) {
+  return findSet(U, x) == findSet(U, y);
+}
+
+/**
+ * @brief As findSet, but safe to call from many threads at once, also
+ * alongside concurrentUnionSets. Path halving is attempted with a
+ * compare-and-swap, and skipped if another thread got there first.
+ */
+u32 concurrentFindSet(UnionFind *U, u32 x) {
+  assert(x < U->n);
+  u32 *parent = U->parent;
+  while (true) {
+    u32 p = __atomic_load_n(&parent[x], __ATOMIC_ACQUIRE);
+    if (p == x)
+      return x;
+    u32 g = __atomic_load_n(&parent[p], __ATOMIC_ACQUIRE);
+    if (p != g)
+      __atomic_compare_exchange_n(&parent[x], &p, g, true, __ATOMIC_RELEASE,
+                                  __ATOMIC_RELAXED);
+    x = g;
+  }
+}
+
+/**
+ * @brief As unionSets, but safe to call from many threads at once. Ranks
+ * are not kept: the root with the larger index is hung below the other
+ * with a compare-and-swap, retried if either stopped being a root, which
+ * can never close a cycle.
+ *
+ * @return true if this call merged two different sets.
+ */
+bool concurrentUnionSets(UnionFind *U, u32 x, u32 y) {
+  while (true) {
+    x = concurrentFindSet(U, x);
+    y = concurrentFindSet(U, y);
+    if (x == y)
+      return false;
+    u32 low = x < y ? x : y;
+    u32 high = x < y ? y : x;
+    u32 expected = high;
+    if (__atomic_compare_exchange_n(&U->parent[high], &expected, low, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      __atomic_fetch_sub(&U->sets, 1, __ATOMIC_RELAXED);
+      return true;
+    }
+  }
+}
+
+void dumpUnionFind(UnionFind *U) {
+  if (U == NULL)
+    return;
+  free(U->parent);
+  free(U->rank);
+  free(U);
+}
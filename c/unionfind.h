@@ -0,0 +1,55 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file unionfind.h
+ * @brief A disjoint-set forest with union by rank and path halving, and a
+ * lock-free variant of its operations for concurrent use.
+ */
+
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+
+#include "graphStruct.h"
+
+// parent[x] == x iff x is the representative of its set. rank[x] bounds
+// the height of the tree rooted at x.
+typedef struct {
+  u32 n;
+  u32 sets;
+  u32 *parent;
+  u32 *rank;
+} UnionFind;
+
+UnionFind *createUnionFind(u32 n);
+void resetUnionFind(UnionFind *U);
+u32 findSet(UnionFind *U, u32 x);
+bool unionSets(UnionFind *U, u32 x, u32 y);
+bool sameSet(UnionFind *U, u32 x, u32 y);
+u32 concurrentFindSet(UnionFind *U, u32 x);
+bool concurrentUnionSets(UnionFind *U, u32 x, u32 y);
+void dumpUnionFind(UnionFind *U);
+
+#endif
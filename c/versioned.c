@@ -0,0 +1,521 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file versioned.c
+ * @brief Multi-version graphs with copy-on-write vertex blocks and epoch-based
+ * reclamation.
+ *
+ * The adjacency of the graph is split into blocks of VG_BLOCK_SIZE vertices.
+ * A GraphVersion is an immutable array of pointers to blocks. The writer
+ * prepares a draft version in which only the blocks it modifies are copied,
+ * and publishes it with a single atomic pointer store. Readers never block:
+ * they announce the epoch they are reading in their reader slot, and a block
+ * replaced at epoch e is freed only once no reader is pinned to an epoch
+ * older than e.
+ */
+
+#include "versioned.h"
+#include "api.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_CAS(p, expected, v)                                             \
+  __atomic_compare_exchange_n((p), (expected), (v), false, __ATOMIC_SEQ_CST,  \
+                              __ATOMIC_SEQ_CST)
+
+/**
+ * @brief Helper function. Allocates a block with room for `capacity`
+ * adjacency entries.
+ */
+static VertexBlock *createBlock(u32 capacity, bool weighted) {
+  VertexBlock *B = (VertexBlock *)calloc(1, sizeof(VertexBlock));
+  if (B == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  B->capacity = capacity;
+  B->targets = (u32 *)malloc(max(capacity, 1) * sizeof(u32));
+  B->weights = weighted ? (u32 *)malloc(max(capacity, 1) * sizeof(u32)) : NULL;
+  if (B->targets == NULL || (weighted && B->weights == NULL)) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  return B;
+}
+
+static void dumpBlock(VertexBlock *B) {
+  free(B->targets);
+  free(B->weights);
+  free(B);
+}
+
+static VertexBlock *copyBlock(VertexBlock *B) {
+  u32 size = B->offsets[VG_BLOCK_SIZE];
+  VertexBlock *C = createBlock(B->capacity, B->weights != NULL);
+  memcpy(C->offsets, B->offsets, sizeof(B->offsets));
+  memcpy(C->targets, B->targets, size * sizeof(u32));
+  if (B->weights != NULL)
+    memcpy(C->weights, B->weights, size * sizeof(u32));
+  return C;
+}
+
+static GraphVersion *createVersion(u32 n, u32 m, g_flag flag) {
+  GraphVersion *S = (GraphVersion *)malloc(sizeof(GraphVersion));
+  if (S == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  S->n = n;
+  S->m = m;
+  S->flag = flag;
+  S->graph = NULL;
+  S->nBlocks = (n + VG_BLOCK_SIZE - 1) / VG_BLOCK_SIZE;
+  S->blocks = (VertexBlock **)calloc(max(S->nBlocks, 1), sizeof(VertexBlock *));
+  if (S->blocks == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  return S;
+}
+
+static void dumpVersion(GraphVersion *S) {
+  dumpGraph(S->graph);
+  free(S->blocks);
+  free(S);
+}
+
+/**
+ * @brief Builds a versioned graph whose first version (epoch 1) holds the
+ * edges of `G`.
+ *
+ * Only the weights of `G` are kept; colors and capacities are dropped.
+ *
+ * @param G A formatted graph. It is not modified and may be freed afterwards.
+ * @param nReaders Number of reader slots, i.e. of threads which may hold a
+ * pinned version at the same time.
+ */
+VersionedGraph *createVersionedGraph(Graph *G, u32 nReaders) {
+  assert(G != NULL && isFormatted(G));
+  assert(nReaders > 0);
+
+  bool weighted = G->_g_flag & W_FLAG;
+  GraphVersion *S =
+      createVersion(G->n, G->m, G->_g_flag & (W_FLAG | D_FLAG));
+  S->epoch = 1;
+
+  for (u32 b = 0; b < S->nBlocks; b++) {
+    u32 first = b * VG_BLOCK_SIZE;
+    u32 last = min(first + VG_BLOCK_SIZE, G->n);
+    u32 start = firstNeighbourIndex(G, first);
+    u32 size = 0;
+    for (u32 v = first; v < last; v++)
+      size += degree(v, G);
+
+    VertexBlock *B = createBlock(size, weighted);
+    for (u32 i = 0; i < size; i++) {
+      Edge e = (G->_edges)[start + i];
+      B->targets[i] = e.y;
+      if (weighted)
+        B->weights[i] = *e.w;
+    }
+    for (u32 v = first; v < first + VG_BLOCK_SIZE; v++) {
+      u32 d = v < last ? degree(v, G) : 0;
+      B->offsets[v - first + 1] = B->offsets[v - first] + d;
+    }
+    S->blocks[b] = B;
+  }
+
+  VersionedGraph *V = (VersionedGraph *)calloc(1, sizeof(VersionedGraph));
+  if (V == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  V->current = S;
+  V->globalEpoch = 1;
+  V->nReaders = nReaders;
+  V->readerEpochs = (u64 *)calloc(nReaders, sizeof(u64));
+  V->draftOwned = (bool *)calloc(max(S->nBlocks, 1), sizeof(bool));
+  if (V->readerEpochs == NULL || V->draftOwned == NULL) {
+    printf("Error: calloc failed\n");
+    exit(1);
+  }
+  pthread_mutex_init(&V->writeLock, NULL);
+  return V;
+}
+
+/**
+ * @brief Frees a versioned graph, including every version and block not yet
+ * reclaimed.
+ *
+ * @pre No reader holds a pinned version and no writer is active.
+ */
+void dumpVersionedGraph(VersionedGraph *V) {
+  if (V == NULL)
+    return;
+  GraphVersion *S = V->current;
+  if (V->draft != NULL) {
+    for (u32 b = 0; b < V->draft->nBlocks; b++) {
+      if (V->draftOwned[b])
+        dumpBlock(V->draft->blocks[b]);
+    }
+    dumpVersion(V->draft);
+  }
+  for (u32 b = 0; b < S->nBlocks; b++) {
+    dumpBlock(S->blocks[b]);
+  }
+  dumpVersion(S);
+  for (u32 i = 0; i < V->nRetired; i++) {
+    // Blocks replaced by an unpublished draft still belong to `current`.
+    if (V->retired[i].epoch > V->globalEpoch)
+      continue;
+    if (V->retired[i].isVersion)
+      dumpVersion((GraphVersion *)V->retired[i].ptr);
+    else
+      dumpBlock((VertexBlock *)V->retired[i].ptr);
+  }
+  free(V->retired);
+  free(V->readerEpochs);
+  free(V->draftOwned);
+  pthread_mutex_destroy(&V->writeLock);
+  free(V);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Readers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/**
+ * @brief Pins the current version of `V` for reader slot `reader`.
+ *
+ * The returned version is immutable and stays valid until
+ * `unpinVersion(V, reader)` is called, regardless of how many versions the
+ * writer publishes in the meantime. Each slot may pin one version at a time.
+ */
+GraphVersion *pinVersion(VersionedGraph *V, u32 reader) {
+  assert(reader < V->nReaders);
+  assert(ATOMIC_LOAD(&V->readerEpochs[reader]) == 0);
+
+  // Announce an epoch and make sure it was still current after the
+  // announcement was visible, so that the writer cannot have missed it.
+  u64 epoch;
+  do {
+    epoch = ATOMIC_LOAD(&V->globalEpoch);
+    ATOMIC_STORE(&V->readerEpochs[reader], epoch);
+  } while (epoch != ATOMIC_LOAD(&V->globalEpoch));
+
+  // The writer publishes `current` before bumping `globalEpoch`, so this
+  // version is at least as new as the announced epoch.
+  return ATOMIC_LOAD(&V->current);
+}
+
+/**
+ * @brief Releases the version pinned by reader slot `reader`.
+ */
+void unpinVersion(VersionedGraph *V, u32 reader) {
+  assert(reader < V->nReaders);
+  ATOMIC_STORE(&V->readerEpochs[reader], 0);
+}
+
+/**
+ * @brief Return the degree (out-degree for digraphs) of `v` in version `S`.
+ */
+u32 versionDegree(u32 v, GraphVersion *S) {
+  assert(v < S->n);
+  VertexBlock *B = S->blocks[v / VG_BLOCK_SIZE];
+  u32 i = v % VG_BLOCK_SIZE;
+  return B->offsets[i + 1] - B->offsets[i];
+}
+
+/**
+ * @brief Return the `j`th neighbour of `v` in version `S`. Neighbours are
+ * ordered increasingly.
+ */
+u32 versionNeighbour(u32 j, u32 v, GraphVersion *S) {
+  assert(j < versionDegree(v, S));
+  VertexBlock *B = S->blocks[v / VG_BLOCK_SIZE];
+  return B->targets[B->offsets[v % VG_BLOCK_SIZE] + j];
+}
+
+/**
+ * @brief Return the weight of the edge to the `j`th neighbour of `v` in
+ * version `S`.
+ */
+u32 versionNeighbourWeight(u32 j, u32 v, GraphVersion *S) {
+  assert(S->flag & W_FLAG);
+  assert(j < versionDegree(v, S));
+  VertexBlock *B = S->blocks[v / VG_BLOCK_SIZE];
+  return B->weights[B->offsets[v % VG_BLOCK_SIZE] + j];
+}
+
+bool versionIsNeighbour(u32 x, u32 y, GraphVersion *S) {
+  for (u32 j = 0; j < versionDegree(x, S); j++) {
+    if (versionNeighbour(j, x, S) == y)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Materialises version `S` as an ordinary Graph, so that any algorithm
+ * of the library (dijkstra, BFS, coloring...) can run on a consistent
+ * snapshot. Takes O(n + m) time; no sorting is required since blocks are
+ * kept ordered. Each weight of a Graph is allocated on its own, so on
+ * weighted graphs a copy costs several BFS traversals (see bench_bfs);
+ * readers which only read the graph should share versionGraph instead.
+ *
+ * @return A private copy, to be freed with dumpGraph.
+ */
+Graph *versionToGraph(GraphVersion *S) {
+  Graph *G = initGraph(S->n, S->m, S->flag);
+  bool isDirected = S->flag & D_FLAG;
+  bool weighted = S->flag & W_FLAG;
+
+  u32 index = 0;
+  for (u32 v = 0; v < S->n; v++) {
+    u32 d = versionDegree(v, S);
+    (G->_firstneighbour)[v] = index;
+    for (u32 j = 0; j < d; j++) {
+      Edge *e = &(G->_edges)[index++];
+      e->x = v;
+      e->y = versionNeighbour(j, v, S);
+      if (weighted) {
+        e->w = (u32 *)malloc(sizeof(u32));
+        *e->w = versionNeighbourWeight(j, v, S);
+      }
+      if (isDirected)
+        (G->_indegrees)[e->y]++;
+    }
+    if (isDirected)
+      (G->_outdegrees)[v] = d;
+    else
+      (G->_degrees)[v] = d;
+    G->Δ = max(G->Δ, d);
+  }
+  assert(index == G->_edgeArraySize);
+  G->_formatted = true;
+  return G;
+}
+
+/**
+ * @brief Returns version `S` materialised as an ordinary Graph, shared by
+ * every reader of `S`: it is built by the first call and then reused, so
+ * the O(n + m) copy is paid once per published version rather than once per
+ * query.
+ *
+ * The Graph belongs to `S` and is freed with it. It may only be used while
+ * `S` is pinned and must not be modified; algorithms which write to the
+ * graph (colorings, flows) need a private copy from versionToGraph.
+ */
+Graph *versionGraph(GraphVersion *S) {
+  Graph *G = ATOMIC_LOAD(&S->graph);
+  if (G != NULL)
+    return G;
+  // Readers racing on a new version each build a copy; the first one
+  // published is kept.
+  Graph *built = versionToGraph(S);
+  if (ATOMIC_CAS(&S->graph, &G, built))
+    return built;
+  dumpGraph(built);
+  return G;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Writer ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+static void retire(VersionedGraph *V, void *ptr, bool isVersion, u64 epoch) {
+  if (V->nRetired == V->retiredCapacity) {
+    V->retiredCapacity = max(2 * V->retiredCapacity, 16);
+    V->retired = (RetiredObject *)realloc(
+        V->retired, V->retiredCapacity * sizeof(RetiredObject));
+    if (V->retired == NULL) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  V->retired[V->nRetired++] = (RetiredObject){ptr, isVersion, epoch};
+}
+
+/**
+ * @brief Helper function. Frees every retired object which no pinned reader
+ * can still reach.
+ */
+static void reclaim(VersionedGraph *V) {
+  u64 safe = ATOMIC_LOAD(&V->globalEpoch);
+  for (u32 r = 0; r < V->nReaders; r++) {
+    u64 pinned = ATOMIC_LOAD(&V->readerEpochs[r]);
+    if (pinned != 0 && pinned < safe)
+      safe = pinned;
+  }
+
+  u32 kept = 0;
+  for (u32 i = 0; i < V->nRetired; i++) {
+    RetiredObject o = V->retired[i];
+    if (o.epoch > safe) {
+      V->retired[kept++] = o;
+      continue;
+    }
+    if (o.isVersion)
+      dumpVersion((GraphVersion *)o.ptr);
+    else
+      dumpBlock((VertexBlock *)o.ptr);
+  }
+  V->nRetired = kept;
+}
+
+/**
+ * @brief Helper function. Returns the draft's copy of the block holding
+ * vertex `v`, copying it (and the version) on first write.
+ */
+static VertexBlock *writableBlock(VersionedGraph *V, u32 v) {
+  GraphVersion *S = V->current;
+  if (V->draft == NULL) {
+    V->draft = createVersion(S->n, S->m, S->flag);
+    V->draft->epoch = S->epoch + 1;
+    memcpy(V->draft->blocks, S->blocks, S->nBlocks * sizeof(VertexBlock *));
+    memset(V->draftOwned, 0, S->nBlocks * sizeof(bool));
+  }
+  u32 b = v / VG_BLOCK_SIZE;
+  if (!V->draftOwned[b]) {
+    VertexBlock *old = V->draft->blocks[b];
+    V->draft->blocks[b] = copyBlock(old);
+    V->draftOwned[b] = true;
+    retire(V, old, false, V->draft->epoch);
+  }
+  return V->draft->blocks[b];
+}
+
+static void insertAdjacency(VersionedGraph *V, u32 x, u32 y, u32 *w) {
+  VertexBlock *B = writableBlock(V, x);
+  u32 i = x % VG_BLOCK_SIZE;
+  u32 size = B->offsets[VG_BLOCK_SIZE];
+
+  u32 pos = B->offsets[i];
+  while (pos < B->offsets[i + 1] && B->targets[pos] < y)
+    pos++;
+  assert(pos == B->offsets[i + 1] || B->targets[pos] != y);
+
+  if (size == B->capacity) {
+    B->capacity = max(2 * B->capacity, 4);
+    B->targets = (u32 *)realloc(B->targets, B->capacity * sizeof(u32));
+    if (B->weights != NULL)
+      B->weights = (u32 *)realloc(B->weights, B->capacity * sizeof(u32));
+    if (B->targets == NULL || (w != NULL && B->weights == NULL)) {
+      printf("Error: realloc failed\n");
+      exit(1);
+    }
+  }
+  memmove(&B->targets[pos + 1], &B->targets[pos], (size - pos) * sizeof(u32));
+  B->targets[pos] = y;
+  if (B->weights != NULL) {
+    memmove(&B->weights[pos + 1], &B->weights[pos],
+            (size - pos) * sizeof(u32));
+    B->weights[pos] = *w;
+  }
+  for (u32 k = i + 1; k <= VG_BLOCK_SIZE; k++)
+    B->offsets[k]++;
+}
+
+static void removeAdjacency(VersionedGraph *V, u32 x, u32 y) {
+  VertexBlock *B = writableBlock(V, x);
+  u32 i = x % VG_BLOCK_SIZE;
+  u32 size = B->offsets[VG_BLOCK_SIZE];
+
+  u32 pos = B->offsets[i];
+  while (pos < B->offsets[i + 1] && B->targets[pos] != y)
+    pos++;
+  assert(pos < B->offsets[i + 1]);
+
+  memmove(&B->targets[pos], &B->targets[pos + 1],
+          (size - pos - 1) * sizeof(u32));
+  if (B->weights != NULL)
+    memmove(&B->weights[pos], &B->weights[pos + 1],
+            (size - pos - 1) * sizeof(u32));
+  for (u32 k = i + 1; k <= VG_BLOCK_SIZE; k++)
+    B->offsets[k]--;
+}
+
+/**
+ * @brief Adds the edge {x, y} (or (x, y) for digraphs) to the draft version.
+ *
+ * The change becomes visible to readers on the next `publishVersion(V)`.
+ * Only the blocks holding `x` and `y` are copied.
+ *
+ * @param w Pointer to the weight of the edge; must be NULL iff the graph is
+ * not weighted.
+ */
+void versionedAddEdge(VersionedGraph *V, u32 x, u32 y, u32 *w) {
+  assert(x != y && x < V->current->n && y < V->current->n);
+  assert((w != NULL) == ((V->current->flag & W_FLAG) != 0));
+  pthread_mutex_lock(&V->writeLock);
+  insertAdjacency(V, x, y, w);
+  if (!(V->current->flag & D_FLAG))
+    insertAdjacency(V, y, x, w);
+  V->draft->m++;
+  pthread_mutex_unlock(&V->writeLock);
+}
+
+/**
+ * @brief Removes the edge {x, y} (or (x, y) for digraphs) from the draft
+ * version. The edge must exist.
+ */
+void versionedRemoveEdge(VersionedGraph *V, u32 x, u32 y) {
+  assert(x < V->current->n && y < V->current->n);
+  pthread_mutex_lock(&V->writeLock);
+  removeAdjacency(V, x, y);
+  if (!(V->current->flag & D_FLAG))
+    removeAdjacency(V, y, x);
+  V->draft->m--;
+  pthread_mutex_unlock(&V->writeLock);
+}
+
+/**
+ * @brief Atomically publishes the draft version, making every change since
+ * the previous publication visible to readers which pin afterwards.
+ *
+ * Readers already holding a version keep seeing it unchanged. Blocks which
+ * are no longer reachable from any pinned version are freed.
+ *
+ * @return The epoch of the current version after publication.
+ */
+u64 publishVersion(VersionedGraph *V) {
+  pthread_mutex_lock(&V->writeLock);
+  GraphVersion *old = V->current;
+  if (V->draft != NULL) {
+    GraphVersion *S = V->draft;
+    V->draft = NULL;
+    // Order matters: readers rely on `current` being at least as new as
+    // `globalEpoch`.
+    ATOMIC_STORE(&V->current, S);
+    ATOMIC_STORE(&V->globalEpoch, S->epoch);
+    retire(V, old, true, S->epoch);
+  }
+  reclaim(V);
+  u64 epoch = V->current->epoch;
+  pthread_mutex_unlock(&V->writeLock);
+  return epoch;
+}
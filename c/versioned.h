@@ -0,0 +1,99 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file versioned.h
+ * @brief Multi-version (copy-on-write) graphs. Readers pin an immutable
+ * version of the graph while a single writer keeps applying updates and
+ * publishing new versions.
+ */
+
+#ifndef VERSIONED_H
+#define VERSIONED_H
+
+#include "graphStruct.h"
+#include <pthread.h>
+
+// Number of consecutive vertices whose adjacency is stored in one block.
+// A write copies only the blocks of the vertices it touches.
+#define VG_BLOCK_SIZE 64
+
+typedef struct {
+  u32 offsets[VG_BLOCK_SIZE + 1]; // adjacency of vertex first + i is
+                                  // targets[offsets[i] .. offsets[i + 1])
+  u32 *targets;
+  u32 *weights; // NULL if the graph is not weighted
+  u32 capacity; // allocated length of targets and weights
+} VertexBlock;
+
+typedef struct {
+  u64 epoch;
+  u32 n;
+  u32 m;
+  u32 nBlocks;
+  g_flag flag;
+  VertexBlock **blocks;
+  Graph *graph; // materialised by versionGraph, or NULL; accessed atomically
+} GraphVersion;
+
+typedef struct {
+  void *ptr;
+  bool isVersion; // a GraphVersion (blocks not included) or a VertexBlock
+  u64 epoch;      // first epoch from which `ptr` is unreachable
+} RetiredObject;
+
+typedef struct {
+  GraphVersion *current; // last published version, accessed atomically
+  u64 globalEpoch;       // epoch of `current`, accessed atomically
+  u64 *readerEpochs;     // epoch pinned by each reader slot, 0 if none
+  u32 nReaders;
+
+  // Writer state, protected by writeLock.
+  pthread_mutex_t writeLock;
+  GraphVersion *draft;
+  bool *draftOwned; // draftOwned[b] iff block b was copied for the draft
+  RetiredObject *retired;
+  u32 nRetired;
+  u32 retiredCapacity;
+} VersionedGraph;
+
+VersionedGraph *createVersionedGraph(Graph *G, u32 nReaders);
+void dumpVersionedGraph(VersionedGraph *V);
+
+GraphVersion *pinVersion(VersionedGraph *V, u32 reader);
+void unpinVersion(VersionedGraph *V, u32 reader);
+
+u32 versionDegree(u32 v, GraphVersion *S);
+u32 versionNeighbour(u32 j, u32 v, GraphVersion *S);
+u32 versionNeighbourWeight(u32 j, u32 v, GraphVersion *S);
+bool versionIsNeighbour(u32 x, u32 y, GraphVersion *S);
+Graph *versionToGraph(GraphVersion *S);
+Graph *versionGraph(GraphVersion *S);
+
+void versionedAddEdge(VersionedGraph *V, u32 x, u32 y, u32 *w);
+void versionedRemoveEdge(VersionedGraph *V, u32 x, u32 y);
+u64 publishVersion(VersionedGraph *V);
+
+#endif
@@ -0,0 +1,101 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file workspace.c
+ * @brief Reusable scratch space for graph searches.
+ */
+
+#include "workspace.h"
+#include "utils.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Allocates a workspace for searches on graphs of at most n
+ * vertices. Allocate one per thread and reuse it across queries.
+ */
+SearchWorkspace *createSearchWorkspace(u32 n) {
+  SearchWorkspace *W = (SearchWorkspace *)malloc(sizeof(SearchWorkspace));
+  if (W == NULL) {
+    printf("Error: malloc failed\n");
+    exit(1);
+  }
+  W->n = n;
+  W->epoch = 1;
+  W->stamp = genArray(n);
+  W->distances = genArray(n);
+  W->parents = genArray(n);
+  W->parentEdges = genArray(n);
+  W->frontier = genArray(n);
+  W->heap = createIndexedHeap(n);
+  return W;
+}
+
+/**
+ * @brief Starts a new search: no vertex is reached afterwards. Costs O(1),
+ * except once every 2^32 - 1 searches, when the stamps are cleared.
+ */
+void resetWorkspace(SearchWorkspace *W) {
+  assert(W != NULL);
+  W->epoch++;
+  if (W->epoch == 0) {
+    memset(W->stamp, 0, W->n * sizeof(u32));
+    W->epoch = 1;
+  }
+  // A search stopped early may leave nodes in the heap.
+  clearIndexedHeap(W->heap);
+}
+
+/**
+ * @brief Whether the last search reached `v`.
+ */
+bool workspaceReached(SearchWorkspace *W, u32 v) {
+  assert(v < W->n);
+  return W->stamp[v] == W->epoch;
+}
+
+/**
+ * @brief The distance to `v` found by the last search, or INT_MAX if it was
+ * not reached.
+ */
+u32 workspaceDistance(SearchWorkspace *W, u32 v) {
+  return workspaceReached(W, v) ? W->distances[v] : INT_MAX;
+}
+
+void dumpSearchWorkspace(SearchWorkspace *W) {
+  if (W == NULL)
+    return;
+  free(W->stamp);
+  free(W->distances);
+  free(W->parents);
+  free(W->parentEdges);
+  free(W->frontier);
+  dumpIndexedHeap(W->heap);
+  free(W);
+}
@@ -0,0 +1,62 @@
+/** MIT License
+ *
+ * Copyright (c) 2024 Santiago López Pereyra
+ *
+ * santiagolopezpereyra@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * The software is provided "as is", without warranty of any kind, express or
+ * implied, including but not limited to the warranties of merchantability,
+ * fitness for a particular purpose, and noninfringement. In no event shall the
+ * authors or copyright holders be liable for any claim, damages, or other
+ * liability, whether in an action of contract, tort, or otherwise, arising from,
+ * out of or in connection with the software or the use or other dealings in the
+ * software.
+ */
+
+/**
+ * @file workspace.h
+ * @brief Reusable scratch space for graph searches, so that many small
+ * queries on a large graph do not each allocate and clear O(n) memory.
+ */
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "graphStruct.h"
+#include "heap.h"
+
+// Parent of the root of a search, and of the vertices it does not reach,
+// in the parent arrays filled by searches.
+#define NO_PARENT 0xFFFFFFFF
+
+// Vertex v has been reached by the current search iff stamp[v] == epoch;
+// only then are distances[v], parents[v] and parentEdges[v] meaningful.
+// Starting a search bumps the epoch, which forgets the previous one in O(1).
+typedef struct {
+  u32 n;
+  u32 epoch;
+  u32 *stamp;
+  u32 *distances;
+  u32 *parents;     // the root is its own parent
+  u32 *parentEdges; // index in G->_edges of the edge parents[v] -> v
+  u32 *frontier; // room for every vertex once: a BFS queue or a stack
+  IndexedHeap *heap;
+} SearchWorkspace;
+
+SearchWorkspace *createSearchWorkspace(u32 n);
+void resetWorkspace(SearchWorkspace *W);
+bool workspaceReached(SearchWorkspace *W, u32 v);
+u32 workspaceDistance(SearchWorkspace *W, u32 v);
+void dumpSearchWorkspace(SearchWorkspace *W);
+
+#endif